@@ -2,11 +2,36 @@
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
-#include "RawNamespace\vector\trivial_check.hpp"
-#include "RawNamespace\RawBase.hpp"
+#include <atomic>
+#include "RawNamespace/vector/trivial_check.hpp"
+#include "RawNamespace/RawBase.hpp"
+#include "RawNamespace/vector/vector_stats.hpp"
 
 
 namespace raw {
+	/*********************************************************************
+	 * GROWTH HOOK: `growth_hook`
+	 *
+	 * Optional observer of buffer reallocations made while a vector grows
+	 * (tracing, statistics). Called with `begin == true` right before the
+	 * reallocation and with `begin == false` right after it, and only when
+	 * the capacity changes: storage reused in place is not growth.
+	 * Unset by default, then a reallocation only pays for the null check.
+	 *********************************************************************/
+	using growth_hook_t = void (*)(bool begin, size_t old_capacity, size_t new_capacity, size_t element_size);
+	inline std::atomic<growth_hook_t> growth_hook{ nullptr };
+
+	inline growth_hook_t begin_growth(size_t old_capacity, size_t new_capacity, size_t element_size) {
+		if (old_capacity == new_capacity) return nullptr;
+		growth_hook_t hook = growth_hook.load(std::memory_order_relaxed);
+		if (hook) hook(true, old_capacity, new_capacity, element_size);
+		return hook;
+	}
+
+	inline void end_growth(growth_hook_t hook, size_t old_capacity, size_t new_capacity, size_t element_size) {
+		if (hook) hook(false, old_capacity, new_capacity, element_size);
+	}
+
 	template<typename T>
 	class vector_base {
 	private:
@@ -14,18 +39,48 @@ namespace raw {
 		T* data = nullptr;
 		size_t size = 0;
 		size_t capacity = 0;
+#if RAW_VECTOR_STATS_ENABLED
+		vector_stats_tracker stats{ &size, &capacity, sizeof(T) };
+#endif
 
 		virtual T* normalize_capacity() = 0;
 
+		/// Statistics bookkeeping, see `vector_stats_tracker`; empty when statistics are compiled out.
+		void note_stats() {
+#if RAW_VECTOR_STATS_ENABLED
+			stats.note();
+#endif
+		}
+		/// `note_stats()` for a vector just built from `other`; also takes over its label.
+		void note_copy(const vector_base& other) {
+#if RAW_VECTOR_STATS_ENABLED
+			stats.set_label(other.stats.get_label());
+			stats.note();
+#else
+			(void)other;
+#endif
+		}
+		void note_growth(bool moved, size_t copied_elements) {
+#if RAW_VECTOR_STATS_ENABLED
+			stats.note_growth(moved, copied_elements);
+#else
+			(void)moved; (void)copied_elements;
+#endif
+		}
+
 		friend class vector_triv<T>;
 		friend class vector_non_triv<T>;
 	public:
 
-		vector_base() : data(nullptr), size(0), capacity(1) {}
+		vector_base() : data(nullptr), size(0), capacity(1) { note_stats(); }
 		virtual ~vector_base() {
+#ifdef RAW_VECTOR_VERBOSE
 			std::cout << "Freeing memory at address: " << static_cast<void*>(data) << " | ";
+#endif
 			if (data) { free(data); }
+#ifdef RAW_VECTOR_VERBOSE
 			std::cout << "vector_base Object Destroyed with size: " << size << " and with capacity: " << capacity << std::endl;
+#endif
 		}
 
 		virtual void push_back(const T& elem) = 0;
@@ -40,6 +95,27 @@ namespace raw {
 		size_t get_capacity() const { return capacity; }
 		bool is_trivial() const { return is_trivial_v; }
 
+		/// Reallocations, bytes copied, peaks and slack of this vector; only size and capacity when statistics are compiled out.
+		vector_stats get_stats() const {
+#if RAW_VECTOR_STATS_ENABLED
+			return stats.get();
+#else
+			vector_stats result;
+			result.element_size = sizeof(T);
+			result.size = result.peak_size = size;
+			result.capacity = result.peak_capacity = capacity;
+			return result;
+#endif
+		}
+		/// Names this vector in `write_vector_report()`; `label` must outlive it (a string literal).
+		void set_stats_label(const char* label) {
+#if RAW_VECTOR_STATS_ENABLED
+			stats.set_label(label);
+#else
+			(void)label;
+#endif
+		}
+
 		virtual void resize(size_t new_size) = 0;
 		virtual void reserve(size_t reserve_size) = 0;
 		virtual void clear() = 0;
@@ -4,7 +4,7 @@
 #include <cstdlib>
 #include <algorithm>
 #include <memory>
-#include "RawNamespace\vector\RawVector.hpp"
+#include "RawNamespace/vector/RawVector.hpp"
 
 
 namespace raw {
@@ -24,7 +24,9 @@ namespace raw {
 		 *************************************************************************************/
 
 		T* normalize_capacity() {
+			size_t old_capacity = capacity;
 			while (size >= capacity) capacity *= 2;
+			growth_hook_t hook = begin_growth(old_capacity, capacity, sizeof(T));
 
 			void* raw = malloc(sizeof(T) * capacity);
 			if (!raw) throw std::bad_alloc();
@@ -38,6 +40,8 @@ namespace raw {
 			T* old_data = data;
 			data = new_data;
 			free(old_data);
+			end_growth(hook, old_capacity, capacity, sizeof(T));
+			this->note_growth(true, size);
 
 			return new_data;
 		}
@@ -56,7 +60,9 @@ namespace raw {
 		T* normalize_capacity(size_t size_) {
 			if (std::numeric_limits<size_t>::max() / 2 < size_) throw std::bad_alloc();
 			if (capacity == 0) capacity = 1;
+			size_t old_capacity = capacity;
 			while (size_ >= capacity) capacity *= 2;
+			growth_hook_t hook = begin_growth(old_capacity, capacity, sizeof(T));
 
 			void* raw = malloc(sizeof(T) * capacity);
 			if (!raw) throw std::bad_alloc();
@@ -70,6 +76,8 @@ namespace raw {
 			T* old_data = data;
 			data = new_data;
 			free(old_data);
+			end_growth(hook, old_capacity, capacity, sizeof(T));
+			this->note_growth(true, size);
 
 			return new_data;
 		}
@@ -134,6 +142,7 @@ namespace raw {
 			capacity = 1;
 			try {
 				data = reserve_space();
+				this->note_stats();
 			}
 			catch (const std::bad_alloc& e) {
 				if (data) {
@@ -162,6 +171,7 @@ namespace raw {
 				data = (T*)malloc(sizeof(T) * capacity);
 				for (size_t i = 0; i < size; ++i)
 					new (data + i) T(other.data[i]);
+				this->note_copy(other);
 			}
 			catch (const std::bad_alloc& e) {
 				if (data) {
@@ -194,6 +204,8 @@ namespace raw {
 			other.capacity = 0;
 			free(other.data);
 			other.data = nullptr;
+			this->note_copy(other);
+			other.note_stats();
 		}
 
 		/*************************************************************************************
@@ -208,6 +220,7 @@ namespace raw {
 		vector_non_triv& operator=(const vector_non_triv& other) {
 			if (data == other.data)
 				return *this;
+			this->note_stats();
 			size_t free_cap = size;
 			size = other.size;
 			capacity = other.capacity;
@@ -219,6 +232,7 @@ namespace raw {
 				for (size_t i = 0; i < other.size; ++i) {
 					new (data + i) T(other.data[i]);
 				}
+				this->note_stats();
 			}
 
 			catch (const std::bad_alloc& e) {
@@ -244,6 +258,7 @@ namespace raw {
 		vector_non_triv& operator=(vector_non_triv&& other) noexcept {
 			if (data == other.data)
 				return *this;
+			this->note_stats();
 			size_t free_cap = size;
 			size = other.size;
 			capacity = other.capacity;
@@ -260,6 +275,8 @@ namespace raw {
 			other.size = 0;
 			other.capacity = 0;
 			other.data = nullptr;
+			this->note_stats();
+			other.note_stats();
 			return *this;
 		}
 
@@ -327,11 +344,13 @@ namespace raw {
 
 		void resize(size_t new_size) override {
 			if (new_size < size) {
+				this->note_stats();
 				for (size_t i = new_size; i < size; ++i)
 					data[i].~T();
 				size = new_size;
 			}
 			else {
+				size_t old_capacity = capacity;
 				while (new_size >= capacity) capacity *= 2;
 
 				T* new_data = (T*)malloc(sizeof(T) * capacity);
@@ -345,8 +364,10 @@ namespace raw {
 				for(size_t i = size; i < new_size; ++i)
 					new (new_data + i) T();
 				free(data);
+				size_t moved = size;
 				size = new_size;
 				data = new_data;
+				if (capacity != old_capacity) this->note_growth(true, moved);
 			}
 		}
 
@@ -379,12 +400,14 @@ namespace raw {
 		 *********************************************************************/
 
 		void clear() override {
+			this->note_stats();
 			for (size_t i = 0; i < size; ++i)
 				data[i].~T();
 			free(data);
 			size = 0;
 			capacity = 1;
 			data = (T*)malloc(sizeof(T));
+			this->note_stats();
 		}
 
 		/**************************************************************************************
@@ -413,6 +436,7 @@ namespace raw {
 			free(data);
 			data = new_data;
 			capacity = size;
+			this->note_stats();
 		}
 
 		/*********************************************************************
@@ -427,6 +451,7 @@ namespace raw {
 		void pop_back() override {
 			if (size == 0)
 				throw std::out_of_range("Index out of range");
+			this->note_stats();
 			--size;
 			data[size].~T();
 		}
@@ -539,6 +564,7 @@ namespace raw {
 			for (size_t i = index; i < size - 1; ++i) {
 				data[i] = std::move(data[i + 1]);
 			}
+			this->note_stats();
 			--size;
 			data[size].~T();
 		}
@@ -553,6 +579,7 @@ namespace raw {
 			for (size_t i = erase_index; i < size - 1; ++i) {
 				data[i] = std::move(data[i + 1]);
 			}
+			this->note_stats();
 			--size;
 			data[size].~T();
 			return pos;
@@ -566,9 +593,13 @@ namespace raw {
 		 *************************************************************/
 
 		void swap(vector_base<T>& other) noexcept {
+			this->note_stats();
+			other.note_stats();
 			std::swap(size, other.size);
 			std::swap(capacity, other.capacity);
 			std::swap(data, other.data);
+			this->note_stats();
+			other.note_stats();
 		};
 
 		/// CHECKS IF OBJECT IS EMPTY, IF SIZE VARIABLE ISN'T HANDELED GOOD ENOUGH, CAN CAUSE CRUSH
@@ -577,12 +608,17 @@ namespace raw {
 		/*********************************************************************
 		 * DESTRUCTOR: `~vector_non_triv()`
 		 *
-		 * Destroys all constructed elements and prints a message.
+		 * Destroys all constructed elements and, with RAW_VECTOR_VERBOSE, prints a message.
 		 * Frees allocated memory.
 		 *
 		 * Throws: exceptions from T's destructor.
 		 *********************************************************************/
 
-		~vector_non_triv() override { for (size_t i = 0; i < size; ++i) data[i].~T(); std::cout << "Destryed objects in vector_non_triv, next comes memory freeing" << std::endl; }
+		~vector_non_triv() override {
+			for (size_t i = 0; i < size; ++i) data[i].~T();
+#ifdef RAW_VECTOR_VERBOSE
+			std::cout << "Destryed objects in vector_non_triv, next comes memory freeing" << std::endl;
+#endif
+		}
 	};
 }
\ No newline at end of file
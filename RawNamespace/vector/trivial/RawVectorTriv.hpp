@@ -4,7 +4,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
-#include "RawNamespace\vector\RawVector.hpp"
+#include "RawNamespace/vector/RawVector.hpp"
 
 namespace raw {
 	template<typename T>
@@ -25,16 +25,26 @@ namespace raw {
 		  * PRIVATE FUNCTION: `normalize_capacity()`
 		  *
 		  * Reallocates `data` with doubled `capacity` if needed (when `size` >= `capacity`).
-		  * Copies existing data to new memory.
+		  * Copies existing data to new memory. When `size` already fits, nothing is
+		  * reallocated or counted as growth.
 		  * Returns pointer to the new `data`.
 		  *
 		  * Throws: std::bad_alloc on allocation failure.
 		  *************************************************************************************************/
 		T* normalize_capacity() override {
+			size_t old_capacity = capacity;
 			while (size >= capacity) capacity *= 2;
+			if (capacity == old_capacity && data) {
+				this->note_stats();
+				return data;
+			}
+			growth_hook_t hook = begin_growth(old_capacity, capacity, sizeof(T));
 			T* new_data = (T*)realloc(data, sizeof(T) * capacity);
+			end_growth(hook, old_capacity, capacity, sizeof(T));
 			if (new_data) {
+				bool moved = data && new_data != data;
 				data = new_data;
+				this->note_growth(moved, old_capacity);
 				return data;
 			}
 			throw std::bad_alloc();
@@ -100,6 +110,7 @@ namespace raw {
 				std::memcpy(newData, other.data, size * sizeof(T));
 				free(data);
 				data = newData;
+				this->note_copy(other);
 			}
 			catch (std::bad_alloc& e) {
 				std::cerr << e.what() << std::endl;
@@ -122,6 +133,8 @@ namespace raw {
 			other.data = nullptr;
 			other.size = 0;
 			other.capacity = 0;
+			this->note_copy(other);
+			other.note_stats();
 		}
 
 		/*************************************************************************************
@@ -143,10 +156,12 @@ namespace raw {
 					throw std::bad_alloc();
 				}
 				std::memcpy(newData, other.data, other.size * sizeof(T));
+				this->note_stats();
 				free(data);
 				data = newData;
 				size = other.size;
 				capacity = other.capacity;
+				this->note_stats();
 			}
 			catch (std::bad_alloc& e) {
 				std::cerr << e.what() << std::endl;
@@ -165,6 +180,7 @@ namespace raw {
 
 		vector_triv& operator=(vector_triv&& other) noexcept {
 			if (this != &other) {
+				this->note_stats();
 				free(data);
 				data = other.data;
 				size = other.size;
@@ -172,6 +188,8 @@ namespace raw {
 				other.data = nullptr;
 				other.size = 0;
 				other.capacity = 0;
+				this->note_stats();
+				other.note_stats();
 			}
 			return *this;
 		}
@@ -192,13 +210,17 @@ namespace raw {
 			try {
 				if (capacity <= size) {
 					capacity *= 2;
+					growth_hook_t hook = begin_growth(capacity / 2, capacity, sizeof(T));
 					auto newdata = (T*)std::realloc(data, capacity * sizeof(T));
+					end_growth(hook, capacity / 2, capacity, sizeof(T));
 					if (!newdata) {
 						std::cerr << "Couldn't reserve that much space ERR" << std::endl;
 						free(data);
 						throw std::bad_alloc();
 					}
+					bool moved = newdata != data;
 					data = newdata;
+					this->note_growth(moved, capacity / 2);
 				}
 				if (data)
 					data[size] = elem;
@@ -285,13 +307,17 @@ namespace raw {
 
 		void resize(size_t new_size) override {
 			if (new_size <= size) {
+				this->note_stats();
 				size = new_size;
 				return;
 			}
 			size_t old_size = size;
 			size = new_size;
-			normalize_capacity();
-			if (old_size < size) { memset(data + old_size, 0, (size - old_size) * sizeof(T)); }
+			// raw::vector keeps capacity above size, like push_back(); a size that fits reallocates nothing
+			if (size >= capacity) normalize_capacity();
+			else this->note_stats();
+			// through void*: a T with default member initializers is still zeroed as raw bytes, like realloc() moves it
+			if (old_size < size) { memset(static_cast<void*>(data + old_size), 0, (size - old_size) * sizeof(T)); }
 
 		}
 
@@ -309,13 +335,18 @@ namespace raw {
 				return;
 			}
 			try {
+				growth_hook_t hook = begin_growth(capacity, reserve_size, sizeof(T));
 				auto temp = (T*)realloc(data, reserve_size * sizeof(T));
+				end_growth(hook, capacity, reserve_size, sizeof(T));
 				if (!temp) {
 					std::cerr << "Couldn't reserve that much space ERR" << std::endl;
 					throw std::bad_alloc();
 				}
+				bool moved = data && temp != data;
+				size_t old_capacity = capacity;
 				data = temp;
 				capacity = reserve_size;
+				this->note_growth(moved, old_capacity);
 			}
 			catch (std::bad_alloc& err) {
 				std::cerr << err.what() << std::endl;
@@ -335,6 +366,7 @@ namespace raw {
 		 *********************************************************************/
 
 		void clear() override {
+			this->note_stats();
 			if (data) {
 				free(data);
 				data = nullptr;
@@ -342,6 +374,7 @@ namespace raw {
 			size = 0;
 			capacity = 1;
 			data = (T*)malloc(sizeof(T));
+			this->note_stats();
 		}
 
 		/**************************************************************************************
@@ -364,6 +397,7 @@ namespace raw {
 					}
 					data = shrinked;
 					capacity = size;
+					this->note_stats();
 				}
 				catch (std::bad_alloc& err) {
 					std::cerr << err.what() << std::endl;
@@ -387,7 +421,8 @@ namespace raw {
 			if (size == 0) {
 				throw std::out_of_range("Vector is empty");
 			}
-			if (--size == 0) { free(data); data = (T*)calloc(1, sizeof(T)); capacity = 1; }
+			this->note_stats();
+			if (--size == 0) { free(data); data = (T*)calloc(1, sizeof(T)); capacity = 1; this->note_stats(); }
 		}
 
 		/*************************************************************************************
@@ -470,6 +505,7 @@ namespace raw {
 				throw std::out_of_range("Index out of range");
 			}
 			std::memmove(data + index, data + index + 1, (size - index - 1) * sizeof(T));
+			this->note_stats();
 			--size;
 		}
 
@@ -479,6 +515,7 @@ namespace raw {
 				throw std::out_of_range("Index out of range");
 			}
 			std::memmove(data + erase_index, data + erase_index + 1, (size - erase_index - 1) * sizeof(T));
+			this->note_stats();
 			--size;
 			return Iterator(data + erase_index);
 		}
@@ -491,9 +528,13 @@ namespace raw {
 		 *************************************************************/
 
 		void swap(vector_base<T>& other) noexcept override {
+			this->note_stats();
+			other.note_stats();
 			std::swap(data, other.data);
 			std::swap(size, other.size);
 			std::swap(capacity, other.capacity);
+			this->note_stats();
+			other.note_stats();
 		}
 
 		/*************************************************************************************
@@ -516,12 +557,14 @@ namespace raw {
 		/*********************************************************************
 		 * DESTRUCTOR: `~vector_triv()`
 		 *
-		 * Prints destruction message (for debugging).
+		 * Prints destruction message when RAW_VECTOR_VERBOSE is defined (for debugging).
 		 * Memory freeing handled in base class.
 		 *********************************************************************/
 
 		~vector_triv() override {
+#ifdef RAW_VECTOR_VERBOSE
 			std::cout << "vector_triv Object Destroyed next comes memory freeing" << std::endl;
+#endif
 		}
 	};
 }
\ No newline at end of file
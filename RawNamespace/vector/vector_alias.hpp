@@ -1,9 +1,9 @@
 #pragma once
 #include <type_traits>
-#include "RawNamespace\RawBase.hpp"
-#include "RawNamespace\vector\RawVector.hpp"
-#include "RawNamespace\vector\trivial\RawVectorTriv.hpp"
-#include "RawNamespace\vector\non-trvivial\RawVectorNonTriv.hpp"
+#include "RawNamespace/RawBase.hpp"
+#include "RawNamespace/vector/RawVector.hpp"
+#include "RawNamespace/vector/trivial/RawVectorTriv.hpp"
+#include "RawNamespace/vector/non-trvivial/RawVectorNonTriv.hpp"
 
 namespace raw {
 	/*********************************************************************
@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*********************************************************************
+ * ALLOCATION STATISTICS: `RAW_VECTOR_STATS`
+ *
+ * On in debug builds, off when NDEBUG is defined. `RAW_VECTOR_STATS`
+ * turns them on in any build, `RAW_VECTOR_NO_STATS` turns them off in
+ * any build. When off, no vector carries a tracker, nothing is counted
+ * and the query functions below report zeros.
+ *********************************************************************/
+#if defined(RAW_VECTOR_STATS) || (!defined(NDEBUG) && !defined(RAW_VECTOR_NO_STATS))
+#define RAW_VECTOR_STATS_ENABLED 1
+#else
+#define RAW_VECTOR_STATS_ENABLED 0
+#endif
+
+namespace raw {
+	inline constexpr bool vector_stats_enabled = RAW_VECTOR_STATS_ENABLED;
+
+	/// Allocation history of one vector, from `vector_base::get_stats()`.
+	struct vector_stats {
+		const char* label = "raw::vector";
+		size_t element_size = 0;
+		size_t size = 0;
+		size_t capacity = 0;
+		size_t reallocations = 0;   ///< buffer changes made to grow (doubling, reserve, growing resize)
+		size_t bytes_copied = 0;    ///< moved into the new buffers (realloc copies the whole old block)
+		size_t peak_size = 0;
+		size_t peak_capacity = 0;
+
+		/// Bytes allocated but not holding an element right now.
+		size_t slack_bytes() const { return (capacity > size ? capacity - size : 0) * element_size; }
+	};
+
+	/// Every vector in the process, from `get_vector_totals()`.
+	struct vector_totals {
+		size_t created = 0;
+		size_t live = 0;
+		size_t reallocations = 0;
+		size_t bytes_copied = 0;
+		size_t capacity_bytes = 0;       ///< allocated by the live vectors
+		size_t peak_capacity_bytes = 0;  ///< highest `capacity_bytes` seen so far
+		size_t size_bytes = 0;           ///< holding elements of the live vectors
+		size_t slack_bytes() const { return capacity_bytes > size_bytes ? capacity_bytes - size_bytes : 0; }
+	};
+
+#if RAW_VECTOR_STATS_ENABLED
+	class vector_stats_tracker;
+
+	namespace stats_detail {
+		struct registry {
+			std::mutex lock;
+			std::vector<const vector_stats_tracker*> live;
+			std::atomic<size_t> created{ 0 };
+			std::atomic<size_t> reallocations{ 0 };
+			std::atomic<size_t> bytes_copied{ 0 };
+			std::atomic<size_t> capacity_bytes{ 0 };
+			std::atomic<size_t> peak_capacity_bytes{ 0 };
+		};
+
+		inline registry& instance() {
+			static registry r;
+			return r;
+		}
+	}
+
+	/*********************************************************************
+	 * CLASS: `vector_stats_tracker`
+	 *
+	 * Lives inside every `vector_base` while statistics are on. Watches the
+	 * vector's `size` and `capacity` members, which it is given pointers to,
+	 * and registers itself so `write_vector_report()` can find it.
+	 *
+	 * `note()` must be called before `size` shrinks (that is the only moment
+	 * a peak can be lost) and after `capacity` changes (to keep the global
+	 * byte count exact). The vector's own thread calls it; nothing here is
+	 * synchronized beyond the global counters and the registry.
+	 *********************************************************************/
+	class vector_stats_tracker {
+	private:
+		const size_t* size;
+		const size_t* capacity;
+		size_t element_size;
+		const char* label = "raw::vector";
+		size_t reallocations = 0;
+		size_t bytes_copied = 0;
+		size_t peak_size = 0;
+		size_t peak_capacity = 0;
+		size_t counted_capacity = 0;  ///< the capacity already added to the global byte count
+
+	public:
+		vector_stats_tracker(const size_t* size_, const size_t* capacity_, size_t element_size_)
+			: size(size_), capacity(capacity_), element_size(element_size_) {
+			stats_detail::registry& r = stats_detail::instance();
+			r.created.fetch_add(1, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> guard(r.lock);
+			r.live.push_back(this);
+		}
+		vector_stats_tracker(const vector_stats_tracker&) = delete;
+		vector_stats_tracker& operator=(const vector_stats_tracker&) = delete;
+
+		~vector_stats_tracker() {
+			stats_detail::registry& r = stats_detail::instance();
+			r.capacity_bytes.fetch_sub(counted_capacity * element_size, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> guard(r.lock);
+			auto it = std::find(r.live.begin(), r.live.end(), this);
+			if (it != r.live.end()) { *it = r.live.back(); r.live.pop_back(); }
+		}
+
+		void note() {
+			peak_size = std::max(peak_size, *size);
+			peak_capacity = std::max(peak_capacity, *capacity);
+			if (*capacity == counted_capacity) return;
+			stats_detail::registry& r = stats_detail::instance();
+			size_t total;
+			if (*capacity > counted_capacity)
+				total = r.capacity_bytes.fetch_add((*capacity - counted_capacity) * element_size, std::memory_order_relaxed) + (*capacity - counted_capacity) * element_size;
+			else
+				total = r.capacity_bytes.fetch_sub((counted_capacity - *capacity) * element_size, std::memory_order_relaxed) - (counted_capacity - *capacity) * element_size;
+			counted_capacity = *capacity;
+			size_t peak = r.peak_capacity_bytes.load(std::memory_order_relaxed);
+			while (peak < total && !r.peak_capacity_bytes.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {}
+		}
+
+		/// A new buffer replaced the old one while growing; `moved` is false when realloc extended it in place.
+		void note_growth(bool moved, size_t copied_elements) {
+			++reallocations;
+			stats_detail::registry& r = stats_detail::instance();
+			r.reallocations.fetch_add(1, std::memory_order_relaxed);
+			if (moved) {
+				bytes_copied += copied_elements * element_size;
+				r.bytes_copied.fetch_add(copied_elements * element_size, std::memory_order_relaxed);
+			}
+			note();
+		}
+
+		/// `label_` must outlive the vector (a string literal).
+		void set_label(const char* label_) { label = label_; }
+		const char* get_label() const { return label; }
+
+		vector_stats get() const {
+			return { label, element_size, *size, *capacity, reallocations, bytes_copied,
+				std::max(peak_size, *size), std::max(peak_capacity, *capacity) };
+		}
+	};
+#endif
+
+	/*********************************************************************
+	 * FUNCTION: `get_vector_totals()`
+	 *
+	 * Sums over every vector created so far. The size and slack of live
+	 * vectors are read as they are right now, so call it while no other
+	 * thread is changing a vector (at exit, or between frames).
+	 *********************************************************************/
+	inline vector_totals get_vector_totals() {
+		vector_totals totals;
+#if RAW_VECTOR_STATS_ENABLED
+		stats_detail::registry& r = stats_detail::instance();
+		totals.created = r.created.load(std::memory_order_relaxed);
+		totals.reallocations = r.reallocations.load(std::memory_order_relaxed);
+		totals.bytes_copied = r.bytes_copied.load(std::memory_order_relaxed);
+		totals.peak_capacity_bytes = r.peak_capacity_bytes.load(std::memory_order_relaxed);
+		std::lock_guard<std::mutex> guard(r.lock);
+		totals.live = r.live.size();
+		for (const vector_stats_tracker* tracker : r.live) {
+			vector_stats stats = tracker->get();
+			totals.capacity_bytes += stats.capacity * stats.element_size;
+			totals.size_bytes += stats.size * stats.element_size;
+		}
+		totals.peak_capacity_bytes = std::max(totals.peak_capacity_bytes, totals.capacity_bytes);
+#endif
+		return totals;
+	}
+
+	/*********************************************************************
+	 * FUNCTION: `write_vector_report(std::ostream& out)`
+	 *
+	 * Process-wide report: the totals, then the live vectors grouped by
+	 * label and element size, with the groups wasting the most bytes first.
+	 * Same threading caveat as `get_vector_totals()`.
+	 *********************************************************************/
+	inline void write_vector_report(std::ostream& out) {
+#if RAW_VECTOR_STATS_ENABLED
+		struct group {
+			std::string label;
+			size_t element_size = 0, count = 0, size = 0, capacity = 0, reallocations = 0, bytes_copied = 0, peak_size = 0, peak_capacity = 0;
+			size_t slack_bytes() const { return (capacity - size) * element_size; }
+		};
+		std::map<std::pair<std::string, size_t>, group> groups;
+		{
+			stats_detail::registry& r = stats_detail::instance();
+			std::lock_guard<std::mutex> guard(r.lock);
+			for (const vector_stats_tracker* tracker : r.live) {
+				vector_stats stats = tracker->get();
+				group& g = groups[{ stats.label, stats.element_size }];
+				g.label = stats.label;
+				g.element_size = stats.element_size;
+				++g.count;
+				g.size += stats.size;
+				g.capacity += stats.capacity;
+				g.reallocations += stats.reallocations;
+				g.bytes_copied += stats.bytes_copied;
+				g.peak_size = std::max(g.peak_size, stats.peak_size);
+				g.peak_capacity = std::max(g.peak_capacity, stats.peak_capacity);
+			}
+		}
+		std::vector<group> sorted;
+		for (auto& [key, g] : groups) sorted.push_back(g);
+		std::sort(sorted.begin(), sorted.end(), [](const group& a, const group& b) { return a.slack_bytes() > b.slack_bytes(); });
+
+		vector_totals totals = get_vector_totals();
+		out << "raw::vector: " << totals.created << " created, " << totals.live << " live, "
+			<< totals.reallocations << " reallocations, " << totals.bytes_copied << " bytes copied growing\n"
+			<< "  " << totals.capacity_bytes << " bytes allocated (peak " << totals.peak_capacity_bytes << "), "
+			<< totals.size_bytes << " in use, " << totals.slack_bytes() << " slack\n";
+		if (sorted.empty()) return;
+		out << std::setw(20) << "label" << std::setw(6) << "elem" << std::setw(7) << "count" << std::setw(11) << "size"
+			<< std::setw(11) << "capacity" << std::setw(12) << "slack B" << std::setw(10) << "reallocs"
+			<< std::setw(12) << "copied B" << std::setw(10) << "peak size" << std::setw(10) << "peak cap" << "\n";
+		for (const group& g : sorted)
+			out << std::setw(20) << g.label << std::setw(6) << g.element_size << std::setw(7) << g.count << std::setw(11) << g.size
+				<< std::setw(11) << g.capacity << std::setw(12) << g.slack_bytes() << std::setw(10) << g.reallocations
+				<< std::setw(12) << g.bytes_copied << std::setw(10) << g.peak_size << std::setw(10) << g.peak_capacity << "\n";
+		out.flush();
+#else
+		out << "raw::vector statistics are compiled out (build without NDEBUG or define RAW_VECTOR_STATS)" << std::endl;
+#endif
+	}
+}
@@ -6,163 +6,46 @@
 #include <optional>
 #include <iostream>
 #include <vector_alias.hpp>
-
-class SnakeGame : public sf::Drawable, public sf::Transformable {
-private:
-    struct SnakeSegment {
-        sf::Vector2f coords;
-        bool head = false;
-    };
-
-    raw::vector<SnakeSegment> snakeData;
-    sf::Vector2f prevCoords;
-    sf::Vector2f foodCoords;
-
-    sf::Keyboard::Scancode prevMove = sf::Keyboard::Scancode::W;
-    sf::Keyboard::Scancode currMove = sf::Keyboard::Scancode::W;
-
-    std::random_device rd;
-    std::mt19937 gen;
-    std::uniform_int_distribution<> xDist;
-    std::uniform_int_distribution<> yDist;
-
-    unsigned int score = 0;
-
-public:
-    SnakeGame() : gen(rd()), xDist(0, 79), yDist(0, 59) {
-        snakeData.reserve(50000);
-        snakeData.push_back({ {100, 100}, true });
-        generateApple();
-    }
-
-    unsigned int getScore() {
-        return score;
-    }
-
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
-        for (const auto& segment : snakeData) {
-            sf::RectangleShape rect({ 10, 10 });
-            rect.setFillColor(segment.head ? sf::Color::Red : sf::Color::Green);
-            rect.setPosition(segment.coords);
-            target.draw(rect);
-        }
-
-        sf::CircleShape food(5);
-        food.setPosition(foodCoords);
-        target.draw(food);
-    }
-
-    void move(const sf::Keyboard::Scancode& button) {
-        currMove = button;
-    }
-    void move(const sf::Event::KeyPressed& button) {
-        currMove = button.scancode;
-    }
-
-
-
-    void move() {
-        prevCoords = snakeData[0].coords;
-        if (currMove == sf::Keyboard::Scancode::A) {
-            if (prevMove != sf::Keyboard::Scancode::D)
-            { snakeData[0].coords.x -= 10; prevMove = currMove; }
-            else
-                snakeData[0].coords.x += 10;
-        }
-
-        if (currMove == sf::Keyboard::Scancode::D) {
-            if (prevMove != sf::Keyboard::Scancode::A)
-            { snakeData[0].coords.x += 10; prevMove = currMove; }
-            else
-                snakeData[0].coords.x -= 10;
-        }
-        if (currMove == sf::Keyboard::Scancode::W) {
-            if (prevMove != sf::Keyboard::Scancode::S)
-            { snakeData[0].coords.y -= 10; prevMove = currMove; }
-            else
-                snakeData[0].coords.y += 10;
-        }
-        if (currMove == sf::Keyboard::Scancode::S) {
-            if (prevMove != sf::Keyboard::Scancode::W)
-            { snakeData[0].coords.y += 10; prevMove = currMove; }
-            else
-                snakeData[0].coords.y -= 10;
-        }
-
-        for (int i = snakeData.get_size() - 1; i > 0; --i) {
-            if (i == 1)
-                snakeData[1].coords = prevCoords;
-            else
-                snakeData[i].coords = snakeData[i - 1].coords;
-        }
-    }
-
-    void add_snake() {
-        sf::Vector2f lastCoords = snakeData.get_size() == 1 ? prevCoords : snakeData[snakeData.get_size() - 1].coords;
-        sf::Vector2f secondLastCoords = snakeData[snakeData.get_size() - 2].coords;
-        sf::Vector2f newCoords = lastCoords;
-
-        SnakeSegment snk;
-        snk.coords = newCoords;
-        snakeData.push_back(snk);
-        ++score;
-    }
-
-    void generateApple() {
-        bool valid = false;
-        while (!valid) {
-            foodCoords = { float(xDist(gen) * 10), float(yDist(gen) * 10) };
-            valid = true;
-            for (const auto& segment : snakeData) {
-                if (segment.coords == foodCoords) {
-                    valid = false;
-                    break;
-                }
-            }
-        }
-    }
-
-    bool update(sf::Time deltaTime) {
-        static sf::Time elapsedTime;
-        elapsedTime += deltaTime;
-
-        if (elapsedTime.asMilliseconds() > 100) {
-            if (checkCollision()) {
-                std::cout << "Game over!" << std::endl;
-                return false;
-            }
-
-
-            move();
-            if (snakeData[0].coords == foodCoords) {
-                add_snake();
-                generateApple();
-            }
-            elapsedTime = sf::Time::Zero;
-            return true;
-        }
-        else
-            return true;
-    }
-
-    bool checkCollision() {
-        if (snakeData[0].coords.x < 0 || snakeData[0].coords.x >= 800 ||
-            snakeData[0].coords.y < 0 || snakeData[0].coords.y >= 600) {
-            return true;
-        }
-
-        for (size_t i = 1; i < snakeData.get_size(); ++i) {
-            if (snakeData[0].coords == snakeData[i].coords) {
-                return true;
-            }
-        }
-
-        return false;
-    }
-};
-
-
-
+#include "SnakeGame.hpp"
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include "SnakeNamespace/bench/ArenaBench.hpp"
+#include "SnakeNamespace/bench/BatchBench.hpp"
+#include "SnakeNamespace/bench/ReplayBench.hpp"
+#include "SnakeNamespace/bench/SaveStateBench.hpp"
+#include "SnakeNamespace/bench/AutopilotBench.hpp"
+#include "SnakeNamespace/bots/Autopilot.hpp"
+#include "SnakeNamespace/bench/HamiltonianBench.hpp"
+#include "SnakeNamespace/bench/InputBench.hpp"
+#include "SnakeNamespace/input/InputQueue.hpp"
+#include "SnakeNamespace/threading/SimulationThread.hpp"
+#include "SnakeNamespace/bench/ThreadingBench.hpp"
+#include "SnakeNamespace/profiling/FrameProfiler.hpp"
+#include "SnakeNamespace/profiling/Trace.hpp"
+#include "SnakeNamespace/render/SoftwareRenderer.hpp"
+#include "SnakeNamespace/bench/RenderBench.hpp"
+#include "SnakeNamespace/scene/GameSession.hpp"
+#include "SnakeNamespace/bench/DirtyRenderBench.hpp"
+#include "SnakeNamespace/bench/SceneBench.hpp"
+#include "SnakeNamespace/resources/ResourceManager.hpp"
+#include "SnakeNamespace/turbo/Turbo.hpp"
+#include "SnakeNamespace/bench/RngBench.hpp"
+#include "SnakeNamespace/bench/TickBench.hpp"
+#include "SnakeNamespace/net/LockstepServer.hpp"
+#include "SnakeNamespace/net/LockstepClient.hpp"
+#include "SnakeNamespace/bench/NetBench.hpp"
+#include "SnakeNamespace/bench/DiffStreamBench.hpp"
+// defines the SnakeEnv.h C functions; this is the one translation unit that may include it
+#include "SnakeNamespace/env/SnakeEnvApi.hpp"
+#include "SnakeNamespace/bench/EnvBench.hpp"
+#include "SnakeNamespace/bench/BitplaneBench.hpp"
+#include "SnakeNamespace/bench/MctsBench.hpp"
+#include "SnakeNamespace/bench/ForkBench.hpp"
+#include "SnakeNamespace/bots/Hamiltonian.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
 
 enum class states {
     MENU,
@@ -176,12 +59,25 @@ class SnakeScreen : public sf::Drawable, public sf::Transformable {
 private:
     bool beginWind, LeaveWind;
 
-    states st;
-
-    sf::Font LogoFont;
+    states st = states::MENU;
+    std::optional<snake::game_session> session;
+    const snake::frame* shownFrame = nullptr;
+    std::uint64_t profiledTick = 0;
+    std::chrono::steady_clock::time_point gameRequested;
+    bool awaitingFirstFrame = false;
+    double lastStartLatency = 0;
+    // the window is only redrawn when something visible changed (or the overlay is due)
+    bool redraw = true;
+    std::uint64_t drawnTick = ~std::uint64_t(0);
+    // CPU and wall time spent in each scene, reported with --profile
+    double sceneCpuStart = snake::process_cpu_seconds();
+    std::chrono::steady_clock::time_point sceneWallStart = std::chrono::steady_clock::now();
+    double sceneCpuSeconds[2] = {}, sceneWallSeconds[2] = {};
+
+    // one font, loaded once by the resource manager, for every text
+    snake::font_handle uiFont;
     sf::Text GameLogo;
 
-    sf::Font ButtonFont;
     sf::RectangleShape startGameButtonBox;
     sf::Text startGame;
 
@@ -190,8 +86,20 @@ private:
 
     unsigned int max_score = 0;
     sf::Text ScoreText;
+
+    snake::frame_profiler menuProfiler;
+    snake::frame_profiler gameProfiler;
+    bool profiling = false;
+    bool showOverlay = false;
+    bool overlayStale = true;
+    sf::Text overlayText;
+    sf::Clock overlayClock;
 public:
-    SnakeScreen() : LogoFont("C:/Windows/Fonts/arial.ttf"), GameLogo(LogoFont), ButtonFont("C:/Windows/Fonts/arial.ttf"), startGame(ButtonFont), leaveGame(ButtonFont), LeaveWind(false), beginWind(false), ScoreText(ButtonFont) {
+    explicit SnakeScreen(snake::resource_manager& resources) : uiFont(resources.load_font("ui")), GameLogo(resources.get_font(uiFont)), startGame(resources.get_font(uiFont)), leaveGame(resources.get_font(uiFont)), LeaveWind(false), beginWind(false), ScoreText(resources.get_font(uiFont)), overlayText(resources.get_font(uiFont)) {
+
+        overlayText.setCharacterSize(14);
+        overlayText.setPosition({ 560, 10 });
+        overlayText.setFillColor(sf::Color::Yellow);
 
 		ScoreText.setCharacterSize(20);
 		ScoreText.setPosition({ 20, 20 });
@@ -220,19 +128,32 @@ public:
         leaveGame.setFillColor(sf::Color::Red);
     }
 
+    // The fixed strings and their sizes, for resource_manager::prewarm(); the overlay may show any printable character.
+    static std::vector<std::pair<std::string, unsigned int>> prewarmTexts() {
+        std::string printable;
+        for (char c = ' '; c <= '~'; ++c)
+            printable += c;
+        return { { "SNAKE GAME", 50 }, { "Start Game", 30 }, { "Exit Game", 30 }, { "Max Score: 0123456789", 20 }, { printable, 14 } };
+    }
+
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
         states.transform *= getTransform();
+        snake::sfml_backend backend(target, states);
+        render(backend);
+    }
 
-		target.draw(ScoreText, states);
-        target.draw(GameLogo, states);
+    void render(snake::render_backend& backend) const {
+		backend.draw_text(ScoreText);
+        backend.draw_text(GameLogo);
 
-        target.draw(startGameButtonBox, states);
-        target.draw(startGame, states);
+        backend.fill_rect(startGameButtonBox.getGlobalBounds(), startGameButtonBox.getFillColor());
+        backend.draw_text(startGame);
 
-        target.draw(leaveGameButtonBox, states);
-        target.draw(leaveGame, states);
+        backend.fill_rect(leaveGameButtonBox.getGlobalBounds(), leaveGameButtonBox.getFillColor());
+        backend.draw_text(leaveGame);
     }
     void MouseMoved(sf::Vector2i position) {
+        bool wasBegin = beginWind, wasLeave = LeaveWind;
         if (startGameButtonBox.getGlobalBounds().contains({float(position.x), float(position.y)})) {
             beginWind = true;
             startGameButtonBox.setFillColor(sf::Color::Black);
@@ -252,6 +173,40 @@ public:
             LeaveWind = false;
             leaveGameButtonBox.setFillColor(sf::Color::White);
         }
+        if (beginWind != wasBegin || LeaveWind != wasLeave)
+            redraw = true;
+    }
+
+    // Collect frame timings for the whole session (--profile); written out by writeProfile().
+    void setProfiling(bool on) {
+        profiling = on;
+        menuProfiler.set_enabled(on || showOverlay);
+        gameProfiler.set_enabled(on || showOverlay);
+    }
+    // F3: timings are only collected while the overlay is up, unless profiling is on anyway.
+    void toggleOverlay() {
+        showOverlay = !showOverlay;
+        overlayStale = true;
+        redraw = true;
+        setProfiling(profiling);
+    }
+    void drawOverlay(sf::RenderTarget& target, const snake::frame_profiler& profiler) {
+        if (!showOverlay)
+            return;
+        if (overlayStale || overlayClock.getElapsedTime() > sf::milliseconds(250)) {
+            overlayText.setString(profiler.summary());
+            overlayClock.restart();
+            overlayStale = false;
+        }
+        target.draw(overlayText);
+    }
+    void writeProfile(const std::string& path) const {
+        if (!menuProfiler.get_phase(snake::frame_profiler::events).count() && !gameProfiler.get_phase(snake::frame_profiler::events).count())
+            return;
+        std::ofstream out(path);
+        snake::frame_profiler::write_csv_header(out);
+        menuProfiler.write_csv(out, "menu");
+        gameProfiler.write_csv(out, "game");
     }
 
     bool getBeginWind() {
@@ -262,75 +217,463 @@ public:
 	}
 
     void MousePressed() {
-        if (beginWind) {
-            SnakeGame game;
-            sf::RenderWindow window(sf::VideoMode({ 800, 600 }), "Snake game");
-            sf::Clock clock;
-			unsigned int score = 0;
-            while (window.isOpen()) {
-                while (const auto event = window.pollEvent()) {
-                    if (event->is<sf::Event::Closed>()) {
-                        window.close();
-                    }
-                    else if (const auto* button = event->getIf<sf::Event::KeyPressed>()) {
-                        if (button->scancode == sf::Keyboard::Scancode::W || button->scancode == sf::Keyboard::Scancode::S || button->scancode == sf::Keyboard::Scancode::A || button->scancode == sf::Keyboard::Scancode::D)
-                            game.move(*button);
-                        else if (button->scancode == sf::Keyboard::Scancode::Escape) {
+        if (beginWind)
+            beginGame();
+    }
+
+    // MENU -> GAME on the same window: only a game_session (and its thread) is created.
+    void beginGame() {
+        gameRequested = std::chrono::steady_clock::now();
+        awaitingFirstFrame = true;
+        session.emplace();
+        shownFrame = nullptr;
+        profiledTick = 0;
+        switchScene(states::GAME);
+    }
+    void endGame() {
+        if (!session)
+            return;
+        session->finish();
+        session.reset();
+        shownFrame = nullptr;
+        switchScene(states::MENU);
+    }
+    void switchScene(states next) {
+        double cpu = snake::process_cpu_seconds();
+        auto wall = std::chrono::steady_clock::now();
+        sceneCpuSeconds[int(st)] += cpu - sceneCpuStart;
+        sceneWallSeconds[int(st)] += std::chrono::duration<double>(wall - sceneWallStart).count();
+        sceneCpuStart = cpu;
+        sceneWallStart = wall;
+        st = next;
+        overlayStale = true;
+        redraw = true;
+    }
+    // Process CPU time (all threads) as a share of wall time, per scene.
+    void writeCpuUsage(std::ostream& out) {
+        switchScene(st);
+        const char* names[2] = { "menu", "game" };
+        for (int i = 0; i < 2; ++i) {
+            if (sceneWallSeconds[i] <= 0)
+                continue;
+            out << names[i] << ": " << sceneCpuSeconds[i] << " s CPU in " << sceneWallSeconds[i] << " s ("
+                << 100 * sceneCpuSeconds[i] / sceneWallSeconds[i] << "% of a core)" << std::endl;
+        }
+    }
+    states getState() const {
+        return st;
+    }
+    snake::frame_profiler& getProfiler() {
+        return st == states::GAME ? gameProfiler : menuProfiler;
+    }
+
+    void handleEvent(const sf::Event& event, sf::RenderWindow& window) {
+        if (event.is<sf::Event::Closed>()) {
+            window.close();
+            return;
+        }
+        if (event.is<sf::Event::Resized>() || event.is<sf::Event::FocusGained>()) {
+            redraw = true;
+            return;
+        }
+        if (const auto* button = event.getIf<sf::Event::KeyPressed>()) {
+            if (button->scancode == sf::Keyboard::Scancode::F3)
+                toggleOverlay();
+            else if (button->scancode == sf::Keyboard::Scancode::Escape) {
+                if (st == states::GAME)
+                    endGame();
+                else
+                    window.close();
+            }
+            else if (st == states::GAME)
+                session->key_pressed(button->scancode);
+            return;
+        }
+        if (st != states::MENU)
+            return;
+        if (const auto* button = event.getIf<sf::Event::MouseMoved>()) {
+            MouseMoved(button->position);
+        }
+        else if (const auto* button = event.getIf<sf::Event::MouseButtonPressed>()) {
+            if (button->button == sf::Mouse::Button::Left) {
+                if (LeaveWind)
+                    window.close();
+                else
+                    MousePressed();
+            }
+        }
+    }
+
+    // Picks up the simulation's latest frame; a finished game goes back to the menu.
+    void update() {
+        if (st != states::GAME)
+            return;
+        const snake::frame& latest = session->latest();
+        if (latest.tick != profiledTick) {
+            gameProfiler.record(snake::frame_profiler::tick, float(latest.tick_ns) / 1000);
+            profiledTick = latest.tick;
+        }
+        shownFrame = &latest;
+        if (latest.tick != drawnTick)
+            redraw = true;
+        if (!latest.alive) {
+            if (latest.score > max_score) {
+                max_score = latest.score;
+                ScoreText.setString("Max Score: " + std::to_string(max_score));
+            }
+            endGame();
+        }
+    }
+
+    bool needsRedraw() const {
+        return redraw || (showOverlay && overlayClock.getElapsedTime() > sf::milliseconds(250));
+    }
+    // How long the main loop may block waiting for events; Time::Zero means until one arrives.
+    sf::Time idleTimeout() const {
+        sf::Time timeout = sf::Time::Zero;
+        auto sooner = [&](sf::Time due) {
+            due = std::max(due, sf::milliseconds(1));
+            if (timeout == sf::Time::Zero || due < timeout)
+                timeout = due;
+        };
+        if (showOverlay)
+            sooner(sf::milliseconds(250) - overlayClock.getElapsedTime());
+        // the next game frame is due one period after the shown one was published
+        if (st == states::GAME && shownFrame)
+            sooner(sf::microseconds((shownFrame->published_ns - snake::input_queue::now_ns()) / 1000) + session->get_period());
+        return timeout;
+    }
+
+    void drawScene(sf::RenderTarget& target) {
+        target.clear(sf::Color::Blue);
+        if (st == states::GAME && shownFrame) {
+            session->draw(target, *shownFrame);
+            drawnTick = shownFrame->tick;
+        }
+        else
+            target.draw(*this);
+        redraw = false;
+    }
+
+    // Call after display(): reports how long the click took to become a game frame on screen.
+    void frameShown() {
+        if (!awaitingFirstFrame || st != states::GAME)
+            return;
+        awaitingFirstFrame = false;
+        lastStartLatency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - gameRequested).count();
+        if (profiling)
+            std::cout << "menu -> first game frame: " << lastStartLatency << " ms" << std::endl;
+    }
+    double getLastStartLatency() const {
+        return lastStartLatency;
+    }
+};
+
+
+
+int main(int argc, char** argv) {
+    const auto launched = std::chrono::steady_clock::now();
+    bool profile = false, trace = false;
+    for (int i = 1; i < argc; ++i) {
+        profile = profile || std::string(argv[i]) == "--profile";
+        trace = trace || std::string(argv[i]) == "--trace";
+    }
+    if (argc > 1 && std::string(argv[1]) != "--profile" && std::string(argv[1]) != "--trace") {
+        std::string mode = argv[1];
+        if (mode == "--bench-arena")
+            return snake::run_arena_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-batch")
+            return snake::run_batch_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-replay")
+            return snake::run_replay_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-savestate")
+            return snake::run_savestate_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-autopilot")
+            return snake::run_autopilot_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-hamiltonian")
+            return snake::run_hamiltonian_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-input")
+            return snake::run_input_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-threading")
+            return snake::run_threading_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-render")
+            return snake::run_render_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-dirty-render")
+            return snake::run_dirty_render_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-rng")
+            return snake::run_rng_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-tick") {
+            // --bench-tick [results.json]; "-" puts the JSON on stdout and the table on stderr
+            if (argc > 2 && std::string(argv[2]) == "-")
+                return snake::run_tick_benchmark(std::cerr, &std::cout) ? 0 : 1;
+            std::ofstream json;
+            if (argc > 2) {
+                json.open(argv[2]);
+                if (!json) {
+                    std::cerr << "Cannot write " << argv[2] << std::endl;
+                    return 1;
+                }
+            }
+            return snake::run_tick_benchmark(std::cout, argc > 2 ? &json : nullptr) ? 0 : 1;
+        }
+        if (mode == "--bench-net")
+            return snake::run_net_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-diff-stream")
+            return snake::run_diff_stream_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-env")
+            return snake::run_env_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-bitplane")
+            return snake::run_bitplane_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-mcts")
+            return snake::run_mcts_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--bench-fork")
+            return snake::run_fork_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--server") {
+            // head-to-head over UDP: --server [port] [players] [ticks per second]
+            snake::lockstep_server_options options;
+            if (argc > 2) options.port = (unsigned short)std::stoul(argv[2]);
+            if (argc > 3) options.players = std::stoi(argv[3]);
+            if (argc > 4) options.tick_hz = std::stod(argv[4]);
+            options.seed = snake::fresh_seed();
+            snake::lockstep_server server(options);
+            if (!server.bind()) {
+                std::cerr << "Cannot bind UDP port " << options.port << std::endl;
+                return 1;
+            }
+            std::cout << "Waiting for " << server.get_game().get_player_count() << " players on UDP port " << server.get_port() << std::endl;
+            snake::print_server_report(std::cout, server.run());
+            return 0;
+        }
+        if (mode == "--client" && argc > 2) {
+            // --client host [port] [bot]: joins a --server game, in a window with WASD or as the greedy bot
+            std::optional<sf::IpAddress> host = sf::IpAddress::resolve(argv[2]);
+            unsigned short port = argc > 3 ? (unsigned short)std::stoul(argv[3]) : 53000;
+            bool bot = argc > 4 && std::string(argv[4]) == "bot";
+            snake::lockstep_client client;
+            if (!host || !client.connect(*host, port)) {
+                std::cerr << "Cannot reach " << argv[2] << std::endl;
+                return 1;
+            }
+            if (bot)
+                snake::run_bot_client(client, std::chrono::steady_clock::time_point::max());
+            else {
+                sf::RenderWindow window(sf::VideoMode({ 800, 600 }), "Snake versus");
+                while (window.isOpen() && !client.is_over()) {
+                    while (const auto event = window.pollEvent()) {
+                        if (event->is<sf::Event::Closed>())
                             window.close();
+                        else if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+                            using dir = snake::versus_game::direction;
+                            switch (key->scancode) {
+                            case sf::Keyboard::Scancode::W: client.send_input(dir::up); break;
+                            case sf::Keyboard::Scancode::D: client.send_input(dir::right); break;
+                            case sf::Keyboard::Scancode::S: client.send_input(dir::down); break;
+                            case sf::Keyboard::Scancode::A: client.send_input(dir::left); break;
+                            default: break;
+                            }
                         }
                     }
-                }
-                if (!(game.update(clock.restart()))) {
-					score = game.getScore();
-                    if (score > max_score) {
-                        max_score = score;
-                        ScoreText.setString("Max Score: " + std::to_string(max_score));
+                    if (client.poll(sf::milliseconds(5))) {
+                        window.clear(sf::Color::Blue);
+                        snake::sfml_backend backend(window);
+                        client.get_game().render(backend);
+                        window.display();
                     }
-                    window.close();
                 }
-                window.clear(sf::Color::Blue);
-                window.draw(game);
-                window.display();
             }
+            const snake::lockstep_client_report& report = client.get_report();
+            const snake::versus_game& game = client.get_game();
+            for (int id = 0; id < game.get_player_count(); ++id)
+                std::cout << "player " << id << (id == client.get_player() ? " (you)" : "") << ": score " << game.get_player(id).score
+                    << (game.get_player(id).alive ? "" : ", dead") << "\n";
+            snake::print_traffic_header(std::cout);
+            snake::print_traffic(std::cout, "client", report.traffic, report.ticks_applied);
+            snake::latency_histogram::print_header(std::cout, "input->tick");
+            report.latency.print_row(std::cout, "client");
+            std::cout << report.desyncs << " desyncs, " << report.snapshots << " snapshots" << std::endl;
+            return 0;
+        }
+        if (mode == "--bench-scene")
+            return snake::run_scene_benchmark(std::cout) ? 0 : 1;
+        if (mode == "--render" && argc > 2) {
+            // headless frame for golden-image checks: the greedy bot plays `ticks` ticks of game `seed`
+            std::uint32_t seed = argc > 3 ? std::uint32_t(std::stoul(argv[3])) : 1;
+            std::uint64_t ticks = argc > 4 ? std::stoull(argv[4]) : 500;
+            snake::framebuffer image(SnakeGame::boardWidth * SnakeGame::cellSize, SnakeGame::boardHeight * SnakeGame::cellSize);
+            SnakeGame game = snake::render_bot_frame(image, seed, ticks);
+            if (!image.save(argv[2])) {
+                std::cerr << "Cannot write " << argv[2] << std::endl;
+                return 1;
+            }
+            std::cout << argv[2] << ": tick " << game.getTicks() << ", length " << game.getLength()
+                << ", image hash " << std::hex << image.hash() << std::dec;
+            // frames with a checked-in hash fail on a mismatch
+            std::uint64_t expected = snake::golden_hash(seed, ticks);
+            if (expected)
+                std::cout << (image.hash() == expected ? " (matches golden)" : " (GOLDEN MISMATCH)");
+            std::cout << std::endl;
+            return expected && image.hash() != expected ? 1 : 0;
         }
+        if (mode == "--turbo") {
+            // fast-forward a bot game: --turbo [hamiltonian|greedy|autopilot|mcts] [max ticks] [render every N, 0 = never] [seed] [diff stream file, - for stdout]
+            std::string bot = argc > 2 ? argv[2] : "hamiltonian";
+            snake::turbo_options options;
+            if (argc > 3) options.max_ticks = std::stoull(argv[3]);
+            if (argc > 4) options.render_every = std::stoull(argv[4]);
+            if (argc > 5) options.seed = std::uint32_t(std::stoul(argv[5]));
+            std::string streamPath = argc > 6 ? argv[6] : "";
+            // a stream on stdout moves the progress lines to stderr
+            std::ostream& progress = streamPath == "-" ? std::cerr : std::cout;
+            int streamFd = -1;
+            if (!streamPath.empty() && (streamFd = snake::open_diff_stream(streamPath)) < 0) {
+                std::cerr << "Cannot write " << streamPath << std::endl;
+                return 1;
+            }
+            std::optional<snake::diff_stream_writer> stream;
+            if (streamFd >= 0) stream.emplace(streamFd, SnakeGame{ options.seed });
+            auto observe = [&](const SnakeGame& g) { if (stream) stream->capture(g); };
+            snake::turbo_report report;
+            if (bot == "hamiltonian") {
+                snake::hamiltonian_solver solver;
+                report = snake::run_turbo(options, [&](const SnakeGame& g) { return solver.decide(g); }, &progress, observe);
+            }
+            else if (bot == "greedy")
+                report = snake::run_turbo(options, snake::greedy_policy, &progress, observe);
+            else if (bot == "autopilot") {
+                snake::autopilot pilot;
+                report = snake::run_turbo(options, [&](const SnakeGame& g) { return pilot.decide(g); }, &progress, observe);
+            }
+            else if (bot == "mcts") {
+                snake::mcts_agent agent;
+                report = snake::run_turbo(options, [&](const SnakeGame& g) { return agent.decide(g); }, &progress, observe);
+            }
+            else {
+                std::cerr << "Unknown bot: " << bot << std::endl;
+                return 1;
+            }
+            snake::print_turbo_report(progress, report);
+            if (stream) {
+                bool written = stream->finish();
+                snake::close_diff_stream(streamFd);
+                progress << "diff stream: " << stream->get_stored_bytes() << " bytes (" << stream->get_raw_bytes() << " before run-length coding) in "
+                    << stream->get_writes() << " writes" << std::endl;
+                if (!written) {
+                    std::cerr << "Writing " << streamPath << " failed" << std::endl;
+                    return 1;
+                }
+            }
+            return 0;
+        }
+        if (mode == "--vector-report") {
+            // raw::vector allocation statistics after a Hamiltonian bot game: --vector-report [ticks]
+            std::uint64_t ticks = argc > 2 ? std::stoull(argv[2]) : 20000;
+            SnakeGame game{ 1 };
+            snake::hamiltonian_solver solver;
+            while (game.getTicks() < ticks) {
+                game.move(solver.decide(game));
+                if (!game.tick())
+                    break;
+            }
+            raw::vector_stats body = game.getBody().get_stats();
+            std::cout << "game body after " << game.getTicks() << " ticks: length " << body.size << " (peak " << body.peak_size
+                << "), capacity " << body.capacity << ", " << body.slack_bytes() << " bytes slack, "
+                << body.reallocations << " reallocations" << std::endl;
+            raw::write_vector_report(std::cout);
+            return 0;
+        }
+        if (mode == "--read-stream" && argc > 2) {
+            // --read-stream file [tick]: the board a diff stream holds at `tick` (default: its last one)
+            snake::diff_stream_reader reader;
+            if (!reader.load(argv[2])) {
+                std::cerr << "Cannot read diff stream " << argv[2] << std::endl;
+                return 1;
+            }
+            std::uint64_t tick = argc > 3 ? std::stoull(argv[3]) : reader.get_length();
+            if (!reader.seek(tick)) {
+                std::cerr << "Corrupt diff stream " << argv[2] << std::endl;
+                return 1;
+            }
+            const snake::diff_state& state = reader.get_state();
+            const char* ending[] = { "", ", game lost", ", game won" };
+            std::cout << "seed " << reader.get_seed() << ", " << reader.get_length() << " ticks" << (reader.is_complete() ? ending[int(reader.get_outcome())] : " (cut off)")
+                << "; tick " << state.tick << ": score " << state.score << ", length " << state.body.size() << ", head ("
+                << state.body.front().x << ", " << state.body.front().y << "), food (" << state.food.x << ", " << state.food.y << ")" << std::endl;
+            return 0;
+        }
+        if (mode == "--replay" && argc > 2) {
+            snake::replay recorded;
+            if (!recorded.load(argv[2])) {
+                std::cerr << "Cannot read replay " << argv[2] << std::endl;
+                return 1;
+            }
+            snake::replay_player player(recorded);
+            while (player.step()) {}
+            std::cout << "Replayed " << player.get_tick() << " ticks, score " << player.get_game().getScore()
+                << (player.is_valid() ? " (matches recording)" : " (DESYNC)") << std::endl;
+            return player.is_valid() ? 0 : 1;
+        }
+        std::cerr << "Unknown option: " << mode << std::endl;
+        return 1;
     }
-};
-
 
-
-int main() {
+    snake::resource_manager resources;
+    const snake::font_handle uiFont = resources.load_font("ui");
 	sf::RenderWindow window(sf::VideoMode({ 800, 600 }), "Snake game");
-	SnakeScreen menu;
+    if (trace) {
+        snake::tracer::instance().set_enabled(true);
+        snake::tracer::instance().set_thread_name("render");
+    }
+	SnakeScreen menu(resources);
+    menu.setProfiling(profile);
+    bool coldStart = true;
 	sf::Clock clock;
     unsigned int max_score;
     max_score = 0;
 	while (window.isOpen()) {
+        // nothing new to show: block until an event arrives or the scene's next deadline
+        if (!menu.needsRedraw()) {
+            if (const auto event = window.waitEvent(menu.idleTimeout()))
+                menu.handleEvent(*event, window);
+        }
+        snake::frame_profiler& profiler = menu.getProfiler();
+        auto eventsTimer = profiler.time(snake::frame_profiler::events);
 		while (const auto event = window.pollEvent()) {
-			if (event->is<sf::Event::Closed>()) {
-				window.close();
-			}
-			if (const auto* button = event->getIf<sf::Event::KeyPressed>()) {
-				if (button->scancode == sf::Keyboard::Scancode::Escape) {
-					window.close();
-				}
-			}
-            else if (const auto* button = event->getIf<sf::Event::MouseMoved>()) {
-                menu.MouseMoved(button->position);
-            }
-            else if (const auto* button = event->getIf<sf::Event::MouseButtonPressed>()) {
-				if (button->button == sf::Mouse::Button::Left) {
-                    if (menu.getLeaveWind()) {
-                        window.close();
-                        break;
-                    }
-                    else if (menu.getBeginWind())
-                        menu.MousePressed();
-				}
-            }
+            menu.handleEvent(*event, window);
 		}
-		window.clear(sf::Color::Blue);
-		window.draw(menu);
+        menu.update();
+        if (!menu.needsRedraw()) {
+            eventsTimer.cancel();
+            continue;
+        }
+        eventsTimer.stop();
+        // the font is not thread-safe: a prewarm still running finishes before anything is drawn with it
+        resources.wait_prewarm();
+        auto drawTimer = menu.getProfiler().time(snake::frame_profiler::draw);
+        menu.drawScene(window);
+        drawTimer.stop();
+        menu.drawOverlay(window, menu.getProfiler());
+        auto displayTimer = menu.getProfiler().time(snake::frame_profiler::display);
 		window.display();
+        displayTimer.stop();
+        menu.frameShown();
+        if (coldStart) {
+            coldStart = false;
+            if (profile)
+                std::cout << "cold start -> first frame: " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launched).count()
+                    << " ms (font " << resources.get_load_ms() << " ms from " << resources.get_font_source(uiFont) << ")" << std::endl;
+            // the first frame built the menu's own glyphs; the rest are built while the menu waits for input
+            resources.prewarm(uiFont, SnakeScreen::prewarmTexts());
+        }
 	}
+    menu.endGame();
+    resources.wait_prewarm();
+    if (profile) {
+        std::cout << "glyph prewarm: " << resources.get_prewarm_ms() << " ms in the background after the first frame" << std::endl;
+        menu.writeCpuUsage(std::cout);
+        raw::write_vector_report(std::cout);
+    }
 
-}
\ No newline at end of file
+    menu.writeProfile("frame_profile.csv");
+    if (trace && snake::tracer::instance().save("trace.json"))
+        std::cout << "Trace written to trace.json (open in ui.perfetto.dev or chrome://tracing)" << std::endl;
+}
@@ -0,0 +1,424 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <random>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <iostream>
+#include <vector>
+#include <vector_alias.hpp>
+#include "SnakeNamespace/profiling/Trace.hpp"
+#include "SnakeNamespace/render/RenderBackend.hpp"
+#include "SnakeNamespace/random/Random.hpp"
+
+// Rng places the food: any trivially copyable engine with a full 32- or 64-bit output
+// (snake::xoshiro256ss, snake::pcg32, std::mt19937). The same seed gives the same game.
+template <typename Rng = snake::xoshiro256ss>
+class BasicSnakeGame : public sf::Drawable, public sf::Transformable {
+public:
+    using rng_type = Rng;
+
+    static constexpr int cellSize = 10;
+    static constexpr int boardWidth = 80;
+    static constexpr int boardHeight = 60;
+
+    struct SnakeSegment {
+        sf::Vector2f coords;
+        bool head = false;
+        // explicit, so save-states (raw copies of the body) never contain indeterminate padding bytes
+        unsigned char reserved[3] = {};
+    };
+
+    // Everything tick() depends on, so a restored game plays on exactly like the original.
+    struct Snapshot {
+        std::vector<sf::Vector2f> body;
+        sf::Vector2f prevCoords;
+        sf::Vector2f foodCoords;
+        sf::Keyboard::Scancode prevMove;
+        sf::Keyboard::Scancode currMove;
+        Rng gen;
+        unsigned int score;
+        std::uint64_t ticks;
+    };
+
+    // 2: apples drawn with snake::bounded() from Rng instead of std::uniform_int_distribution over std::mt19937
+    static constexpr std::uint32_t saveStateVersion = 2;
+
+    // Fixed-size front of a save-state buffer; the body follows as raw SnakeSegment records.
+    // Layout is that of the writing build, segmentBytes/rngBytes guard against mismatches.
+    struct SaveStateHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t segmentBytes;
+        std::uint32_t rngBytes;
+        std::uint64_t segmentCount;
+        sf::Vector2f prevCoords;
+        sf::Vector2f foodCoords;
+        sf::Keyboard::Scancode prevMove;
+        sf::Keyboard::Scancode currMove;
+        std::uint32_t seed;
+        unsigned int score;
+        std::uint64_t ticks;
+        std::int64_t elapsedMicroseconds;
+        alignas(Rng) unsigned char rng[sizeof(Rng)];
+    };
+
+private:
+    static_assert(std::is_trivially_copyable_v<SnakeSegment>, "save-states copy the body as raw bytes");
+    static_assert(sizeof(SnakeSegment) == sizeof(sf::Vector2f) + 4, "SnakeSegment must not have implicit padding");
+    static_assert(std::is_trivially_copyable_v<Rng>, "save-states copy the engine as raw bytes");
+
+    raw::vector<SnakeSegment> snakeData;
+    sf::Vector2f prevCoords;
+    sf::Vector2f foodCoords;
+
+    sf::Keyboard::Scancode prevMove = sf::Keyboard::Scancode::W;
+    sf::Keyboard::Scancode currMove = sf::Keyboard::Scancode::W;
+
+    Rng gen;
+
+    std::uint32_t seed;
+    unsigned int score = 0;
+    std::uint64_t ticks = 0;
+    sf::Time elapsedTime;
+
+    struct ForkTag {};
+    // A shell for fork() to fill: no reservation and no apple draw.
+    explicit BasicSnakeGame(ForkTag) : seed(0) {
+        snakeData.set_stats_label("SnakeGame body");
+    }
+
+public:
+    BasicSnakeGame() : BasicSnakeGame(snake::fresh_seed()) {}
+
+    explicit BasicSnakeGame(std::uint32_t seed) : gen(seed), seed(seed) {
+        snakeData.set_stats_label("SnakeGame body");
+        // the board holds boardWidth * boardHeight segments at most
+        snakeData.reserve(boardWidth * boardHeight);
+        snakeData.push_back({ {100, 100}, true });
+        generateApple();
+    }
+
+    // Starts over as a fresh BasicSnakeGame(newSeed) would, but keeps the body's storage:
+    // nothing is allocated, so batched environments can restart games every step.
+    void reset(std::uint32_t newSeed) {
+        snakeData.resize(1);
+        snakeData[0] = { {100, 100}, true };
+        prevCoords = {};
+        prevMove = currMove = sf::Keyboard::Scancode::W;
+        gen = Rng(newSeed);
+        seed = newSeed;
+        score = 0;
+        ticks = 0;
+        elapsedTime = sf::Time::Zero;
+        generateApple();
+    }
+
+    unsigned int getScore() const {
+        return score;
+    }
+    std::uint32_t getSeed() const {
+        return seed;
+    }
+    std::uint64_t getTicks() const {
+        return ticks;
+    }
+    size_t getLength() const {
+        return snakeData.get_size();
+    }
+    // The column and row of the cell at pixel `coords`. A head that moved off the board is
+    // in column or row -1 or one past the last; food that has nowhere to go is at -1, -1.
+    static sf::Vector2i cellOf(sf::Vector2f coords) {
+        int x = int(coords.x), y = int(coords.y);
+        // floor, not truncation: x = -1 is column -1
+        return { (x < 0 ? x - cellSize + 1 : x) / cellSize, (y < 0 ? y - cellSize + 1 : y) / cellSize };
+    }
+    // The cell at `coords` as y * boardWidth + x, or -1 off the board.
+    static int cellIndex(sf::Vector2f coords) {
+        sf::Vector2i cell = cellOf(coords);
+        return cell.x < 0 || cell.y < 0 || cell.x >= boardWidth || cell.y >= boardHeight ? -1 : cell.y * boardWidth + cell.x;
+    }
+    // The snake covers every cell; there is nowhere left to put food.
+    bool isWon() const {
+        return snakeData.get_size() >= size_t(boardWidth * boardHeight);
+    }
+    sf::Vector2f getHead() const {
+        return snakeData[0].coords;
+    }
+    sf::Vector2f getFood() const {
+        return foodCoords;
+    }
+    sf::Keyboard::Scancode getDirection() const {
+        return prevMove;
+    }
+    const raw::vector<SnakeSegment>& getBody() const {
+        return snakeData;
+    }
+    // The engine the next food is drawn from; a copy predicts every following apple.
+    const Rng& getRng() const {
+        return gen;
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snap{ {}, prevCoords, foodCoords, prevMove, currMove, gen, score, ticks };
+        snap.body.reserve(snakeData.get_size());
+        for (const auto& segment : snakeData)
+            snap.body.push_back(segment.coords);
+        return snap;
+    }
+
+    void restore(const Snapshot& snap) {
+        // raw::vector keeps capacity above size: reserving just the size would double it in resize()
+        snakeData.reserve(snap.body.size() + 1);
+        snakeData.resize(snap.body.size());
+        for (size_t i = 0; i < snap.body.size(); ++i)
+            snakeData[i] = { snap.body[i], i == 0 };
+        prevCoords = snap.prevCoords;
+        foodCoords = snap.foodCoords;
+        prevMove = snap.prevMove;
+        currMove = snap.currMove;
+        gen = snap.gen;
+        score = snap.score;
+        ticks = snap.ticks;
+    }
+
+    // An independent game that plays on exactly like this one. Unlike a copy, which also copies the
+    // boardWidth * boardHeight reservation, it holds only the live segments; it grows from there as needed.
+    BasicSnakeGame fork() const {
+        BasicSnakeGame copy{ ForkTag{} };
+        forkInto(copy);
+        return copy;
+    }
+
+    // fork() into `target`, reusing its body storage: nothing is allocated once `target` has held
+    // a body this long, so lookahead bots can keep a pool of games and fork into it every tick.
+    void forkInto(BasicSnakeGame& target) const {
+        if (&target == this)
+            return;
+        // raw::vector keeps capacity above size: reserving just the size would double it in resize()
+        target.snakeData.reserve(snakeData.get_size() + 1);
+        target.snakeData.resize(snakeData.get_size());
+        std::memcpy(&target.snakeData[0], &snakeData[0], snakeData.get_size() * sizeof(SnakeSegment));
+        target.prevCoords = prevCoords;
+        target.foodCoords = foodCoords;
+        target.prevMove = prevMove;
+        target.currMove = currMove;
+        target.gen = gen;
+        target.seed = seed;
+        target.score = score;
+        target.ticks = ticks;
+        target.elapsedTime = elapsedTime;
+        static_cast<sf::Transformable&>(target) = *this;
+    }
+
+    size_t saveStateSize() const {
+        return sizeof(SaveStateHeader) + snakeData.get_size() * sizeof(SnakeSegment);
+    }
+
+    // Writes the complete game into `buffer`. Returns the bytes written, or 0 if `capacity` is too small.
+    size_t saveState(void* buffer, size_t capacity) const {
+        size_t bytes = saveStateSize();
+        if (capacity < bytes)
+            return 0;
+
+        SaveStateHeader header{ { 'S', 'N', 'K', 'S' }, saveStateVersion, sizeof(SnakeSegment), sizeof(Rng),
+            snakeData.get_size(), prevCoords, foodCoords, prevMove, currMove, seed, score, ticks, elapsedTime.asMicroseconds(), {} };
+        std::memcpy(header.rng, &gen, sizeof(gen));
+
+        auto* out = static_cast<unsigned char*>(buffer);
+        std::memcpy(out, &header, sizeof(header));
+        std::memcpy(out + sizeof(header), &snakeData[0], snakeData.get_size() * sizeof(SnakeSegment));
+        return bytes;
+    }
+
+    std::vector<unsigned char> saveState() const {
+        std::vector<unsigned char> buffer(saveStateSize());
+        saveState(buffer.data(), buffer.size());
+        return buffer;
+    }
+
+    // Replaces the whole game with a buffer from saveState(). Leaves the game untouched and returns false on a bad buffer.
+    bool loadState(const void* buffer, size_t size) {
+        SaveStateHeader header;
+        if (size < sizeof(header))
+            return false;
+        std::memcpy(&header, buffer, sizeof(header));
+        if (std::memcmp(header.magic, "SNKS", 4) != 0 || header.version != saveStateVersion ||
+            header.segmentBytes != sizeof(SnakeSegment) || header.rngBytes != sizeof(Rng))
+            return false;
+        // the count is checked before it is multiplied, so a huge one cannot wrap around to a matching size
+        if (header.segmentCount == 0 || header.segmentCount > size_t(boardWidth) * boardHeight ||
+            size != sizeof(header) + header.segmentCount * sizeof(SnakeSegment))
+            return false;
+
+        // one past the count, as in forkInto(): resize() to exactly the capacity would double it
+        snakeData.reserve(header.segmentCount + 1);
+        snakeData.resize(header.segmentCount);
+        std::memcpy(&snakeData[0], static_cast<const unsigned char*>(buffer) + sizeof(header), header.segmentCount * sizeof(SnakeSegment));
+        std::memcpy(&gen, header.rng, sizeof(gen));
+        prevCoords = header.prevCoords;
+        foodCoords = header.foodCoords;
+        prevMove = header.prevMove;
+        currMove = header.currMove;
+        seed = header.seed;
+        score = header.score;
+        ticks = header.ticks;
+        elapsedTime = sf::microseconds(header.elapsedMicroseconds);
+        return true;
+    }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        snake::sfml_backend backend(target, states);
+        render(backend);
+    }
+
+    // Describes the board to any backend, e.g. snake::software_backend for headless frames.
+    void render(snake::render_backend& backend) const {
+        for (const auto& segment : snakeData)
+            backend.fill_rect({ segment.coords, { float(cellSize), float(cellSize) } }, segment.head ? sf::Color::Red : sf::Color::Green);
+
+        backend.fill_circle(foodCoords, cellSize / 2.f, sf::Color::White);
+    }
+
+    void move(const sf::Keyboard::Scancode& button) {
+        currMove = button;
+    }
+    void move(const sf::Event::KeyPressed& button) {
+        currMove = button.scancode;
+    }
+
+
+
+    void move() {
+        prevCoords = snakeData[0].coords;
+        if (currMove == sf::Keyboard::Scancode::A) {
+            if (prevMove != sf::Keyboard::Scancode::D)
+            { snakeData[0].coords.x -= 10; prevMove = currMove; }
+            else
+                snakeData[0].coords.x += 10;
+        }
+
+        if (currMove == sf::Keyboard::Scancode::D) {
+            if (prevMove != sf::Keyboard::Scancode::A)
+            { snakeData[0].coords.x += 10; prevMove = currMove; }
+            else
+                snakeData[0].coords.x -= 10;
+        }
+        if (currMove == sf::Keyboard::Scancode::W) {
+            if (prevMove != sf::Keyboard::Scancode::S)
+            { snakeData[0].coords.y -= 10; prevMove = currMove; }
+            else
+                snakeData[0].coords.y += 10;
+        }
+        if (currMove == sf::Keyboard::Scancode::S) {
+            if (prevMove != sf::Keyboard::Scancode::W)
+            { snakeData[0].coords.y += 10; prevMove = currMove; }
+            else
+                snakeData[0].coords.y -= 10;
+        }
+
+        for (int i = snakeData.get_size() - 1; i > 0; --i) {
+            if (i == 1)
+                snakeData[1].coords = prevCoords;
+            else
+                snakeData[i].coords = snakeData[i - 1].coords;
+        }
+    }
+
+    void add_snake() {
+        sf::Vector2f lastCoords = snakeData.get_size() == 1 ? prevCoords : snakeData[snakeData.get_size() - 1].coords;
+        sf::Vector2f newCoords = lastCoords;
+
+        SnakeSegment snk;
+        snk.coords = newCoords;
+        snakeData.push_back(snk);
+        ++score;
+    }
+
+    // Places the food on a free cell. Returns false when there is none left, i.e. the snake fills the board.
+    bool generateApple() {
+        snake::trace_scope traced("generateApple");
+        if (isWon()) {
+            foodCoords = { -float(cellSize), -float(cellSize) };
+            return false;
+        }
+        for (int attempt = 0; attempt < 16; ++attempt) {
+            int x = int(snake::bounded(gen, boardWidth)), y = int(snake::bounded(gen, boardHeight));
+            foodCoords = { float(x * cellSize), float(y * cellSize) };
+            bool valid = true;
+            for (const auto& segment : snakeData) {
+                if (segment.coords == foodCoords) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (valid)
+                return true;
+        }
+
+        // Crowded board: random probes keep landing on the body, so draw among the free cells directly.
+        snake::tracer::instance().instant("generateApple fallback", snakeData.get_size());
+        // on the stack: this runs on every meal of a long snake, which should not allocate
+        std::bitset<boardWidth * boardHeight> taken;
+        int freeCells = boardWidth * boardHeight;
+        for (const auto& segment : snakeData) {
+            int cell = cellIndex(segment.coords);
+            if (cell >= 0 && !taken[cell]) { taken[cell] = true; --freeCells; }
+        }
+        int pick = int(snake::bounded(gen, std::uint32_t(freeCells)));
+        for (int cell = 0;; ++cell) {
+            if (!taken[cell] && pick-- == 0) {
+                foodCoords = { float(cell % boardWidth * cellSize), float(cell / boardWidth * cellSize) };
+                return true;
+            }
+        }
+    }
+
+    // One simulation step, independent of wall-clock time. Returns false on game over,
+    // including the tick after the snake has filled the board.
+    bool tick() {
+        if (isWon() || checkCollision())
+            return false;
+
+        move();
+        if (snakeData[0].coords == foodCoords) {
+            add_snake();
+            generateApple();
+        }
+        ++ticks;
+        return true;
+    }
+
+    bool update(sf::Time deltaTime) {
+        elapsedTime += deltaTime;
+
+        if (elapsedTime.asMilliseconds() > 100) {
+            if (!tick()) {
+                std::cout << (isWon() ? "You win!" : "Game over!") << std::endl;
+                return false;
+            }
+            elapsedTime = sf::Time::Zero;
+            return true;
+        }
+        else
+            return true;
+    }
+
+    bool checkCollision() const {
+        if (snakeData[0].coords.x < 0 || snakeData[0].coords.x >= boardWidth * cellSize ||
+            snakeData[0].coords.y < 0 || snakeData[0].coords.y >= boardHeight * cellSize) {
+            return true;
+        }
+
+        for (size_t i = 1; i < snakeData.get_size(); ++i) {
+            if (snakeData[0].coords == snakeData[i].coords) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+using SnakeGame = BasicSnakeGame<>;
@@ -0,0 +1,290 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include "SnakeNamespace/threading/ThreadPool.hpp"
+
+namespace snake {
+	/*
+	 * @brief Shared board with many snakes, ticked data-parallel on a `thread_pool`.
+	 *
+	 * The board is split into horizontal bands (`region_rows` rows each). A tick runs in phases,
+	 * each phase being one `parallel_for`:
+	 *
+	 * ## Tick phases:
+	 * - plan     - every snake picks a direction and computes its next head cell (read-only board).
+	 * - bucket   - snakes are grouped by the region of their next head cell, in id order.
+	 * - resolve  - one task per region; two heads on one cell both die, a head on a body cell dies,
+	 *              a tail that moves away this tick does not block, unless its snake is heading for
+	 *              the mover's head (two length-1 snakes trading cells meet head-on and both die).
+	 * - apply    - dead bodies are cleared, tails popped, then new heads written (three passes).
+	 * - respawn  - eaten food and dead snakes are re-placed sequentially from the arena RNG.
+	 *
+	 * Every decision only depends on the state at the start of the tick and every cell is written
+	 * by exactly one task per pass, so results are bit-identical for any thread count.
+	 */
+	class arena {
+	public:
+		enum class direction : uint8_t { up, right, down, left };
+
+		struct config {
+			uint32_t width = 1024;
+			uint32_t height = 1024;
+			uint32_t snakes = 2000;
+			uint32_t food = 4000;
+			uint32_t max_length = 64;
+			uint32_t region_rows = 16;
+			uint64_t seed = 1;
+		};
+
+	private:
+		static constexpr uint32_t no_cell = 0xFFFFFFFFu;
+		static constexpr uint32_t claim_free = 0xFFFFFFFFu;
+		static constexpr uint32_t claim_clash = 0xFFFFFFFEu;
+
+		config cfg;
+		uint32_t region_count;
+		uint64_t tick_count = 0;
+		uint64_t rng_state;
+
+		/// occupancy[cell] = owning snake id + 1, 0 when empty
+		std::vector<uint32_t> occupancy;
+		std::vector<uint8_t> food_at;
+		std::vector<uint32_t> claims;
+
+		/// snake bodies live in one pool, `max_length` ring slots per snake
+		std::vector<uint32_t> bodies;
+		std::vector<uint32_t> head_slot;
+		std::vector<uint32_t> length;
+		std::vector<direction> heading;
+		std::vector<uint8_t> alive;
+		std::vector<uint32_t> score;
+
+		/// per-tick scratch
+		std::vector<uint32_t> next_cell;
+		std::vector<uint8_t> grows;
+		std::vector<uint8_t> dies;
+		std::vector<uint8_t> ate;
+		std::vector<uint32_t> bucket_start;
+		std::vector<uint32_t> bucket_fill;
+		std::vector<uint32_t> bucket_ids;
+
+		uint32_t& body_at(uint32_t id, uint32_t from_head) {
+			return bodies[size_t(id) * cfg.max_length + (head_slot[id] + cfg.max_length - from_head) % cfg.max_length];
+		}
+		uint32_t head_of(uint32_t id) const { return bodies[size_t(id) * cfg.max_length + head_slot[id]]; }
+		uint32_t tail_of(uint32_t id) const {
+			return bodies[size_t(id) * cfg.max_length + (head_slot[id] + cfg.max_length - (length[id] - 1)) % cfg.max_length];
+		}
+
+		static uint64_t mix(uint64_t x) {
+			x += 0x9E3779B97F4A7C15ull;
+			x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+			x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+			return x ^ (x >> 31);
+		}
+		uint64_t next_random() { return mix(rng_state++); }
+
+		uint32_t step(uint32_t cell, direction dir) const {
+			uint32_t x = cell % cfg.width, y = cell / cfg.width;
+			switch (dir) {
+			case direction::up:    return y == 0 ? no_cell : cell - cfg.width;
+			case direction::down:  return y + 1 == cfg.height ? no_cell : cell + cfg.width;
+			case direction::left:  return x == 0 ? no_cell : cell - 1;
+			case direction::right: return x + 1 == cfg.width ? no_cell : cell + 1;
+			}
+			return no_cell;
+		}
+
+		uint32_t random_empty_cell() {
+			uint32_t cells = cfg.width * cfg.height;
+			while (true) {
+				uint32_t cell = uint32_t(next_random() % cells);
+				if (!occupancy[cell] && !food_at[cell]) return cell;
+			}
+		}
+
+		void place_snake(uint32_t id) {
+			uint32_t cell = random_empty_cell();
+			head_slot[id] = 0;
+			length[id] = 1;
+			bodies[size_t(id) * cfg.max_length] = cell;
+			heading[id] = direction(next_random() & 3);
+			alive[id] = 1;
+			occupancy[cell] = id + 1;
+		}
+
+		/*************************************************************************************
+		 * PRIVATE FUNCTION: `plan(uint32_t id)`
+		 *
+		 * Built-in policy: keep going, turn on a per-(snake, tick) hash roll, and prefer
+		 * any free neighbour over a blocked one. Only reads the board.
+		 *************************************************************************************/
+
+		void plan(uint32_t id) {
+			if (!alive[id]) { next_cell[id] = no_cell; return; }
+			uint64_t roll = mix(cfg.seed ^ (uint64_t(id) << 32) ^ tick_count);
+			direction dir = heading[id];
+			if ((roll & 7) == 0) dir = direction((uint8_t(dir) + ((roll & 8) ? 1 : 3)) & 3);
+
+			uint32_t head = head_of(id);
+			const direction order[3] = { dir, direction((uint8_t(dir) + 1) & 3), direction((uint8_t(dir) + 3) & 3) };
+			uint32_t target = step(head, dir);
+			for (direction candidate : order) {
+				uint32_t cell = step(head, candidate);
+				if (cell != no_cell && !occupancy[cell]) { dir = candidate; target = cell; break; }
+			}
+			heading[id] = dir;
+			next_cell[id] = target;
+			grows[id] = target != no_cell && food_at[target] && length[id] < cfg.max_length;
+		}
+
+		bool tail_moves_away(uint32_t owner, uint32_t cell) const {
+			return alive[owner] && !grows[owner] && tail_of(owner) == cell;
+		}
+
+		/// `id` and `owner` trade cells: a length-1 owner whose head is `id`'s target heads for `id`'s head.
+		bool swaps_with(uint32_t id, uint32_t owner, uint32_t cell) const {
+			return head_of(owner) == cell && next_cell[owner] == head_of(id);
+		}
+
+		void resolve_region(uint32_t region) {
+			uint32_t lo = bucket_start[region], hi = bucket_start[region + 1];
+			for (uint32_t i = lo; i < hi; ++i) {
+				uint32_t& claim = claims[next_cell[bucket_ids[i]]];
+				claim = claim == claim_free ? bucket_ids[i] : claim_clash;
+			}
+			for (uint32_t i = lo; i < hi; ++i) {
+				uint32_t id = bucket_ids[i], cell = next_cell[id];
+				uint32_t owner = occupancy[cell];
+				bool blocked = owner && (!tail_moves_away(owner - 1, cell) || swaps_with(id, owner - 1, cell));
+				dies[id] = claims[cell] == claim_clash || blocked;
+			}
+			for (uint32_t i = lo; i < hi; ++i) claims[next_cell[bucket_ids[i]]] = claim_free;
+		}
+
+	public:
+		/*********************************************************************
+		 * CONSTRUCTOR: `arena(const config& cfg_)`
+		 *
+		 * Allocates the board and places food, then snakes, from `cfg_.seed`.
+		 *********************************************************************/
+
+		explicit arena(const config& cfg_) : cfg(cfg_), rng_state(cfg_.seed) {
+			if (cfg.region_rows == 0) cfg.region_rows = 1;
+			if (cfg.max_length == 0) cfg.max_length = 1;
+			region_count = (cfg.height + cfg.region_rows - 1) / cfg.region_rows;
+			size_t cells = size_t(cfg.width) * cfg.height;
+
+			occupancy.assign(cells, 0);
+			food_at.assign(cells, 0);
+			claims.assign(cells, claim_free);
+
+			bodies.assign(size_t(cfg.snakes) * cfg.max_length, 0);
+			head_slot.assign(cfg.snakes, 0);
+			length.assign(cfg.snakes, 0);
+			heading.assign(cfg.snakes, direction::up);
+			alive.assign(cfg.snakes, 0);
+			score.assign(cfg.snakes, 0);
+
+			next_cell.assign(cfg.snakes, no_cell);
+			grows.assign(cfg.snakes, 0);
+			dies.assign(cfg.snakes, 0);
+			ate.assign(cfg.snakes, 0);
+			bucket_start.assign(region_count + 1, 0);
+			bucket_ids.assign(cfg.snakes, 0);
+
+			for (uint32_t i = 0; i < cfg.food; ++i) food_at[random_empty_cell()] = 1;
+			for (uint32_t id = 0; id < cfg.snakes; ++id) place_snake(id);
+		}
+
+		/*************************************************************************************
+		 * TICK FUNCTION: `tick(thread_pool& pool)`
+		 *
+		 * Advances every snake by one cell. See the class comment for the phases.
+		 *************************************************************************************/
+
+		void tick(thread_pool& pool) {
+			const uint32_t n = cfg.snakes;
+			const size_t grain = 256;
+
+			pool.parallel_for(0, n, grain, [&](size_t lo, size_t hi) {
+				for (size_t id = lo; id < hi; ++id) plan(uint32_t(id));
+			});
+
+			std::fill(bucket_start.begin(), bucket_start.end(), 0);
+			for (uint32_t id = 0; id < n; ++id) {
+				dies[id] = alive[id] && next_cell[id] == no_cell;
+				if (alive[id] && next_cell[id] != no_cell) ++bucket_start[next_cell[id] / cfg.width / cfg.region_rows + 1];
+			}
+			for (uint32_t r = 0; r < region_count; ++r) bucket_start[r + 1] += bucket_start[r];
+			bucket_fill.assign(bucket_start.begin(), bucket_start.end() - 1);
+			for (uint32_t id = 0; id < n; ++id)
+				if (alive[id] && next_cell[id] != no_cell) bucket_ids[bucket_fill[next_cell[id] / cfg.width / cfg.region_rows]++] = id;
+
+			pool.parallel_for(0, region_count, 1, [&](size_t lo, size_t hi) {
+				for (size_t r = lo; r < hi; ++r) resolve_region(uint32_t(r));
+			});
+
+			pool.parallel_for(0, n, grain, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) {
+					uint32_t id = uint32_t(i);
+					if (!alive[id] || !dies[id]) continue;
+					for (uint32_t k = 0; k < length[id]; ++k) occupancy[body_at(id, k)] = 0;
+				}
+			});
+			pool.parallel_for(0, n, grain, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) {
+					uint32_t id = uint32_t(i);
+					if (!alive[id] || dies[id] || grows[id]) continue;
+					uint32_t tail = tail_of(id);
+					if (occupancy[tail] == id + 1) occupancy[tail] = 0;
+					--length[id];
+				}
+			});
+			pool.parallel_for(0, n, grain, [&](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) {
+					uint32_t id = uint32_t(i);
+					ate[id] = 0;
+					if (!alive[id]) continue;
+					if (dies[id]) { alive[id] = 0; continue; }
+					uint32_t cell = next_cell[id];
+					head_slot[id] = (head_slot[id] + 1) % cfg.max_length;
+					bodies[size_t(id) * cfg.max_length + head_slot[id]] = cell;
+					++length[id];
+					occupancy[cell] = id + 1;
+					if (food_at[cell]) { food_at[cell] = 0; ate[id] = 1; ++score[id]; }
+				}
+			});
+
+			for (uint32_t id = 0; id < n; ++id)
+				if (ate[id]) food_at[random_empty_cell()] = 1;
+			for (uint32_t id = 0; id < n; ++id)
+				if (!alive[id]) place_snake(id);
+
+			++tick_count;
+		}
+
+		uint64_t get_tick() const { return tick_count; }
+		uint32_t get_snake_count() const { return cfg.snakes; }
+		uint32_t get_region_count() const { return region_count; }
+		uint32_t get_length(uint32_t id) const { return length[id]; }
+		uint32_t get_score(uint32_t id) const { return score[id]; }
+
+		/*********************************************************************
+		 * CHECKSUM FUNCTION: `checksum()`
+		 *
+		 * FNV-1a over the board, food and snake state. O(board); meant for
+		 * determinism checks, not for the tick loop.
+		 *********************************************************************/
+
+		uint64_t checksum() const {
+			uint64_t h = 0xCBF29CE484222325ull;
+			auto feed = [&](uint64_t v) { h = (h ^ v) * 0x100000001B3ull; };
+			for (size_t c = 0; c < occupancy.size(); ++c) feed(occupancy[c] | (uint64_t(food_at[c]) << 32));
+			for (uint32_t id = 0; id < cfg.snakes; ++id) feed(head_of(id) ^ (uint64_t(length[id]) << 32) ^ (uint64_t(score[id]) << 48));
+			return h;
+		}
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/threading/ThreadPool.hpp"
+
+namespace snake {
+	/// Called once per tick from a worker thread; must be thread-safe.
+	using policy = std::function<sf::Keyboard::Scancode(const SnakeGame&)>;
+
+	struct game_result {
+		std::uint32_t seed = 0;
+		unsigned int score = 0;
+		size_t length = 0;
+		std::uint64_t ticks = 0;
+		std::uint64_t checksum = 0; ///< FNV-1a over `SnakeGame::saveState()` of the final state
+		bool finished = false; ///< false when the game was cut off by `max_ticks`/`stall_ticks`
+	};
+
+	struct batch_report {
+		std::vector<game_result> games;
+		std::uint64_t total_ticks = 0;
+		double seconds = 0;
+		size_t threads = 0;
+
+		double games_per_second() const { return seconds > 0 ? games.size() / seconds : 0; }
+		double ticks_per_second() const { return seconds > 0 ? total_ticks / seconds : 0; }
+	};
+
+	/*************************************************************************************
+	 * PLAY FUNCTION: `play_headless(std::uint32_t seed, const policy& pick, ...)`
+	 *
+	 * Plays one seeded game without a window: asks `pick` for a direction, then
+	 * calls `SnakeGame::tick()` until the game is over. A game that runs past
+	 * `max_ticks`, or `stall_ticks` without eating, is stopped and marked unfinished.
+	 *************************************************************************************/
+
+	inline game_result play_headless(std::uint32_t seed, const policy& pick, std::uint64_t max_ticks, std::uint64_t stall_ticks) {
+		SnakeGame game(seed);
+		game_result result;
+		result.seed = seed;
+
+		std::uint64_t last_meal = 0;
+		unsigned int last_score = 0;
+		while (game.getTicks() < max_ticks && game.getTicks() - last_meal < stall_ticks) {
+			game.move(pick(game));
+			if (!game.tick()) { result.finished = true; break; }
+			if (game.getScore() != last_score) { last_score = game.getScore(); last_meal = game.getTicks(); }
+		}
+
+		result.score = game.getScore();
+		result.length = game.getLength();
+		result.ticks = game.getTicks();
+		result.checksum = 0xCBF29CE484222325ull;
+		for (unsigned char byte : game.saveState()) result.checksum = (result.checksum ^ byte) * 0x100000001B3ull;
+		return result;
+	}
+
+	/*************************************************************************************
+	 * BATCH FUNCTION: `run_batch(thread_pool& pool, seeds, pick, ...)`
+	 *
+	 * Plays one game per seed on `pool` and returns per-game results (in seed order)
+	 * plus aggregate throughput. Games are handed out in small chunks so that idle
+	 * workers steal the remaining long games.
+	 *************************************************************************************/
+
+	inline batch_report run_batch(thread_pool& pool, const std::vector<std::uint32_t>& seeds, const policy& pick,
+		std::uint64_t max_ticks = 1000000, std::uint64_t stall_ticks = 20000) {
+		batch_report report;
+		report.games.resize(seeds.size());
+		report.threads = pool.get_thread_count();
+
+		auto start = std::chrono::steady_clock::now();
+		pool.parallel_for(0, seeds.size(), 4, [&](size_t lo, size_t hi) {
+			for (size_t i = lo; i < hi; ++i) report.games[i] = play_headless(seeds[i], pick, max_ticks, stall_ticks);
+		});
+		report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (const auto& game : report.games) report.total_ticks += game.ticks;
+		return report;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "SnakeNamespace/arena/Arena.hpp"
+#include "SnakeNamespace/threading/ThreadPool.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_arena_benchmark(std::ostream& out)`
+	 *
+	 * Ticks the same seeded arena with 1, 2, 4 ... N threads and prints ticks/second,
+	 * speedup over one thread and the final checksum. All checksums must match,
+	 * otherwise the tick is not deterministic and the function returns false.
+	 *************************************************************************************/
+
+	inline bool run_arena_benchmark(std::ostream& out, arena::config cfg = {}, uint32_t ticks = 500) {
+		using clock = std::chrono::steady_clock;
+		size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+		std::vector<size_t> thread_counts;
+		for (size_t t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+		thread_counts.push_back(max_threads);
+
+		out << "arena " << cfg.width << "x" << cfg.height << ", " << cfg.snakes << " snakes, "
+			<< cfg.food << " food, " << ticks << " ticks\n";
+		out << std::setw(8) << "threads" << std::setw(14) << "ticks/s" << std::setw(10) << "speedup" << "  checksum\n";
+
+		double base_rate = 0;
+		uint64_t reference = 0;
+		bool deterministic = true;
+		for (size_t threads : thread_counts) {
+			thread_pool pool(threads);
+			arena board(cfg);
+			for (int i = 0; i < 20; ++i) board.tick(pool);
+
+			auto start = clock::now();
+			for (uint32_t i = 0; i < ticks; ++i) board.tick(pool);
+			double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+			double rate = ticks / seconds;
+			if (base_rate == 0) base_rate = rate;
+			uint64_t sum = board.checksum();
+			if (threads == 1) reference = sum;
+			deterministic = deterministic && sum == reference;
+
+			out << std::setw(8) << threads << std::setw(14) << std::fixed << std::setprecision(1) << rate
+				<< std::setw(9) << std::setprecision(2) << rate / base_rate << "x  "
+				<< std::hex << sum << std::dec << "\n";
+		}
+		out << "deterministic across thread counts: " << (deterministic ? "yes" : "NO") << std::endl;
+		return deterministic;
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bots/Autopilot.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_autopilot_benchmark(std::ostream& out, size_t games)`
+	 *
+	 * Times every `autopilot::decide()` call and groups the samples by snake length:
+	 * first over `games` seeded autopilot games, then over games started from long
+	 * serpentine bodies (up to 4790 of the 4800 cells) so the top bands are covered too.
+	 * Returns false if the autopilot's body model ever differs from the game's.
+	 *************************************************************************************/
+
+	inline bool run_autopilot_benchmark(std::ostream& out, size_t games = 3) {
+		using clock = std::chrono::steady_clock;
+		const size_t band_edges[] = { 100, 500, 1000, 2000, 3000, 4000, 4800 };
+		const size_t band_count = sizeof(band_edges) / sizeof(band_edges[0]);
+		auto band_of = [&](size_t length) {
+			size_t b = 0;
+			while (b + 1 < band_count && length > band_edges[b]) ++b;
+			return b;
+		};
+		auto band_name = [&](size_t b) {
+			return std::to_string(b ? band_edges[b - 1] + 1 : 1) + "-" + std::to_string(band_edges[b]);
+		};
+
+		std::vector<latency_histogram> bands(band_count);
+		latency_histogram all;
+		bool in_sync = true;
+		auto timed_tick = [&](SnakeGame& game, autopilot& pilot) {
+			auto start = clock::now();
+			sf::Keyboard::Scancode key = pilot.decide(game);
+			double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+			bands[band_of(game.getLength())].add(ns);
+			all.add(ns);
+			in_sync = in_sync && pilot.matches(game);
+			game.move(key);
+			return game.tick();
+		};
+
+		double score_sum = 0;
+		size_t longest = 0;
+		std::uint64_t rebuilds = 0, patches = 0;
+		for (size_t i = 0; i < games; ++i) {
+			SnakeGame game{ std::uint32_t(i) };
+			autopilot pilot;
+			while (game.getTicks() < 150000 && timed_tick(game, pilot)) {}
+			score_sum += game.getScore();
+			longest = std::max(longest, game.getLength());
+			rebuilds += pilot.get_rebuilds();
+			patches += pilot.get_patches();
+		}
+
+		for (size_t length : { size_t(1000), size_t(2000), size_t(3000), size_t(4000), size_t(4700), size_t(4790) }) {
+			SnakeGame game;
+			game.restore(serpentine_snapshot(length, std::uint32_t(length)));
+			autopilot pilot;
+			for (int t = 0; t < 400 && timed_tick(game, pilot); ++t) {}
+		}
+
+		out << games << " autopilot games: mean score " << std::fixed << std::setprecision(1) << score_sum / games
+			<< ", longest snake " << longest << ", " << rebuilds << " full rebuilds, " << patches << " incremental patches\n";
+		out << "decision latency by snake length (includes long synthetic starts):\n";
+		latency_histogram::print_header(out, "length");
+		for (size_t b = 0; b < band_count; ++b)
+			if (bands[b].count()) bands[b].print_row(out, band_name(b));
+		all.print_row(out, "all");
+		out << "histogram (all decisions):\n";
+		all.print_buckets(out);
+		out << "body model in sync with the game on every decision: " << (in_sync ? "yes" : "NO") << std::endl;
+		return in_sync;
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "SnakeNamespace/batch/BatchRunner.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_batch_benchmark(std::ostream& out, size_t games)`
+	 *
+	 * Plays `games` seeded greedy games with 1, 2, 4 ... N threads and prints games/s,
+	 * ticks/s and speedup. Returns false if any thread count produced different results:
+	 * every game's score, ticks and final state checksum must match the first run's.
+	 *************************************************************************************/
+
+	inline bool run_batch_benchmark(std::ostream& out, size_t games = 2000) {
+		size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+		std::vector<size_t> thread_counts;
+		for (size_t t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+		thread_counts.push_back(max_threads);
+
+		std::vector<std::uint32_t> seeds(games);
+		for (size_t i = 0; i < games; ++i) seeds[i] = std::uint32_t(i);
+
+		out << "batch of " << games << " greedy games\n";
+		out << std::setw(8) << "threads" << std::setw(12) << "games/s" << std::setw(14) << "ticks/s"
+			<< std::setw(10) << "speedup" << std::setw(12) << "mean score\n";
+
+		double base_rate = 0;
+		std::vector<game_result> reference;
+		bool consistent = true;
+		for (size_t threads : thread_counts) {
+			thread_pool pool(threads);
+			batch_report report = run_batch(pool, seeds, greedy_policy);
+
+			double score_sum = 0;
+			for (const auto& game : report.games) score_sum += game.score;
+			if (base_rate == 0) { base_rate = report.ticks_per_second(); reference = report.games; }
+			for (size_t i = 0; i < games; ++i) {
+				const game_result& a = report.games[i];
+				const game_result& b = reference[i];
+				consistent = consistent && a.score == b.score && a.ticks == b.ticks && a.checksum == b.checksum;
+			}
+
+			out << std::setw(8) << threads << std::fixed << std::setprecision(1)
+				<< std::setw(12) << report.games_per_second() << std::setw(14) << report.ticks_per_second()
+				<< std::setw(9) << std::setprecision(2) << report.ticks_per_second() / base_rate << "x"
+				<< std::setw(11) << std::setprecision(1) << score_sum / games << "\n";
+		}
+		out << "identical results across thread counts: " << (consistent ? "yes" : "NO") << std::endl;
+		return consistent;
+	}
+}
@@ -0,0 +1,178 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include "SnakeGame.hpp"
+
+// The commit the binary was built from, for benchmark output; the build passes it in,
+// e.g. -DSNAKE_GIT_COMMIT="\"$(git rev-parse --short HEAD)\"" or from a pre-build step.
+#ifndef SNAKE_GIT_COMMIT
+#define SNAKE_GIT_COMMIT "unknown"
+#endif
+
+namespace snake {
+	/// What a benchmark result was measured with, so results can be tied to a version.
+	struct build_info {
+		const char* type;          ///< "release" with NDEBUG, else "debug"
+		std::string compiler;
+		const char* commit;        ///< `SNAKE_GIT_COMMIT`
+		bool vector_stats;         ///< `raw::vector` statistics compiled in; they cost time on every growth
+	};
+
+	inline build_info current_build() {
+		build_info info;
+#ifdef NDEBUG
+		info.type = "release";
+#else
+		info.type = "debug";
+#endif
+#if defined(_MSC_FULL_VER) && !defined(__clang__)
+		info.compiler = "MSVC " + std::to_string(_MSC_FULL_VER);
+#elif defined(__clang__)
+		info.compiler = std::string("Clang ") + __clang_version__;
+#elif defined(__GNUC__)
+		info.compiler = std::string("GCC ") + __VERSION__;
+#else
+		info.compiler = "unknown";
+#endif
+		info.commit = SNAKE_GIT_COMMIT;
+		info.vector_stats = raw::vector_stats_enabled;
+		return info;
+	}
+
+	/// How `serpentine_snapshot()` lays the body out.
+	enum class fill_pattern {
+		rows,   ///< every row in turn from the top: a compact block over the top of the board
+		comb,   ///< every other row, joined by one cell at alternating ends: spread over the whole board, 2429 cells at most
+	};
+
+	inline const char* fill_pattern_name(fill_pattern pattern) {
+		return pattern == fill_pattern::rows ? "rows" : "comb";
+	}
+
+	/// Most segments `pattern` can lay out.
+	inline size_t fill_pattern_capacity(fill_pattern pattern) {
+		return pattern == fill_pattern::rows ? size_t(SnakeGame::boardWidth * SnakeGame::boardHeight)
+			: size_t(SnakeGame::boardWidth * ((SnakeGame::boardHeight + 1) / 2) + (SnakeGame::boardHeight + 1) / 2 - 1);
+	}
+
+	/*************************************************************************************
+	 * HELPER: `serpentine_snapshot(size_t length, std::uint32_t seed, fill_pattern pattern)`
+	 *
+	 * Returns a game state whose body is `length` segments laid out boustrophedon from the
+	 * top-left corner, head last-placed and facing along the path. `length` may be the
+	 * full 4800-cell board (`fill_pattern::rows` only). `Game` picks the engine type of
+	 * the snapshot.
+	 *************************************************************************************/
+
+	template <typename Game = SnakeGame>
+	typename Game::Snapshot serpentine_snapshot(size_t length, std::uint32_t seed, fill_pattern pattern = fill_pattern::rows) {
+		typename Game::Snapshot snap{ {}, {}, {}, sf::Keyboard::Scancode::D, sf::Keyboard::Scancode::D, typename Game::rng_type(seed), 0, 0 };
+		const float cell = float(SnakeGame::cellSize);
+		const size_t row_stride = pattern == fill_pattern::rows ? 1 : 2;
+		for (size_t row = 0, lane = 0; snap.body.size() < length && row < size_t(SnakeGame::boardHeight); row += row_stride, ++lane) {
+			for (size_t i = 0; i < size_t(SnakeGame::boardWidth) && snap.body.size() < length; ++i) {
+				size_t col = lane % 2 ? SnakeGame::boardWidth - 1 - i : i;
+				snap.body.push_back({ col * cell, row * cell });
+			}
+			// the comb's link down to its next row, at the end the row finished on
+			if (row_stride == 2 && snap.body.size() < length)
+				snap.body.push_back({ snap.body.back().x, (row + 1) * cell });
+		}
+		std::reverse(snap.body.begin(), snap.body.end());
+		snap.prevCoords = snap.body.size() > 1 ? snap.body[1] : snap.body[0];
+		if (snap.body.size() > 1) {
+			sf::Vector2f step = snap.body[0] - snap.body[1];
+			snap.prevMove = step.y > 0 ? sf::Keyboard::Scancode::S : step.x < 0 ? sf::Keyboard::Scancode::A : sf::Keyboard::Scancode::D;
+			snap.currMove = snap.prevMove;
+		}
+		snap.foodCoords = length < size_t(SnakeGame::boardWidth * SnakeGame::boardHeight)
+			? sf::Vector2f{ (SnakeGame::boardWidth - 1) * cell, (SnakeGame::boardHeight - 1) * cell } : sf::Vector2f{};
+		snap.score = unsigned(length - 1);
+		return snap;
+	}
+
+	/*
+	 * @brief Log2-bucketed latency histogram for the benchmarks.
+	 *
+	 * Bucket `b` counts samples in [2^b, 2^(b+1)) nanoseconds. Percentiles are reported as the
+	 * upper edge of the bucket they fall into (so at most 2x pessimistic); `max` is exact.
+	 */
+	class latency_histogram {
+	private:
+		static constexpr int bucket_count = 48;
+		std::uint64_t buckets[bucket_count] = {};
+		std::uint64_t samples = 0;
+		double max_ns = 0;
+		double total_ns = 0;
+
+	public:
+		void add(double ns) {
+			int bucket = 0;
+			for (double edge = 2; edge <= ns && bucket + 1 < bucket_count; edge *= 2) ++bucket;
+			++buckets[bucket];
+			++samples;
+			total_ns += ns;
+			max_ns = std::max(max_ns, ns);
+		}
+
+		std::uint64_t count() const { return samples; }
+		double max() const { return max_ns; }
+		double mean() const { return samples ? total_ns / samples : 0; }
+
+		double percentile(double p) const {
+			std::uint64_t rank = std::uint64_t(p / 100.0 * (samples ? samples - 1 : 0));
+			std::uint64_t seen = 0;
+			for (int b = 0; b < bucket_count; ++b) {
+				seen += buckets[b];
+				if (seen > rank) return std::min(max_ns, double(std::uint64_t(2) << b));
+			}
+			return max_ns;
+		}
+
+		/// One line: `label  n  mean  p50  p99  max` in microseconds.
+		void print_row(std::ostream& out, const std::string& label) const {
+			out << std::setw(14) << label << std::setw(10) << samples << std::fixed << std::setprecision(2)
+				<< std::setw(10) << mean() / 1000 << std::setw(10) << percentile(50) / 1000
+				<< std::setw(10) << percentile(99) / 1000 << std::setw(10) << max() / 1000 << "\n";
+		}
+
+		static void print_header(std::ostream& out, const std::string& label) {
+			out << std::setw(14) << label << std::setw(10) << "samples" << std::setw(10) << "mean us"
+				<< std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "max us" << "\n";
+		}
+
+		/// Bucket counts, one `[lo, hi) us  count` line per non-empty bucket.
+		void print_buckets(std::ostream& out) const {
+			for (int b = 0; b < bucket_count; ++b) {
+				if (!buckets[b]) continue;
+				out << "    [" << std::setw(9) << std::setprecision(3) << (b ? double(std::uint64_t(1) << b) : 0.0) / 1000
+					<< ", " << std::setw(9) << double(std::uint64_t(2) << b) / 1000 << ") us " << std::setw(10) << buckets[b] << "\n";
+			}
+		}
+	};
+
+	/// Best of 5 runs of `op`, in ns per call, batched to about 20 ms a run.
+	template <typename Op>
+	double best_ns_per_call(Op&& op) {
+		using clock = std::chrono::steady_clock;
+		size_t batch = 1;
+		for (;;) {
+			auto start = clock::now();
+			for (size_t i = 0; i < batch; ++i) op();
+			if (std::chrono::duration<double>(clock::now() - start).count() > 0.02) break;
+			batch *= 2;
+		}
+		double best = 1e300;
+		for (int run = 0; run < 5; ++run) {
+			auto start = clock::now();
+			for (size_t i = 0; i < batch; ++i) op();
+			best = std::min(best, std::chrono::duration<double, std::nano>(clock::now() - start).count() / batch);
+		}
+		return best;
+	}
+}
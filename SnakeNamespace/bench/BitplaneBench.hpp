@@ -0,0 +1,185 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+#include "SnakeNamespace/env/BitplaneEncoder.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+
+namespace snake {
+	namespace detail {
+		/// The planes of `bitplane_encoder` the way they were built before it: a board of bytes filled segment by segment, then windowed cell by cell.
+		inline void naive_bitplanes(const SnakeGame& game, const bitplane_window& window, std::vector<std::uint8_t>& board, std::uint8_t* out) {
+			const int width = SnakeGame::boardWidth, height = SnakeGame::boardHeight;
+			const size_t cells = size_t(width) * height;
+			board.assign(bitplane_encoder::plane_count * cells, 0);
+			auto set_direction = [&](int cell, std::uint8_t direction) {
+				board[bitplane_encoder::direction_low * cells + cell] = direction & 1;
+				board[bitplane_encoder::direction_high * cells + cell] = direction >> 1;
+			};
+			const auto& body = game.getBody();
+			for (size_t i = 0; i < body.get_size(); ++i) {
+				int cell = SnakeGame::cellIndex(body[i].coords);
+				if (cell < 0) continue;
+				board[bitplane_encoder::occupancy * cells + cell] = 1;
+				if (i == 0 || body[i].coords == body[i - 1].coords) continue;
+				sf::Vector2f step = body[i - 1].coords - body[i].coords;
+				set_direction(cell, step.y < 0 ? 0 : step.x > 0 ? 1 : step.y > 0 ? 2 : 3);
+			}
+			int head = SnakeGame::cellIndex(game.getHead()), food = SnakeGame::cellIndex(game.getFood());
+			if (head >= 0) {
+				board[bitplane_encoder::head * cells + head] = 1;
+				set_direction(head, direction_index(game.getDirection()));
+			}
+			if (food >= 0) board[bitplane_encoder::food * cells + food] = 1;
+
+			int x0 = 0, y0 = 0;
+			if (window.egocentric) {
+				x0 = SnakeGame::cellOf(game.getHead()).x - window.width / 2;
+				y0 = SnakeGame::cellOf(game.getHead()).y - window.height / 2;
+			}
+			for (int p = 0; p < bitplane_encoder::plane_count; ++p)
+				for (int y = 0; y < window.height; ++y)
+					for (int x = 0; x < window.width; ++x) {
+						int bx = x0 + x, by = y0 + y;
+						bool inside = bx >= 0 && by >= 0 && bx < width && by < height;
+						*out++ = inside ? board[p * cells + size_t(by) * width + bx] : std::uint8_t(p == bitplane_encoder::occupancy);
+					}
+		}
+
+		/// `count` 0/1 bytes per plane packed the way `encode_packed()` packs them.
+		inline std::vector<std::uint8_t> pack_bitplanes(const std::uint8_t* bytes, const bitplane_window& window) {
+			const size_t plane_bytes = bitplane_encoder::packed_plane_size(window);
+			std::vector<std::uint8_t> packed(bitplane_encoder::packed_size(window), 0);
+			for (size_t p = 0; p < bitplane_encoder::plane_count; ++p)
+				for (size_t i = 0; i < window.cells(); ++i)
+					packed[p * plane_bytes + i / 8] |= std::uint8_t(bytes[p * window.cells() + i] << (i % 8));
+			return packed;
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_bitplane_benchmark(std::ostream& out)`
+	 *
+	 * First checks `bitplane_encoder` against `detail::naive_bitplanes()` over greedy
+	 * games: the incrementally updated planes after every tick, and every window and SIMD
+	 * level, packed and as bytes, on every 37th. Then times, per window (the whole 80x60
+	 * board, and 81, 41, 21 and 11 cells square around the head), emitting bytes at each
+	 * level the CPU has and packed bits, next to the naive per-cell encoder; then keeping
+	 * the planes: `update()` per tick of a greedy game and `rebuild()` by snake length.
+	 *************************************************************************************/
+
+	inline bool run_bitplane_benchmark(std::ostream& out) {
+		const simd_level best = detect_simd_level();
+		std::vector<simd_level> levels{ simd_level::scalar };
+		if (best >= simd_level::sse2) levels.push_back(simd_level::sse2);
+		if (best >= simd_level::avx2) levels.push_back(simd_level::avx2);
+		const bitplane_window windows[] = { {}, bitplane_window::around_head(40), bitplane_window::around_head(20), bitplane_window::around_head(10), bitplane_window::around_head(5) };
+		// the 81x81 window covers the whole board wherever the head is, and is the largest output
+		std::vector<std::uint8_t> board, expected(bitplane_encoder::bytes_size(windows[1])), actual(expected.size());
+		out << "CPU supports " << simd_level_name(best) << "\n";
+
+		// a game per seed until 60000 ticks have been checked
+		bool match = true;
+		std::uint64_t checked = 0;
+		bitplane_encoder encoder;
+		for (std::uint32_t seed = 1; checked < 60000; ++seed) {
+			SnakeGame game{ seed };
+			encoder.update(game);
+			for (bool alive = true; alive && checked < 60000; ++checked) {
+				game.move(greedy_policy(game));
+				alive = game.tick() && !game.checkCollision();
+				encoder.update(game);
+				detail::naive_bitplanes(game, {}, board, expected.data());
+				encoder.encode_bytes(actual.data());
+				match = match && std::equal(actual.begin(), actual.begin() + bitplane_encoder::bytes_size(), expected.begin());
+				if (checked % 37) continue;
+				for (const bitplane_window& window : windows) {
+					detail::naive_bitplanes(game, window, board, expected.data());
+					for (simd_level level : levels) {
+						encoder.set_simd_level(level);
+						encoder.encode_bytes(actual.data(), window);
+						match = match && std::equal(actual.begin(), actual.begin() + bitplane_encoder::bytes_size(window), expected.begin());
+					}
+					std::vector<std::uint8_t> packed(bitplane_encoder::packed_size(window));
+					encoder.encode_packed(packed.data(), window);
+					match = match && packed == detail::pack_bitplanes(expected.data(), window);
+				}
+				encoder.set_simd_level(best);
+			}
+		}
+		out << "planes match the per-cell encoder over " << checked << " ticks (every window, level and output on every 37th): " << (match ? "yes" : "NO") << "\n\n";
+
+		// a mid-game state for emission, whose cost does not depend on the body
+		SnakeGame game{ 7 };
+		game.restore(serpentine_snapshot(1200, 7, fill_pattern::comb));
+		encoder.rebuild(game);
+		volatile std::uint8_t sink = 0;
+		out << "emitting " << bitplane_encoder::plane_count << " planes, ns per observation (Mcells/s over all planes)\n";
+		out << std::setw(10) << "window" << std::setw(22) << "per-cell (naive)";
+		for (simd_level level : levels) out << std::setw(20) << (std::string("bytes ") + simd_level_name(level));
+		out << std::setw(20) << "packed" << "\n";
+		for (const bitplane_window& window : windows) {
+			const double cells = double(bitplane_encoder::plane_count) * window.cells();
+			auto cell = [&](double ns) {
+				std::ostringstream text;
+				text << std::fixed << std::setprecision(0) << ns << " (" << cells / ns * 1e3 << ")";
+				return text.str();
+			};
+			std::ostringstream name;
+			name << window.width << "x" << window.height;
+			out << std::setw(10) << name.str();
+			out << std::setw(22) << cell(best_ns_per_call([&] {
+				detail::naive_bitplanes(game, window, board, actual.data());
+				sink = sink + actual[0];
+			}));
+			for (simd_level level : levels) {
+				encoder.set_simd_level(level);
+				out << std::setw(20) << cell(best_ns_per_call([&] {
+					encoder.encode_bytes(actual.data(), window);
+					sink = sink + actual[0];
+				}));
+			}
+			out << std::setw(20) << cell(best_ns_per_call([&] {
+				encoder.encode_packed(actual.data(), window);
+				sink = sink + actual[0];
+			}));
+			out << "\n";
+		}
+		encoder.set_simd_level(best);
+
+		// consecutive states of one greedy game, so every update() but the first is incremental
+		std::vector<SnakeGame> states(1, SnakeGame{ 11 });
+		while (states.size() < 4096) {
+			SnakeGame next = states.back();
+			next.move(greedy_policy(next));
+			if (!next.tick() || next.checkCollision()) break;
+			states.push_back(next);
+		}
+		double update_ns = best_ns_per_call([&] {
+			encoder.rebuild(states[0]);
+			for (size_t i = 1; i < states.size(); ++i) encoder.update(states[i]);
+		});
+		double rebuild_first_ns = best_ns_per_call([&] { encoder.rebuild(states[0]); });
+		out << "\nupdate() over " << states.size() - 1 << " greedy ticks (length 1 to " << states.back().getLength() << "): " << std::fixed << std::setprecision(1)
+			<< (update_ns - rebuild_first_ns) / (states.size() - 1) << " ns per tick\n";
+		out << std::setw(8) << "length" << std::setw(14) << "rebuild ns" << std::setw(22) << "per-cell 80x60 ns" << "\n";
+		for (size_t length : { size_t(1), size_t(300), size_t(2400), size_t(4800) }) {
+			game.restore(serpentine_snapshot(length, 7));
+			out << std::setw(8) << length << std::setw(14) << std::setprecision(0) << best_ns_per_call([&] { encoder.rebuild(game); })
+				<< std::setw(22) << best_ns_per_call([&] {
+					detail::naive_bitplanes(game, {}, board, actual.data());
+					sink = sink + actual[0];
+				}) << "\n";
+		}
+		out << std::flush;
+		return match;
+	}
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SnakeNamespace/replay/DiffStream.hpp"
+#include "SnakeNamespace/turbo/Turbo.hpp"
+#include "SnakeNamespace/bots/Hamiltonian.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+
+namespace snake {
+	namespace detail {
+		struct diff_stream_run {
+			double ticks_per_second = 0;
+			double writer_ns = 0;           ///< inside `capture()` and `finish()` per tick, with `timed`
+			std::uint64_t ticks = 0, raw_bytes = 0, stored_bytes = 0, writes = 0;
+			bool written = true;
+		};
+
+		/*
+		 * Plays `games` turbo games from seed 1 on, streaming each to `path` (overwritten per game)
+		 * unless `stream` is false. `timed` clocks every call into the writer, which slows the
+		 * run down but shows the writer's own cost apart from the noise between whole runs.
+		 */
+		template <typename Pick>
+		diff_stream_run stream_turbo(const std::string& path, Pick&& pick, std::uint64_t max_ticks, int games, bool stream, bool compress, bool timed = false) {
+			using clock = std::chrono::steady_clock;
+			diff_stream_run run;
+			double seconds = 0, writer_seconds = 0;
+			const auto timer_start = clock::now();
+			for (int i = 0; i < 1000; ++i) clock::now();
+			const double timer_seconds = std::chrono::duration<double>(clock::now() - timer_start).count() / 1000;
+			for (int g = 0; g < games; ++g) {
+				turbo_options options;
+				options.seed = std::uint32_t(g + 1);
+				options.max_ticks = max_ticks;
+				turbo_report report;
+				if (!stream)
+					report = run_turbo(options, pick, nullptr);
+				else {
+					int fd = open_diff_stream(path);
+					if (fd < 0) { run.written = false; return run; }
+					diff_stream_options stream_options;
+					stream_options.compress = compress;
+					SnakeGame first{ options.seed };
+					diff_stream_writer writer(fd, first, stream_options);
+					if (timed)
+						report = run_turbo(options, pick, nullptr, [&](const SnakeGame& game) {
+							auto start = clock::now();
+							writer.capture(game);
+							writer_seconds += std::chrono::duration<double>(clock::now() - start).count() - timer_seconds;
+						});
+					else
+						report = run_turbo(options, pick, nullptr, [&](const SnakeGame& game) { writer.capture(game); });
+					auto start = clock::now();
+					run.written = writer.finish() && run.written;
+					writer_seconds += std::chrono::duration<double>(clock::now() - start).count();
+					close_diff_stream(fd);
+					run.raw_bytes += writer.get_raw_bytes();
+					run.stored_bytes += writer.get_stored_bytes();
+					run.writes += writer.get_writes();
+				}
+				run.ticks += report.ticks;
+				seconds += report.seconds;
+			}
+			run.ticks_per_second = seconds > 0 ? run.ticks / seconds : 0;
+			run.writer_ns = timed && run.ticks ? writer_seconds / run.ticks * 1e9 : 0;
+			return run;
+		}
+
+		/*
+		 * Re-plays game 1 of `pick` next to the stream at `path`: the reader's `step()` is compared
+		 * with the game every 61 ticks and at the end, then 256 random `seek()`s with the boards
+		 * kept along the way. Reports the reader's speed for both.
+		 */
+		template <typename Pick>
+		bool verify_diff_stream(std::ostream& out, const std::string& path, Pick&& pick, std::uint64_t max_ticks) {
+			using clock = std::chrono::steady_clock;
+			diff_stream_reader reader;
+			if (!reader.load(path) || !reader.is_complete()) return false;
+
+			std::vector<std::uint64_t> probes;
+			std::uint64_t probe = 0x9E3779B97F4A7C15ull;
+			for (int i = 0; i < 256; ++i) {
+				probe ^= probe << 13; probe ^= probe >> 7; probe ^= probe << 17;
+				probes.push_back(probe % (reader.get_length() + 1));
+			}
+			std::vector<std::uint64_t> sorted = probes;
+			std::sort(sorted.begin(), sorted.end());
+			std::vector<diff_state> expected;
+
+			SnakeGame game{ 1 };
+			bool match = reader.get_state() == make_diff_state(game);
+			double step_seconds = 0;
+			size_t next = 0;
+			while (game.getTicks() < max_ticks) {
+				game.move(pick(game));
+				if (!game.tick()) break;
+				auto start = clock::now();
+				match = match && reader.step();
+				step_seconds += std::chrono::duration<double>(clock::now() - start).count();
+				for (; next < sorted.size() && sorted[next] == game.getTicks(); ++next) expected.push_back(make_diff_state(game));
+				if (game.getTicks() % 61 == 0) match = match && reader.get_state() == make_diff_state(game);
+			}
+			const diff_outcome outcome = game.isWon() ? diff_outcome::won : game.getTicks() < max_ticks ? diff_outcome::lost : diff_outcome::stopped;
+			match = match && reader.get_state() == make_diff_state(game) && reader.get_tick() == reader.get_length()
+				&& !reader.step() && reader.get_final_score() == game.getScore() && reader.get_outcome() == outcome;
+			if (sorted.front() == 0) expected.insert(expected.begin(), std::count(sorted.begin(), sorted.end(), 0), make_diff_state(SnakeGame{ 1 }));
+
+			auto start = clock::now();
+			for (std::uint64_t tick : probes) {
+				size_t index = size_t(std::lower_bound(sorted.begin(), sorted.end(), tick) - sorted.begin());
+				match = match && reader.seek(tick) && index < expected.size() && reader.get_state() == expected[index];
+			}
+			double seek_seconds = std::chrono::duration<double>(clock::now() - start).count();
+			out << "    reader: " << std::fixed << std::setprecision(0) << reader.get_length() / std::max(step_seconds, 1e-9) << " ticks/s stepping, "
+				<< std::setprecision(1) << seek_seconds / probes.size() * 1e6 << " us per random seek; matches the game: " << (match ? "yes" : "NO") << "\n";
+			return match;
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_diff_stream_benchmark(std::ostream& out)`
+	 *
+	 * Turbo games with and without a `diff_stream_writer` on a file: the Hamiltonian
+	 * bot for 300k ticks (a long snake, slow ticks) and 200 greedy games (short ticks
+	 * and a file opened per game, the harder case for the writer). Reports the best
+	 * ticks/s of three runs, what streaming costs on top (within run-to-run noise on a
+	 * busy machine, so the writer's own time per tick is clocked too), bytes per tick
+	 * raw and run-length coded, and `write()` calls. Then reads the streams back and
+	 * checks every board it rebuilds against the simulation.
+	 *************************************************************************************/
+
+	inline bool run_diff_stream_benchmark(std::ostream& out) {
+		const std::string path = (std::filesystem::temp_directory_path() / "snake_diff_stream_bench.snkd").string();
+		hamiltonian_solver solver;
+		auto hamiltonian = [&](const SnakeGame& g) { return solver.decide(g); };
+		bool ok = true;
+
+		auto workload = [&](const char* name, auto&& pick, std::uint64_t max_ticks, int games) {
+			// best of three, interleaved, so a noisy neighbour does not land on one configuration only
+			detail::diff_stream_run off, raw, packed;
+			auto best = [](detail::diff_stream_run& kept, const detail::diff_stream_run& run) {
+				if (run.ticks_per_second > kept.ticks_per_second || !run.written) kept = run;
+			};
+			for (int repeat = 0; repeat < 3; ++repeat) {
+				best(off, detail::stream_turbo(path, pick, max_ticks, games, false, false));
+				best(raw, detail::stream_turbo(path, pick, max_ticks, games, true, false));
+				best(packed, detail::stream_turbo(path, pick, max_ticks, games, true, true));
+			}
+			out << name << ", " << off.ticks << " ticks\n"
+				<< std::setw(16) << "stream" << std::setw(14) << "ticks/s" << std::setw(10) << "cost" << std::setw(12) << "bytes/tick" << std::setw(9) << "writes" << "\n";
+			auto row = [&](const char* label, const detail::diff_stream_run& run, std::uint64_t bytes) {
+				out << std::setw(16) << label << std::fixed << std::setprecision(0) << std::setw(14) << run.ticks_per_second;
+				if (&run == &off) out << std::setw(10) << "-" << std::setw(12) << "-" << std::setw(9) << "-" << "\n";
+				else
+					out << std::setw(9) << std::setprecision(1) << (off.ticks_per_second / run.ticks_per_second - 1) * 100 << "%"
+						<< std::setw(12) << std::setprecision(3) << double(bytes) / run.ticks << std::setw(9) << run.writes << "\n";
+			};
+			row("none", off, 0);
+			row("raw", raw, raw.stored_bytes);
+			row("run-length", packed, packed.stored_bytes);
+			detail::diff_stream_run raw_timed = detail::stream_turbo(path, pick, max_ticks, games, true, false, true);
+			detail::diff_stream_run packed_timed = detail::stream_turbo(path, pick, max_ticks, games, true, true, true);
+			out << "    writer alone: " << std::setprecision(1) << raw_timed.writer_ns << " ns/tick raw, " << packed_timed.writer_ns
+				<< " ns/tick run-length; a simulated tick takes " << 1e9 / off.ticks_per_second << " ns\n";
+			ok = ok && raw.written && packed.written && raw_timed.written && packed_timed.written && raw.ticks == off.ticks && packed.ticks == off.ticks;
+			// the file now holds the last game; with one game that is seed 1
+			if (games == 1) ok = detail::verify_diff_stream(out, path, pick, max_ticks) && ok;
+		};
+		workload("hamiltonian", hamiltonian, 300000, 1);
+		workload("greedy", greedy_policy, 200000, 200);
+		detail::stream_turbo(path, greedy_policy, 200000, 1, true, true);
+		out << "greedy game 1 read back:\n";
+		ok = detail::verify_diff_stream(out, path, greedy_policy, 200000) && ok;
+
+		std::remove(path.c_str());
+		out << "streams written and reproduced: " << (ok ? "yes" : "NO") << std::endl;
+		return ok;
+	}
+}
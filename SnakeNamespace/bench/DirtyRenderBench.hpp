@@ -0,0 +1,130 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/render/RenderBackend.hpp"
+#include "SnakeNamespace/render/CellVertexBuffer.hpp"
+#include "SnakeNamespace/threading/SimulationThread.hpp"
+
+namespace snake {
+	/// Builds the two-triangle vertex list a full redraw would submit, one quad per rectangle.
+	class vertex_collector : public render_backend {
+	private:
+		std::vector<sf::Vertex> vertices;
+
+	public:
+		const std::vector<sf::Vertex>& get_vertices() const { return vertices; }
+
+		void clear(sf::Color) override { vertices.clear(); }
+
+		void fill_rect(sf::FloatRect rect, sf::Color color) override {
+			sf::Vector2f a = rect.position, b = rect.position + rect.size;
+			for (sf::Vector2f corner : { a, sf::Vector2f{ b.x, a.y }, sf::Vector2f{ a.x, b.y }, sf::Vector2f{ b.x, a.y }, b, sf::Vector2f{ a.x, b.y } })
+				vertices.push_back({ corner, color, {} });
+		}
+
+		void fill_circle(sf::Vector2f, float, sf::Color) override {}
+		void draw_text(const sf::Text&) override {}
+	};
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_dirty_render_benchmark(std::ostream& out)`
+	 *
+	 * Moves snakes of 1, 100, 1000 and 4799 segments (the whole board but the food) around
+	 * a Hamiltonian cycle of the board, one cell per tick, and times what the render thread
+	 * does per tick: rebuilding every segment's quad (`frame::render()` into a vertex list)
+	 * versus `cell_vertex_buffer::sync()`, which patches the cells that changed. Every 16th
+	 * tick the snake grows by one, so the growth path is covered too.
+	 *
+	 * Also times a frame with no new tick (the common case at 60 fps and 10 ticks/s) and
+	 * checks that the patched buffer equals one rebuilt from scratch.
+	 *************************************************************************************/
+
+	inline bool run_dirty_render_benchmark(std::ostream& out) {
+		using clock = std::chrono::steady_clock;
+		const int width = SnakeGame::boardWidth, height = SnakeGame::boardHeight;
+		const float cell = float(SnakeGame::cellSize);
+
+		// row 0 left to right, then the other rows snaking over columns 1.., then up column 0
+		std::vector<sf::Vector2f> cycle;
+		for (int x = 0; x < width; ++x) cycle.push_back({ x * cell, 0 });
+		for (int y = 1; y < height; ++y)
+			for (int i = 1; i < width; ++i) cycle.push_back({ float(y % 2 ? width - i : i) * cell, y * cell });
+		for (int y = height - 1; y >= 1; --y) cycle.push_back({ 0, y * cell });
+		const size_t board = cycle.size();
+
+		out << "per-tick render work, " << width << "x" << height << " board\n";
+		out << std::setw(8) << "length" << std::setw(16) << "rebuild ns" << std::setw(14) << "verts/tick"
+			<< std::setw(16) << "patch ns" << std::setw(14) << "verts/tick" << std::setw(12) << "speedup" << std::setw(14) << "idle ns" << "\n";
+
+		bool identical = true;
+		for (size_t target : { size_t(1), size_t(100), size_t(1000), board - 1 }) {
+			// at tick t the head is on cycle cell t and segment i on cell t - i
+			auto make_frame = [&](frame& f, std::uint64_t tick, size_t length) {
+				f.tick = tick;
+				f.body.resize(length);
+				for (size_t i = 0; i < length; ++i) f.body[i] = cycle[(tick + board - i) % board];
+				f.food = cycle[(tick + 1) % board];
+			};
+			const int ticks = 2000;
+			const size_t start_length = target > 64 ? target - 64 : target;
+
+			// full rebuild of the frame each tick
+			frame f;
+			vertex_collector collector;
+			std::uint64_t rebuild_vertices = 0;
+			double rebuild_ns = 0;
+			size_t length = start_length;
+			for (int t = 0; t < ticks; ++t) {
+				if (t % 16 == 15 && length < target) ++length;
+				make_frame(f, std::uint64_t(t), length);
+				auto start = clock::now();
+				collector.clear(sf::Color::Blue);
+				f.render(collector);
+				rebuild_ns += std::chrono::duration<double, std::nano>(clock::now() - start).count();
+				rebuild_vertices += collector.get_vertices().size();
+			}
+
+			// patched buffer: only the head and tail are read through the accessor
+			cell_vertex_buffer cells;
+			length = start_length;
+			std::uint64_t tick = 0;
+			auto at = [&](size_t i) { return cycle[(tick + board - i) % board]; };
+			cells.sync(tick, length, at, cycle[1]);
+			double patch_ns = 0;
+			std::uint64_t patches_before = cells.get_patches();
+			for (int t = 1; t < ticks; ++t) {
+				if (t % 16 == 15 && length < target) ++length;
+				tick = std::uint64_t(t);
+				auto start = clock::now();
+				cells.sync(tick, length, at, cycle[(tick + 1) % board]);
+				patch_ns += std::chrono::duration<double, std::nano>(clock::now() - start).count();
+			}
+			double patched_vertices = double(cells.get_patches() - patches_before) * 6 / (ticks - 1);
+
+			const int idle_frames = 100000;
+			auto idle_start = clock::now();
+			for (int i = 0; i < idle_frames; ++i) cells.sync(tick, length, at, cycle[(tick + 1) % board]);
+			double idle_ns = std::chrono::duration<double, std::nano>(clock::now() - idle_start).count() / idle_frames;
+
+			cell_vertex_buffer fresh;
+			fresh.sync(tick, length, at, cycle[(tick + 1) % board]);
+			bool same = cells.get_rebuilds() == 1;
+			for (size_t v = 0; same && v < fresh.get_vertices().size(); ++v)
+				same = fresh.get_vertices()[v].color == cells.get_vertices()[v].color;
+			identical = identical && same;
+
+			double rebuild_per_tick = rebuild_ns / ticks, patch_per_tick = patch_ns / (ticks - 1);
+			out << std::setw(8) << length << std::fixed << std::setprecision(1)
+				<< std::setw(16) << rebuild_per_tick << std::setw(14) << double(rebuild_vertices) / ticks
+				<< std::setw(16) << patch_per_tick << std::setw(14) << patched_vertices
+				<< std::setw(11) << rebuild_per_tick / patch_per_tick << "x" << std::setw(14) << idle_ns
+				<< (same ? "" : "  (PATCHED BUFFER DIFFERS)") << "\n";
+		}
+		out << "patched buffer matches a full rebuild: " << (identical ? "yes" : "NO") << std::endl;
+		return identical;
+	}
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "SnakeNamespace/env/SnakeEnvApi.hpp"
+#include "SnakeNamespace/random/Random.hpp"
+
+namespace snake {
+	namespace detail {
+		/// Steps the same batch on the calling thread and on `threads` threads with the same actions: every reward, done flag, observation and finished episode must agree.
+		inline bool check_env_threads(std::ostream& out, std::uint32_t threads, const std::vector<std::uint8_t>& action_pool) {
+			const std::uint32_t n = 256;
+			const size_t obs_size = snake_env_observation_size();
+			snake_env_config config;
+			snake_env_default_config(&config, n);
+			config.seed = 7;
+			config.stall_steps = 500;
+			snake_env* single = snake_env_create(&config);
+			config.threads = threads;
+			snake_env* parallel = snake_env_create(&config);
+			bool same = single && parallel;
+			std::vector<std::uint8_t> observations[2], dones[2];
+			std::vector<float> rewards[2];
+			snake_env* envs[2] = { single, parallel };
+			for (int e = 0; e < 2 && same; ++e) {
+				observations[e].resize(n * obs_size);
+				dones[e].resize(n);
+				rewards[e].resize(n);
+				same = snake_env_bind(envs[e], observations[e].data(), rewards[e].data(), dones[e].data()) == 0;
+			}
+			std::uint64_t calls = 0;
+			for (; same && calls < 2000; ++calls) {
+				const std::uint8_t* actions = action_pool.data() + (calls * 4099) % (action_pool.size() - n);
+				same = snake_env_step(single, actions) == 0 && snake_env_step(parallel, actions) == 0
+					&& dones[0] == dones[1] && rewards[0] == rewards[1] && observations[0] == observations[1];
+			}
+			for (std::uint32_t i = 0; i < n && same; ++i) {
+				snake_env_episode a{}, b{};
+				snake_env_last_episode(single, i, &a);
+				snake_env_last_episode(parallel, i, &b);
+				same = a.number == b.number && a.seed == b.seed && a.score == b.score && a.steps == b.steps && a.done == b.done;
+			}
+			snake_env_destroy(single);
+			snake_env_destroy(parallel);
+			out << n << " games stepped " << calls << " times on 1 and " << threads << " threads end the same: " << (same ? "yes" : "NO") << "\n\n";
+			return same;
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_env_benchmark(std::ostream& out)`
+	 *
+	 * Drives the C API of `SnakeEnv.h` with N = 1, 64 and 4096 games for about a second
+	 * each, with uniformly random actions (so short episodes and many auto-resets).
+	 * Reports env steps/s, `snake_env_step()` calls/s, finished episodes and the mean
+	 * score of those ending on every 256th call, and the heap bytes the game bodies hold
+	 * at the end. At those calls one game's observation (outside the timing), and at the
+	 * end all of them, are compared with `batch_env::write_observation()` of its game.
+	 * First runs `detail::check_env_threads()` with 4 threads.
+	 *************************************************************************************/
+
+	inline bool run_env_benchmark(std::ostream& out) {
+		using clock = std::chrono::steady_clock;
+		const size_t obs_size = snake_env_observation_size();
+		std::vector<std::uint8_t> action_pool(1 << 16);
+		xoshiro256ss rng(3);
+		for (std::uint8_t& action : action_pool) action = std::uint8_t(rng() >> 62);
+		std::vector<std::uint8_t> expected(obs_size);
+		bool ok = detail::check_env_threads(out, 4, action_pool);
+
+		out << std::setw(6) << "N" << std::setw(14) << "env steps/s" << std::setw(12) << "calls/s" << std::setw(12) << "ns/step"
+			<< std::setw(11) << "episodes" << std::setw(12) << "truncated*" << std::setw(12) << "mean score*" << std::setw(12) << "body KB" << std::setw(13) << "obs match" << "\n";
+		for (std::uint32_t n : { 1u, 64u, 4096u }) {
+			snake_env_config config;
+			snake_env_default_config(&config, n);
+			config.seed = 42;
+			config.stall_steps = 500;
+			snake_env* env = snake_env_create(&config);
+			if (!env) {
+				out << "cannot create " << n << " environments" << std::endl;
+				return false;
+			}
+			std::vector<std::uint8_t> observations(n * obs_size), dones(n);
+			std::vector<float> rewards(n);
+			snake_env_bind(env, observations.data(), rewards.data(), dones.data());
+
+			std::uint64_t calls = 0, sampled = 0, truncated = 0, score_sum = 0, episodes = 0;
+			double seconds = 0;
+			bool match = true;
+			while (seconds < 1.0) {
+				auto start = clock::now();
+				for (int i = 0; i < 256; ++i) {
+					snake_env_step(env, action_pool.data() + (calls * 4099) % (action_pool.size() - n));
+					++calls;
+				}
+				seconds += std::chrono::duration<double>(clock::now() - start).count();
+
+				for (std::uint32_t i = 0; i < n; ++i) {
+					if (!dones[i]) continue;
+					snake_env_episode episode{};
+					snake_env_last_episode(env, i, &episode);
+					++sampled;
+					truncated += episode.done == SNAKE_ENV_TRUNCATED;
+					score_sum += episode.score;
+				}
+				size_t probe = size_t(calls / 256 % n);
+				batch_env::write_observation(env->env.get_game(probe), expected.data());
+				match = match && std::memcmp(expected.data(), observations.data() + probe * obs_size, obs_size) == 0;
+			}
+			for (std::uint32_t i = 0; i < n; ++i) {
+				batch_env::write_observation(env->env.get_game(i), expected.data());
+				match = match && std::memcmp(expected.data(), observations.data() + i * obs_size, obs_size) == 0;
+			}
+			const size_t body_bytes = env->env.get_body_bytes();
+			for (std::uint32_t i = 0; i < n; ++i) {
+				snake_env_episode episode{};
+				snake_env_last_episode(env, i, &episode);
+				episodes += episode.number;
+			}
+			snake_env_destroy(env);
+
+			double steps = double(calls) * n;
+			out << std::setw(6) << n << std::fixed << std::setprecision(0) << std::setw(14) << steps / seconds << std::setw(12) << calls / seconds
+				<< std::setw(12) << std::setprecision(1) << seconds / steps * 1e9 << std::setw(11) << episodes << std::setw(12) << truncated
+				<< std::setw(12) << std::setprecision(2) << (sampled ? double(score_sum) / sampled : 0) << std::setw(12) << std::setprecision(1) << body_bytes / 1024.0 << std::setw(13) << (match ? "yes" : "NO") << "\n";
+			ok = ok && match;
+		}
+		out << "* episodes ending on every 256th call; all observations match their games: " << (ok ? "yes" : "NO") << std::endl;
+		return ok;
+	}
+}
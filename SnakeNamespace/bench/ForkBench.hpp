@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+#include "SnakeNamespace/bots/RolloutState.hpp"
+
+namespace snake {
+	namespace detail {
+		/// Forks greedy games along the way and plays original and fork on side by side: they must stay equal, and stepping one must leave the other alone.
+		inline bool check_forks(std::ostream& out, std::uint32_t games) {
+			std::uint64_t forks = 0;
+			bool match = true;
+			SnakeGame pooled{ 0 };
+			for (std::uint32_t seed = 1; seed <= games && match; ++seed) {
+				SnakeGame game{ seed };
+				while (match) {
+					if (game.getTicks() % 50 == 0) {
+						const std::vector<unsigned char> before = game.saveState();
+						SnakeGame fork = game.fork();
+						game.forkInto(pooled);
+						match = fork.saveState() == before && pooled.saveState() == before;
+						// the fork plays 30 ticks ahead; the game must not notice, and must then play the same 30
+						std::vector<std::vector<unsigned char>> ahead;
+						for (int i = 0; i < 30; ++i) {
+							fork.move(greedy_policy(fork));
+							if (!fork.tick()) break;
+							ahead.push_back(fork.saveState());
+						}
+						match = match && game.saveState() == before;
+						pooled.move(greedy_policy(pooled));
+						match = match && (!pooled.tick() || ahead.empty() || pooled.saveState() == ahead[0]);
+						++forks;
+					}
+					game.move(greedy_policy(game));
+					if (!game.tick()) break;
+				}
+			}
+			out << forks << " forks of " << games << " greedy games play on like the original and leave it untouched: " << (match ? "yes" : "NO") << "\n";
+			return match;
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_fork_benchmark(std::ostream& out)`
+	 *
+	 * Checks `SnakeGame::fork()` and `forkInto()` on greedy games, then times, per
+	 * snake length, the ways to branch a game: a copy (the whole reservation),
+	 * `fork()`, `forkInto()` a pooled game, `snapshot()` + `restore()`, and for
+	 * reference `rollout_state::fork()`. Reports forks per second and heap bytes held
+	 * by one branch, and whether `forkInto()` ever reallocated once warm.
+	 *************************************************************************************/
+
+	inline bool run_fork_benchmark(std::ostream& out) {
+		bool ok = detail::check_forks(out, 20);
+		out << "\nforks per second (millions)\n";
+		out << std::setw(8) << "length" << std::setw(12) << "copy" << std::setw(12) << "fork()" << std::setw(12) << "forkInto()" << std::setw(18) << "snapshot+restore"
+			<< std::setw(16) << "rollout_state" << std::setw(14) << "copy bytes" << std::setw(14) << "fork bytes" << "\n";
+		SnakeGame pooled{ 0 };
+		rollout_arena arena(1 << 22), source_arena(1 << 13);
+		bool quiet = true;
+		for (size_t length : { size_t(1), size_t(100), size_t(1000), size_t(2400), size_t(4800) }) {
+			SnakeGame game{ 3 };
+			game.restore(serpentine_snapshot(length, 3));
+			std::uint64_t sink = 0;
+			auto rate = [](double ns) { return 1e3 / ns; };
+
+			double copy_ns = best_ns_per_call([&] {
+				SnakeGame copy = game;
+				sink += copy.getLength();
+			});
+			double fork_ns = best_ns_per_call([&] { sink += game.fork().getLength(); });
+			game.forkInto(pooled);
+			// raw::vector statistics are compiled out of release builds: watch the pooled body's storage instead
+			const SnakeGame::SnakeSegment* storage = &pooled.getBody()[0];
+			const size_t capacity = pooled.getBody().get_capacity();
+			double into_ns = best_ns_per_call([&] {
+				game.forkInto(pooled);
+				sink += pooled.getLength();
+			});
+			quiet = quiet && &pooled.getBody()[0] == storage && pooled.getBody().get_capacity() == capacity;
+			double snapshot_ns = best_ns_per_call([&] {
+				pooled.restore(game.snapshot());
+				sink += pooled.getLength();
+			});
+			source_arena.reset();
+			const rollout_state state = rollout_state::from_game(game, source_arena);
+			int forks = 0;
+			double rollout_ns = best_ns_per_call([&] {
+				if (++forks % 256 == 0) arena.reset();
+				sink += state.fork(arena).get_head();
+			});
+			const SnakeGame forked = game.fork();
+			out << std::setw(8) << length << std::fixed << std::setprecision(2) << std::setw(12) << rate(copy_ns) << std::setw(12) << rate(fork_ns)
+				<< std::setw(12) << rate(into_ns) << std::setw(18) << rate(snapshot_ns) << std::setw(16) << rate(rollout_ns)
+				<< std::setw(14) << game.getBody().get_capacity() * sizeof(SnakeGame::SnakeSegment)
+				<< std::setw(14) << forked.getBody().get_capacity() * sizeof(SnakeGame::SnakeSegment) << (sink ? "" : " ") << "\n";
+		}
+		out << "forkInto() reallocated once warm: " << (quiet ? "no" : "YES") << std::endl;
+		return ok && quiet;
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bots/Hamiltonian.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+#include "SnakeNamespace/render/SoftwareRenderer.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_hamiltonian_benchmark(std::ostream& out, size_t games)`
+	 *
+	 * Plays `games` seeded games with `hamiltonian_solver` until the snake fills all
+	 * 4800 cells, timing every `SnakeGame::tick()` (collision check, move, and on a meal
+	 * `add_snake()` + `generateApple()`) and every solver decision. Every 1024th tick
+	 * the board is also drawn with `software_backend` (clear + `SnakeGame::render()`,
+	 * 800x600), and the full board at the end is drawn 50 times more. Tick and draw
+	 * latency are grouped by snake length so the full-board end of the game shows up on
+	 * its own. Returns false if any game fails to fill the board.
+	 *************************************************************************************/
+
+	inline bool run_hamiltonian_benchmark(std::ostream& out, size_t games = 1) {
+		using clock = std::chrono::steady_clock;
+		const size_t band_edges[] = { 100, 1000, 2000, 3000, 4000, 4500, 4700, 4799, 4800 };
+		const size_t band_count = sizeof(band_edges) / sizeof(band_edges[0]);
+		auto band_of = [&](size_t length) {
+			size_t b = 0;
+			while (b + 1 < band_count && length > band_edges[b]) ++b;
+			return b;
+		};
+		auto band_name = [&](size_t b) {
+			return std::to_string(b ? band_edges[b - 1] + 1 : 1) + "-" + std::to_string(band_edges[b]);
+		};
+
+		hamiltonian_solver solver;
+		std::vector<latency_histogram> bands(band_count), draw_bands(band_count);
+		latency_histogram ticks, meals, decisions, full_board_draws;
+		framebuffer image(SnakeGame::boardWidth * SnakeGame::cellSize, SnakeGame::boardHeight * SnakeGame::cellSize);
+		software_backend backend(image);
+		auto draw = [&](const SnakeGame& game) {
+			auto start = clock::now();
+			backend.clear(sf::Color::Blue);
+			game.render(backend);
+			return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+		};
+		std::uint64_t total_ticks = 0;
+		double seconds = 0;
+		bool all_won = true;
+
+		for (size_t i = 0; i < games; ++i) {
+			SnakeGame game{ std::uint32_t(i) };
+			auto game_start = clock::now();
+			while (true) {
+				auto start = clock::now();
+				game.move(solver.decide(game));
+				auto decided = clock::now();
+				size_t length = game.getLength();
+				bool alive = game.tick();
+				double ns = std::chrono::duration<double, std::nano>(clock::now() - decided).count();
+				if (!alive) break;
+
+				decisions.add(std::chrono::duration<double, std::nano>(decided - start).count());
+				ticks.add(ns);
+				bands[band_of(length)].add(ns);
+				if (game.getLength() != length) meals.add(ns);
+				if ((game.getTicks() & 1023) == 0) draw_bands[band_of(game.getLength())].add(draw(game));
+			}
+			if (game.isWon())
+				for (int frame = 0; frame < 50; ++frame) full_board_draws.add(draw(game));
+			seconds += std::chrono::duration<double>(clock::now() - game_start).count();
+			total_ticks += game.getTicks();
+			all_won = all_won && game.isWon();
+			out << "game " << i << ": " << game.getTicks() << " ticks, length " << game.getLength()
+				<< (game.isWon() ? " (board full)" : " (DIED)") << "\n";
+		}
+
+		out << "\ntick latency by length\n";
+		latency_histogram::print_header(out, "length");
+		for (size_t b = 0; b < band_count; ++b)
+			if (bands[b].count()) bands[b].print_row(out, band_name(b));
+		ticks.print_row(out, "all ticks");
+		meals.print_row(out, "meal ticks");
+		decisions.print_row(out, "solver");
+
+		out << "\ndraw latency by length (software_backend, every 1024th tick)\n";
+		latency_histogram::print_header(out, "length");
+		for (size_t b = 0; b < band_count; ++b)
+			if (draw_bands[b].count()) draw_bands[b].print_row(out, band_name(b));
+		if (full_board_draws.count()) full_board_draws.print_row(out, "full board");
+
+		out << "\nall ticks: p90 " << ticks.percentile(90) / 1000 << " us, p99.9 " << ticks.percentile(99.9) / 1000
+			<< " us\n";
+		ticks.print_buckets(out);
+		out << std::setprecision(1) << total_ticks / seconds << " ticks/s including the solver\n";
+		out << "every game filled the board: " << (all_won ? "yes" : "NO") << std::endl;
+		return all_won;
+	}
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/input/InputQueue.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_input_benchmark(std::ostream& out)`
+	 *
+	 * An input thread presses tight turns (two perpendicular keys a fraction of a tick
+	 * apart) while the main thread ticks a game on a fixed 1 ms period. Compares the old
+	 * behaviour, where every press overwrites the pending direction, with `input_queue`,
+	 * and then floods the queue to show the drop rate once it is full. Latency is from
+	 * the press to the tick that consumes it. Presses still waiting when the last tick
+	 * has run are not lost: the producer can always beat the final tick to one. Also
+	 * reports raw `spsc_queue` throughput.
+	 *************************************************************************************/
+
+	inline bool run_input_benchmark(std::ostream& out) {
+		using clock = std::chrono::steady_clock;
+		using sc = sf::Keyboard::Scancode;
+		const auto tick_period = std::chrono::microseconds(1000);
+		const int tick_count = 1500;
+
+		struct press {
+			sc key = sc::W;
+			std::int64_t pressed_ns = 0;
+		};
+		struct result {
+			latency_histogram latency;
+			std::uint64_t presses = 0, applied = 0, rejected = 0, lost = 0;
+		};
+
+		// Pairs of perpendicular keys, `press_gap` apart, then `burst_gap` of silence.
+		auto produce = [](std::atomic<bool>& stop, auto&& push, std::chrono::microseconds press_gap, std::chrono::microseconds burst_gap) {
+			const sc keys[4] = { sc::W, sc::D, sc::S, sc::A };
+			std::uint32_t state = 12345;
+			while (!stop.load(std::memory_order_relaxed)) {
+				state = state * 1664525u + 1013904223u;
+				int first = int(state >> 30);
+				push(keys[first]);
+				std::this_thread::sleep_for(press_gap);
+				push(keys[(first + ((state >> 29) & 1 ? 1 : 3)) & 3]);
+				std::this_thread::sleep_for(press_gap + burst_gap);
+			}
+		};
+
+		auto run = [&](bool queued, std::chrono::microseconds press_gap, std::chrono::microseconds burst_gap) {
+			result r;
+			spsc_queue<press, 16> overwrite_queue;
+			input_queue input;
+			std::atomic<std::uint64_t> overwrite_presses{ 0 }, overwrite_dropped{ 0 };
+			std::atomic<bool> stop{ false };
+
+			std::thread producer([&] {
+				if (queued) produce(stop, [&](sc key) { input.push(key); }, press_gap, burst_gap);
+				else produce(stop, [&](sc key) {
+					overwrite_presses.fetch_add(1, std::memory_order_relaxed);
+					if (!overwrite_queue.try_push({ key, input_queue::now_ns() })) overwrite_dropped.fetch_add(1, std::memory_order_relaxed);
+				}, press_gap, burst_gap);
+			});
+
+			std::optional<SnakeGame> game;
+			game.emplace(std::uint32_t(1));
+			auto deadline = clock::now();
+			for (int t = 0; t < tick_count; ++t) {
+				deadline += tick_period;
+				std::this_thread::sleep_until(deadline);
+				if (queued) {
+					if (input.apply(*game)) r.latency.add(double(input.get_last_latency_ns()));
+				}
+				else {
+					// what `SnakeGame::move(KeyPressed)` did per event: only the last press before a tick counts
+					press p, last;
+					std::uint64_t seen = 0;
+					while (overwrite_queue.try_pop(p)) { game->move(p.key); last = p; ++seen; }
+					if (seen) {
+						r.lost += seen - 1;
+						++r.applied;
+						r.latency.add(double(input_queue::now_ns() - last.pressed_ns));
+					}
+				}
+				if (!game->tick()) game.emplace(std::uint32_t(t));
+			}
+			stop = true;
+			producer.join();
+
+			if (queued) {
+				r.presses = input.get_pushed();
+				r.applied = input.get_applied();
+				r.rejected = input.get_rejected();
+				r.lost = input.get_dropped();
+			}
+			else {
+				r.presses = overwrite_presses.load();
+				r.lost += overwrite_dropped.load();
+			}
+			return r;
+		};
+
+		out << "tight turns, " << tick_count << " ticks of " << tick_period.count() << " us\n";
+		result overwrite = run(false, std::chrono::microseconds(300), std::chrono::microseconds(2000));
+		result queued = run(true, std::chrono::microseconds(300), std::chrono::microseconds(2000));
+		result flood = run(true, std::chrono::microseconds(20), std::chrono::microseconds(0));
+
+		out << std::setw(14) << "mode" << std::setw(10) << "presses" << std::setw(10) << "applied"
+			<< std::setw(10) << "rejected" << std::setw(10) << "lost" << std::setw(10) << "lost %" << "\n";
+		auto counts = [&](const std::string& label, const result& r) {
+			out << std::setw(14) << label << std::setw(10) << r.presses << std::setw(10) << r.applied
+				<< std::setw(10) << r.rejected << std::setw(10) << r.lost << std::setw(9) << std::fixed << std::setprecision(2)
+				<< (r.presses ? 100.0 * r.lost / r.presses : 0.0) << "%\n";
+		};
+		counts("overwrite", overwrite);
+		counts("queue", queued);
+		counts("queue flood", flood);
+
+		out << "\npress-to-tick latency\n";
+		latency_histogram::print_header(out, "mode");
+		overwrite.latency.print_row(out, "overwrite");
+		queued.latency.print_row(out, "queue");
+		flood.latency.print_row(out, "queue flood");
+
+		// raw queue throughput between two threads
+		const std::uint64_t items = 2000000;
+		spsc_queue<std::uint64_t, 1024> raw;
+		std::uint64_t sum = 0;
+		auto start = clock::now();
+		std::thread producer([&] {
+			for (std::uint64_t i = 1; i <= items; ++i)
+				while (!raw.try_push(i)) std::this_thread::yield();
+		});
+		for (std::uint64_t received = 0, value; received < items;) {
+			if (raw.try_pop(value)) { sum += value; ++received; }
+			else std::this_thread::yield();
+		}
+		producer.join();
+		double seconds = std::chrono::duration<double>(clock::now() - start).count();
+		bool intact = sum == items * (items + 1) / 2;
+		out << "\nspsc_queue: " << std::setprecision(1) << items / seconds / 1e6 << " M items/s between two threads, "
+			<< (intact ? "all items intact" : "ITEMS LOST") << std::endl;
+		return intact && queued.lost == 0;
+	}
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+#include "SnakeNamespace/bots/Mcts.hpp"
+#include "SnakeNamespace/bots/RolloutState.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+
+namespace snake {
+	namespace detail {
+		/// `state` shows the same board as `game`; the bodies are compared cell by cell from the head.
+		inline bool same_state(const rollout_state& state, const SnakeGame& game) {
+			rollout_arena scratch(64);
+			rollout_state expected = rollout_state::from_game(game, scratch, 0);
+			if (state.get_length() != expected.get_length() || state.get_food() != expected.get_food() || state.get_score() != expected.get_score()
+				|| state.get_ticks() != expected.get_ticks() || state.get_direction() != expected.get_direction()) return false;
+			for (std::uint32_t cell = 0; cell < rollout_state::cells; ++cell)
+				if (state.is_occupied(cell) != expected.is_occupied(cell)) return false;
+			return state.get_head() == expected.get_head() && state.get_tail() == expected.get_tail();
+		}
+
+		/// Greedy games of seeds 1..`games` played by a `SnakeGame` and by `rollout_state`s, one forked off every 97 ticks.
+		inline bool check_rollout_lockstep(std::ostream& out, std::uint32_t games) {
+			// a fork goes to the arena its source is not in, which is then free to reset
+			rollout_arena arenas[2];
+			std::uint64_t ticks = 0, forks = 0;
+			bool match = true;
+			for (std::uint32_t seed = 1; seed <= games; ++seed) {
+				SnakeGame game{ seed };
+				rollout_state state = rollout_state::from_game(game, arenas[0], 0);
+				int current = 0;
+				while (match) {
+					sf::Keyboard::Scancode key = greedy_policy(game);
+					game.move(key);
+					bool alive = game.tick() && !game.checkCollision();
+					match = state.step(direction_index(key)) == alive;
+					if (!alive) break;
+					match = match && same_state(state, game);
+					++ticks;
+					if (ticks % 97 == 0) {
+						current ^= 1;
+						arenas[current].reset();
+						state = state.fork(arenas[current]);
+						++forks;
+					}
+				}
+			}
+			out << "rollout_state in lockstep with SnakeGame over " << games << " greedy games (" << ticks << " ticks, "
+				<< forks << " forks): " << (match ? "yes" : "NO") << "\n";
+			return match;
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_mcts_benchmark(std::ostream& out)`
+	 *
+	 * Checks that `rollout_state` plays tick for tick like `SnakeGame`, then times a
+	 * fork against a copy of the game by snake length, rollouts/s of one long search
+	 * on 1 thread and on every hardware thread, and finally playing strength next to
+	 * the greedy bot on the same seeds (games capped at 4000 ticks). The gate is 24
+	 * games at a fixed 150 rollouts per decision on one thread, which play the same
+	 * way on every run: it fails unless the search dies less often than greedy. Mean
+	 * scores, and 3 games per wall-clock budget, are printed for information only.
+	 *************************************************************************************/
+
+	inline bool run_mcts_benchmark(std::ostream& out) {
+		using clock = std::chrono::steady_clock;
+		bool ok = detail::check_rollout_lockstep(out, 40);
+
+		out << "\n" << std::setw(8) << "length" << std::setw(12) << "fork ns" << std::setw(12) << "fork bytes" << std::setw(18) << "SnakeGame copy ns" << "\n";
+		rollout_arena arena(1 << 20);
+		for (size_t length : { size_t(1), size_t(300), size_t(2400), size_t(4800) }) {
+			SnakeGame game{ 7 };
+			game.restore(serpentine_snapshot(length, 7));
+			arena.reset();
+			rollout_state state = rollout_state::from_game(game, arena);
+			std::uint64_t sink = 0;
+			const int forks = 20000;
+			auto start = clock::now();
+			for (int i = 0; i < forks; ++i) {
+				if (i % 256 == 0) arena.reset();
+				sink += state.fork(arena).get_head();
+			}
+			double fork_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / forks;
+			const int copies = 2000;
+			start = clock::now();
+			for (int i = 0; i < copies; ++i) {
+				SnakeGame copy = game;
+				sink += copy.getLength();
+			}
+			double copy_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / copies;
+			out << std::setw(8) << length << std::fixed << std::setprecision(0) << std::setw(12) << fork_ns
+				<< std::setw(12) << sizeof(rollout_state) + length * sizeof(std::uint16_t) << std::setw(18) << copy_ns << (sink ? "" : " ") << "\n";
+		}
+
+		// a mid-game position: greedy for 1000 ticks
+		SnakeGame position{ 2 };
+		for (int i = 0; i < 1000; ++i) {
+			position.move(greedy_policy(position));
+			if (!position.tick()) break;
+		}
+		const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+		out << "\nsearch of one position (length " << position.getLength() << ") for 500 ms\n";
+		out << std::setw(8) << "threads" << std::setw(14) << "rollouts/s" << std::setw(12) << "nodes" << "\n";
+		std::vector<size_t> thread_counts{ 1 };
+		if (hardware > 1) thread_counts.push_back(hardware);
+		for (size_t threads : thread_counts) {
+			mcts_config config;
+			config.threads = threads;
+			config.budget = std::chrono::microseconds(500000);
+			mcts_agent agent(config);
+			agent.decide(position);
+			const mcts_stats& stats = agent.get_last_stats();
+			out << std::setw(8) << threads << std::setw(14) << std::setprecision(0) << stats.rollouts / stats.seconds << std::setw(12) << stats.nodes << "\n";
+		}
+
+		const std::uint64_t max_ticks = 4000;
+		struct totals {
+			double score = 0, ticks = 0;
+			int deaths = 0;
+			std::uint64_t rollouts = 0, decisions = 0;
+			std::vector<std::uint32_t> scores;
+		};
+		// plays seeds 1..`games`; `make_decide()` gives a fresh policy per game
+		auto play_games = [&](std::uint32_t games, auto&& make_decide) {
+			totals t;
+			for (std::uint32_t seed = 1; seed <= games; ++seed) {
+				auto decide = make_decide(t);
+				SnakeGame game{ seed };
+				while (game.getTicks() < max_ticks) {
+					game.move(decide(game));
+					if (!game.tick() || game.checkCollision()) { t.deaths += !game.isWon(); break; }
+				}
+				t.score += game.getScore();
+				t.ticks += double(game.getTicks());
+				t.scores.push_back(game.getScore());
+			}
+			return t;
+		};
+		auto greedy = [](totals&) { return greedy_policy; };
+		auto mcts = [](const mcts_config& config) {
+			return [config](totals& t) {
+				return [agent = std::make_shared<mcts_agent>(config), &t](const SnakeGame& g) {
+					sf::Keyboard::Scancode key = agent->decide(g);
+					t.rollouts += agent->get_last_stats().rollouts;
+					++t.decisions;
+					return key;
+				};
+			};
+		};
+		auto header = [&] {
+			out << std::setw(18) << "bot" << std::setw(12) << "mean score" << std::setw(8) << "deaths" << std::setw(12) << "mean ticks" << std::setw(18) << "rollouts/decision" << "\n";
+		};
+		auto report = [&](const std::string& name, const totals& t, std::uint32_t games) {
+			out << std::setw(18) << name << std::setw(12) << std::setprecision(1) << t.score / games << std::setw(8) << t.deaths << std::setw(12) << std::setprecision(0) << t.ticks / games
+				<< std::setw(18) << double(t.rollouts) / std::max<std::uint64_t>(t.decisions, 1) << std::endl;
+		};
+
+		// the gate: a fixed rollout count on one thread, so every run plays the same games
+		const std::uint32_t gate_games = 24;
+		mcts_config fixed;
+		fixed.threads = 1;
+		fixed.budget = std::chrono::microseconds(0);
+		fixed.max_rollouts = 150;
+		out << "\nstrength: " << gate_games << " games of at most " << max_ticks << " ticks, " << fixed.max_rollouts << " rollouts per decision on 1 thread\n";
+		header();
+		const totals greedy_totals = play_games(gate_games, greedy);
+		report("greedy", greedy_totals, gate_games);
+		const totals fixed_totals = play_games(gate_games, mcts(fixed));
+		report("mcts " + std::to_string(fixed.max_rollouts) + " rollouts", fixed_totals, gate_games);
+		int outscored = 0;
+		for (std::uint32_t i = 0; i < gate_games; ++i) outscored += fixed_totals.scores[i] > greedy_totals.scores[i];
+		const bool survives = fixed_totals.deaths < greedy_totals.deaths;
+		out << "mcts outscores greedy in " << outscored << " of " << gate_games << " games; dies less often than greedy: " << (survives ? "yes" : "NO") << "\n";
+
+		// wall-clock budgets depend on the machine and its load: for information only
+		const std::uint32_t games = 3;
+		out << "\ntime budgets (not gated): " << games << " games of at most " << max_ticks << " ticks, " << hardware << " search threads\n";
+		header();
+		report("greedy", play_games(games, greedy), games);
+		for (int budget_us : { 250, 1000, 2500 }) {
+			mcts_config config;
+			config.budget = std::chrono::microseconds(budget_us);
+			report("mcts " + std::to_string(budget_us) + " us", play_games(games, mcts(config)), games);
+		}
+		return ok && survives;
+	}
+}
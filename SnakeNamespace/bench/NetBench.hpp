@@ -0,0 +1,218 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "SnakeNamespace/net/LockstepServer.hpp"
+#include "SnakeNamespace/net/LockstepClient.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	/// Plays `client` with `versus_greedy` until the game is over or `deadline` passes; one input per tick.
+	inline void run_bot_client(lockstep_client& client, std::chrono::steady_clock::time_point deadline) {
+		while (!client.is_over() && std::chrono::steady_clock::now() < deadline) {
+			if (client.poll(sf::milliseconds(20)) && client.get_player() >= 0 && !client.is_over())
+				client.send_input(versus_greedy(client.get_game(), client.get_player()));
+		}
+		// the last acknowledgement may have been lost; keep answering until the server stops resending
+		auto linger = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+		while (std::chrono::steady_clock::now() < linger) client.poll(sf::milliseconds(20));
+	}
+
+	namespace detail {
+		/// Replays a greedy `versus_game` on a replica: every delta must pass `can_apply()` and
+		/// `checksum_after()` must predict the checksum `apply()` leads to. Then hostile input:
+		/// deltas and snapshot datagrams that must be turned away without touching the replica.
+		inline bool check_versus_validation(std::ostream& out) {
+			using vg = versus_game;
+			bool predicted = true;
+			std::uint64_t deltas = 0;
+			for (std::uint64_t seed = 1; seed <= 20; ++seed) {
+				vg server(int(seed % vg::max_players) + 1, seed), replica;
+				replica.restore(server.make_snapshot());
+				while (!server.is_over() && server.get_tick() < 3000) {
+					vg::direction wanted[vg::max_players];
+					for (int id = 0; id < server.get_player_count(); ++id) wanted[id] = versus_greedy(server, id);
+					vg::tick_delta delta = server.step(wanted);
+					predicted = predicted && replica.can_apply(delta);
+					std::uint32_t expected = replica.checksum_after(delta);
+					replica.apply(delta);
+					predicted = predicted && expected == replica.checksum() && expected == server.checksum();
+					++deltas;
+				}
+			}
+
+			// a two-player game in which player 1 is dead
+			vg game(2, 3);
+			vg::snapshot snap = game.make_snapshot();
+			snap.alive[1] = false;
+			snap.bodies[1].clear();
+			game.restore(snap);
+			const std::uint32_t before = game.checksum();
+			vg::tick_delta base;
+			base.tick = game.get_tick() + 1;
+			base.flags[0] = vg::moved | vg::tail_removed;
+			base.head[0] = vg::next_cell(game.get_player(0).body.front(), game.get_player(0).heading);
+			bool rejected = game.can_apply(base);
+			auto refuse = [&](vg::tick_delta delta) { rejected = rejected && !game.can_apply(delta); };
+			vg::tick_delta bad = base;
+			bad.head[0] = vg::cells;
+			refuse(bad);
+			bad = base;
+			bad.flags[1] = vg::died;
+			refuse(bad);
+			bad = base;
+			bad.flags[1] = vg::tail_removed;
+			refuse(bad);
+			bad = base;
+			bad.flags[0] = vg::tail_removed;
+			refuse(bad);
+			bad = base;
+			bad.flags[2] = vg::moved;
+			refuse(bad);
+			bad = base;
+			bad.food_changed = true;
+			bad.food = vg::cells + 7;
+			refuse(bad);
+			bad = base;
+			bad.tick += 1;
+			refuse(bad);
+
+			// snapshot datagrams: a head off the board, and a living player without a body
+			std::vector<std::uint8_t> datagram;
+			vg::snapshot hostile = game.make_snapshot();
+			hostile.bodies[0] = { std::uint16_t(vg::cells + 100) };
+			write_snapshot(datagram, 0, hostile);
+			vg::snapshot read;
+			int seat = -1;
+			packet_reader off_board(datagram.data(), datagram.size());
+			rejected = rejected && !read_snapshot(off_board, seat, read);
+			hostile = game.make_snapshot();
+			hostile.bodies[0].clear();
+			write_snapshot(datagram, 0, hostile);
+			packet_reader bodiless(datagram.data(), datagram.size());
+			rejected = rejected && !read_snapshot(bodiless, seat, read) && game.checksum() == before;
+
+			out << "checksum_after() predicts apply() over " << deltas << " greedy deltas: " << (predicted ? "yes" : "NO") << "\n"
+				<< "hostile deltas and snapshots rejected: " << (rejected ? "yes" : "NO") << "\n\n";
+			return predicted && rejected;
+		}
+
+		/// A one-seat server flooded with hellos from 20 sockets and sent an input tagged far in
+		/// the future: it must refuse the hellos past `max_spectators`, drop the silent clients
+		/// it did take, and refuse the input.
+		inline bool check_server_limits(std::ostream& out) {
+			lockstep_server_options options;
+			options.port = 0;
+			options.players = 1;
+			options.tick_hz = 100;
+			options.max_ticks = 100;
+			options.max_spectators = 4;
+			options.client_timeout_seconds = 0.3;
+			lockstep_server server(options);
+			if (!server.bind()) {
+				out << "cannot bind a UDP port" << std::endl;
+				return false;
+			}
+
+			// queued before run() starts, so the seat goes to the first socket
+			std::vector<std::uint8_t> datagram;
+			sf::UdpSocket flood[21];
+			for (sf::UdpSocket& socket : flood) {
+				if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Status::Done) return false;
+				write_hello(datagram);
+				socket.send(datagram.data(), datagram.size(), sf::IpAddress::LocalHost, server.get_port());
+			}
+			write_input(datagram, 0, 0, { { 1000000, versus_game::direction::left } });
+			flood[0].send(datagram.data(), datagram.size(), sf::IpAddress::LocalHost, server.get_port());
+
+			lockstep_server_report report = server.run();
+			bool held = report.peak_clients == 1 + 4 && report.refused_clients == 16
+				&& report.dropped_clients == 1 + 4 && report.refused_inputs == 1 && report.clients == 0;
+			out << "21 hellos to 1 seat and 4 spectator places: " << report.peak_clients << " taken, " << report.refused_clients << " refused, "
+				<< report.dropped_clients << " dropped when silent; " << report.refused_inputs << " input far ahead refused: " << (held ? "yes" : "NO") << "\n\n";
+			return held;
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_net_benchmark(std::ostream& out)`
+	 *
+	 * A `lockstep_server` and two bot `lockstep_client`s in one process, over UDP on
+	 * 127.0.0.1, at 100 ticks/s for up to 500 ticks; once clean and once with 20% of
+	 * the datagrams dropped both ways. Reports traffic per tick against sending
+	 * snapshots, input-to-applied-tick latency, desyncs, and checks that both clients
+	 * end on the server's checksum. Meanwhile a third socket sends the clients forged
+	 * snapshots of another game, which they must ignore. First runs
+	 * `detail::check_versus_validation()` and `detail::check_server_limits()`.
+	 *************************************************************************************/
+
+	inline bool run_net_benchmark(std::ostream& out) {
+		bool ok = detail::check_versus_validation(out);
+		ok = detail::check_server_limits(out) && ok;
+		for (double loss : { 0.0, 0.2 }) {
+			lockstep_server_options options;
+			options.port = 0;
+			options.tick_hz = 100;
+			options.max_ticks = 500;
+			options.seed = 7;
+			lockstep_server server(options);
+			if (!server.bind()) {
+				out << "cannot bind a UDP port" << std::endl;
+				return false;
+			}
+
+			std::atomic<bool> stop{ false };
+			lockstep_server_report server_report;
+			std::thread server_thread([&] { server_report = server.run(&stop); });
+
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+			lockstep_client clients[2];
+			std::vector<std::thread> threads;
+			for (size_t i = 0; i < 2; ++i) {
+				clients[i].set_drop_rate(loss, 100 + i);
+				clients[i].connect(sf::IpAddress::LocalHost, server.get_port());
+				threads.emplace_back([&, i] { run_bot_client(clients[i], deadline); });
+			}
+			// a snapshot far ahead of the real game, from an address that is not the server's
+			sf::UdpSocket forger;
+			std::vector<std::uint8_t> forged;
+			versus_game::snapshot other = versus_game(2, 99).make_snapshot();
+			other.tick = 1000000;
+			write_snapshot(forged, 0, other);
+			if (forger.bind(sf::Socket::AnyPort) == sf::Socket::Status::Done)
+				for (int burst = 0; burst < 10; ++burst) {
+					for (lockstep_client& client : clients) forger.send(forged.data(), forged.size(), sf::IpAddress::LocalHost, client.get_local_port());
+					std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				}
+			for (std::thread& t : threads) t.join();
+			stop = true;
+			server_thread.join();
+
+			out << "loss " << std::fixed << std::setprecision(0) << loss * 100 << "%: ";
+			print_server_report(out, server_report);
+			print_traffic_header(out);
+			print_traffic(out, "server", server_report.traffic, server_report.ticks);
+			bool converged = true;
+			for (size_t i = 0; i < 2; ++i) {
+				const lockstep_client_report& r = clients[i].get_report();
+				print_traffic(out, i ? "client 1" : "client 0", r.traffic, server_report.ticks);
+				converged = converged && clients[i].get_game().checksum() == server_report.final_checksum
+					&& clients[i].get_game().get_tick() == server_report.ticks && r.foreign > 0;
+			}
+			latency_histogram::print_header(out, "input->tick");
+			for (size_t i = 0; i < 2; ++i) {
+				const lockstep_client_report& r = clients[i].get_report();
+				r.latency.print_row(out, i ? "client 1" : "client 0");
+				out << "    " << r.ticks_applied << " ticks applied, " << r.snapshots << " snapshots, " << r.desyncs << " desyncs, "
+					<< r.stale_records << " resent ticks skipped, " << r.dropped << " datagrams dropped, " << r.foreign << " forged ignored, "
+					<< r.rejected << " rejected\n";
+			}
+			out << "clients match the server at the end: " << (converged ? "yes" : "NO") << "\n" << std::endl;
+			ok = ok && converged && server_report.ticks > 0;
+		}
+		return ok;
+	}
+}
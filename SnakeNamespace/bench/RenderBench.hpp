@@ -0,0 +1,112 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/render/SoftwareRenderer.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+
+namespace snake {
+	/// A frame whose image hash is checked in: any change to the rasterizer, the board drawing or the game that moves a pixel changes it.
+	struct golden_frame {
+		std::uint32_t seed;
+		std::uint64_t ticks;
+		std::uint64_t hash;
+	};
+
+	/// `--render`'s default frame, and a longer snake later in another game.
+	inline constexpr golden_frame golden_frames[] = {
+		{ 1, 500, 0xd388c359b51a0c7aull },
+		{ 7, 3000, 0xfd18e6f38635a712ull },
+	};
+
+	/// The frame `--render` draws: the greedy bot plays `ticks` ticks of game `seed`, drawn on blue into `image` (800x600).
+	inline SnakeGame render_bot_frame(framebuffer& image, std::uint32_t seed, std::uint64_t ticks, bool simd = true) {
+		SnakeGame game{ seed };
+		while (game.getTicks() < ticks) {
+			game.move(greedy_policy(game));
+			if (!game.tick())
+				break;
+		}
+		software_backend backend(image);
+		backend.set_simd(simd);
+		backend.clear(sf::Color::Blue);
+		game.render(backend);
+		return game;
+	}
+
+	/// The checked-in hash for `seed` at `ticks`, 0 if there is none.
+	inline std::uint64_t golden_hash(std::uint32_t seed, std::uint64_t ticks) {
+		for (const golden_frame& frame : golden_frames)
+			if (frame.seed == seed && frame.ticks == ticks) return frame.hash;
+		return 0;
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_render_benchmark(std::ostream& out)`
+	 *
+	 * Renders full 800x600 frames (clear + `SnakeGame::render()`) with `software_backend`
+	 * for serpentine bodies of 1, 100, 1000 and 4800 segments, once with the SIMD span
+	 * fill and once with the scalar one. Reports frames/s and filled Mpixel/s, and
+	 * checks that both paths produce the same image, pixel for pixel. Then draws the
+	 * `golden_frames` with both paths; their hashes must match the checked-in ones.
+	 *************************************************************************************/
+
+	inline bool run_render_benchmark(std::ostream& out) {
+		using clock = std::chrono::steady_clock;
+		const unsigned int width = SnakeGame::boardWidth * SnakeGame::cellSize, height = SnakeGame::boardHeight * SnakeGame::cellSize;
+
+		out << "software rasterizer, " << width << "x" << height << ", span fill: " << span_fill_isa() << "\n";
+		out << std::setw(8) << "length" << std::setw(14) << "simd fps" << std::setw(12) << "Mpix/s"
+			<< std::setw(14) << "scalar fps" << std::setw(12) << "Mpix/s" << "  image hash\n";
+
+		bool identical = true;
+		for (size_t length : { size_t(1), size_t(100), size_t(1000), size_t(4800) }) {
+			SnakeGame game;
+			game.restore(serpentine_snapshot(length, 1));
+			double pixels_per_frame = double(width) * height + double(length) * SnakeGame::cellSize * SnakeGame::cellSize;
+
+			double fps[2] = {};
+			std::uint64_t hashes[2] = {};
+			for (int pass = 0; pass < 2; ++pass) {
+				framebuffer image(width, height);
+				software_backend backend(image);
+				backend.set_simd(pass == 0);
+				auto start = clock::now();
+				double seconds = 0;
+				int frames = 0;
+				while (frames < 20 || seconds < 0.3) {
+					backend.clear(sf::Color::Blue);
+					game.render(backend);
+					++frames;
+					seconds = std::chrono::duration<double>(clock::now() - start).count();
+				}
+				fps[pass] = frames / seconds;
+				hashes[pass] = image.hash();
+			}
+			identical = identical && hashes[0] == hashes[1];
+
+			out << std::setw(8) << length << std::fixed << std::setprecision(1)
+				<< std::setw(14) << fps[0] << std::setw(12) << fps[0] * pixels_per_frame / 1e6
+				<< std::setw(14) << fps[1] << std::setw(12) << fps[1] * pixels_per_frame / 1e6
+				<< "  " << std::hex << hashes[0] << std::dec << (hashes[0] == hashes[1] ? "" : " (SCALAR DIFFERS)") << "\n";
+		}
+		out << "SIMD and scalar images identical: " << (identical ? "yes" : "NO") << "\n";
+
+		bool golden = true;
+		for (const golden_frame& frame : golden_frames) {
+			for (bool simd : { true, false }) {
+				framebuffer image(width, height);
+				render_bot_frame(image, frame.seed, frame.ticks, simd);
+				golden = golden && image.hash() == frame.hash;
+				out << "golden frame, seed " << frame.seed << " tick " << frame.ticks << (simd ? ", simd:   " : ", scalar: ") << std::hex << image.hash();
+				if (image.hash() != frame.hash) out << " (expected " << frame.hash << ")";
+				out << std::dec << "\n";
+			}
+		}
+		out << "golden frames match: " << (golden ? "yes" : "NO") << std::endl;
+		return identical && golden;
+	}
+}
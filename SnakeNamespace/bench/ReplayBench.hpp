@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "SnakeNamespace/replay/Replay.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_replay_benchmark(std::ostream& out, size_t games)`
+	 *
+	 * Records `games` greedy games, then reports stream size in bits per tick,
+	 * playback speed in ticks/s and the average cost of a random `seek()`.
+	 * Returns false if any replay fails to reproduce its game.
+	 *************************************************************************************/
+
+	inline bool run_replay_benchmark(std::ostream& out, size_t games = 200) {
+		using clock = std::chrono::steady_clock;
+		std::vector<replay> replays;
+		std::uint64_t ticks = 0, bytes = 0;
+		for (size_t i = 0; i < games; ++i) {
+			SnakeGame game{ std::uint32_t(i) };
+			replay_recorder recorder(game);
+			while (game.getTicks() < 200000) {
+				game.move(greedy_policy(game));
+				if (!game.tick() || !recorder.capture(game)) break;
+			}
+			replays.push_back(recorder.finish(game));
+			ticks += replays.back().ticks;
+			bytes += replays.back().stream.size();
+		}
+
+		bool valid = true;
+		std::uint64_t seeks = 0;
+		double playback_seconds = 0, seek_seconds = 0;
+		std::uint64_t probe = 0x2545F4914F6CDD1Dull;
+		for (const auto& recorded : replays) {
+			auto start = clock::now();
+			replay_player player(recorded);
+			while (player.step()) {}
+			playback_seconds += std::chrono::duration<double>(clock::now() - start).count();
+			valid = valid && player.is_valid() && player.get_game().getScore() == recorded.final_score;
+
+			start = clock::now();
+			for (int i = 0; i < 16; ++i) {
+				probe ^= probe << 13; probe ^= probe >> 7; probe ^= probe << 17;
+				player.seek(probe % (recorded.ticks + 1));
+				++seeks;
+			}
+			seek_seconds += std::chrono::duration<double>(clock::now() - start).count();
+		}
+
+		out << "replays of " << games << " greedy games, " << ticks << " ticks\n" << std::fixed
+			<< "stream size:   " << std::setprecision(3) << 8.0 * bytes / ticks << " bits/tick (" << bytes << " bytes)\n"
+			<< "playback:      " << std::setprecision(1) << ticks / playback_seconds << " ticks/s (including keyframe indexing)\n"
+			<< "random seek:   " << std::setprecision(2) << seek_seconds / seeks * 1e6 << " us average\n"
+			<< "all replays reproduced: " << (valid ? "yes" : "NO") << std::endl;
+		return valid;
+	}
+}
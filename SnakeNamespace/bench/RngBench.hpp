@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/random/Random.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	namespace detail {
+		template <typename Rng>
+		void rng_row(std::ostream& out, const char* name) {
+			using Game = BasicSnakeGame<Rng>;
+			volatile std::uint32_t sink = 0;
+			std::uint32_t seed = 0;
+
+			double seed_ns = best_ns_per_call([&] { Rng rng{ seed++ }; sink = sink + next_u32(rng); });
+			Rng drawn(1);
+			double draw_ns = best_ns_per_call([&] { sink = sink + bounded(drawn, SnakeGame::boardWidth); });
+			double construct_ns = best_ns_per_call([&] { Game game{ seed++ }; sink = sink + std::uint32_t(game.getFood().x); });
+
+			Game original{ 1 };
+			double copy_ns = best_ns_per_call([&] { Game copy = original; sink = sink + std::uint32_t(copy.getFood().x); });
+
+			double place_ns[3] = {};
+			const size_t lengths[3] = { 1, 2400, 4700 };
+			for (int l = 0; l < 3; ++l) {
+				auto game = std::make_unique<Game>(1);
+				game->restore(serpentine_snapshot<Game>(lengths[l], 1));
+				place_ns[l] = best_ns_per_call([&] { game->generateApple(); sink = sink + std::uint32_t(game->getFood().x); });
+			}
+
+			out << std::setw(14) << name << std::setw(8) << sizeof(Rng) << std::fixed << std::setprecision(1)
+				<< std::setw(10) << seed_ns << std::setw(10) << draw_ns << std::setw(12) << construct_ns / 1000 << std::setw(10) << copy_ns / 1000
+				<< std::setw(10) << place_ns[0] << std::setw(10) << place_ns[1] / 1000 << std::setw(10) << place_ns[2] / 1000 << "\n";
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_rng_benchmark(std::ostream& out)`
+	 *
+	 * For each engine `SnakeGame` can be built with: state size, seeding, one bounded
+	 * draw in [0, 80), constructing and copying a game, and one `generateApple()` on a
+	 * board holding 1, 2400 and 4700 segments. The first row is what every draw cost
+	 * before: `std::uniform_int_distribution` over `std::mt19937`. Also checks that
+	 * `bounded()` is uniform (chi-square over 10^6 draws in [0, 4800)).
+	 *************************************************************************************/
+
+	inline bool run_rng_benchmark(std::ostream& out) {
+		volatile std::uint32_t sink = 0;
+		std::mt19937 legacy(1);
+		std::uniform_int_distribution<> dist(0, SnakeGame::boardWidth - 1);
+		std::uint32_t seed = 0;
+		double legacy_draw = best_ns_per_call([&] { sink = sink + std::uint32_t(dist(legacy)); });
+		double legacy_seed = best_ns_per_call([&] { std::mt19937 rng{ seed++ }; sink = sink + rng(); });
+
+		out << std::setw(14) << "engine" << std::setw(8) << "bytes" << std::setw(10) << "seed ns" << std::setw(10) << "draw ns"
+			<< std::setw(12) << "new game us" << std::setw(10) << "copy us" << std::setw(10) << "apple ns" << std::setw(10) << "@2400 us" << std::setw(10) << "@4700 us" << "\n";
+		out << std::setw(14) << "mt19937+dist" << std::setw(8) << sizeof(std::mt19937) << std::fixed << std::setprecision(1)
+			<< std::setw(10) << legacy_seed << std::setw(10) << legacy_draw << "   (old SnakeGame placement draws)\n";
+		detail::rng_row<std::mt19937>(out, "mt19937");
+		detail::rng_row<pcg32>(out, "pcg32");
+		detail::rng_row<xoshiro256ss>(out, "xoshiro256**");
+
+		const std::uint32_t range = SnakeGame::boardWidth * SnakeGame::boardHeight;
+		const size_t draws = 1000000;
+		std::vector<std::uint32_t> counts(range, 0);
+		xoshiro256ss rng(7);
+		for (size_t i = 0; i < draws; ++i) ++counts[bounded(rng, range)];
+		double expected = double(draws) / range, chi2 = 0;
+		for (std::uint32_t c : counts) chi2 += (c - expected) * (c - expected) / expected;
+		// 4799 degrees of freedom: mean 4799, standard deviation ~98
+		bool uniform = chi2 < range + 5 * 98.0;
+		out << "bounded() chi-square over " << range << " cells: " << std::setprecision(0) << chi2
+			<< (uniform ? " (uniform)" : " (NOT UNIFORM)") << std::endl;
+		return uniform;
+	}
+}
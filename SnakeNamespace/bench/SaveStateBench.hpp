@@ -0,0 +1,85 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_savestate_benchmark(std::ostream& out)`
+	 *
+	 * Round-trip checks and timings for `SnakeGame::saveState()`/`loadState()`:
+	 * - byte-identical re-save after a load, for bodies up to the full 4800 segments;
+	 * - a loaded game keeps playing exactly like the original;
+	 * - truncated or foreign buffers are rejected without touching the game;
+	 * - average save and load time per state.
+	 *************************************************************************************/
+
+	inline bool run_savestate_benchmark(std::ostream& out) {
+		using clock = std::chrono::steady_clock;
+		bool ok = true;
+
+		out << std::setw(8) << "length" << std::setw(10) << "bytes" << std::setw(12) << "save ns" << std::setw(12) << "load ns" << "  round-trip\n";
+		for (size_t length : { size_t(1), size_t(100), size_t(1000), size_t(4800) }) {
+			SnakeGame original;
+			original.restore(serpentine_snapshot(length, 42));
+			std::vector<unsigned char> saved = original.saveState();
+
+			SnakeGame copy{ 7u };
+			bool round_trip = copy.loadState(saved.data(), saved.size()) && copy.saveState() == saved;
+
+			const int iterations = 2000;
+			std::vector<unsigned char> buffer(saved.size());
+			auto start = clock::now();
+			for (int i = 0; i < iterations; ++i) original.saveState(buffer.data(), buffer.size());
+			double save_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+
+			start = clock::now();
+			for (int i = 0; i < iterations; ++i) copy.loadState(buffer.data(), buffer.size());
+			double load_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / iterations;
+
+			ok = ok && round_trip;
+			out << std::setw(8) << length << std::setw(10) << saved.size() << std::fixed << std::setprecision(0)
+				<< std::setw(12) << save_ns << std::setw(12) << load_ns << "  " << (round_trip ? "ok" : "FAILED") << "\n";
+		}
+
+		SnakeGame played{ 3u };
+		for (int i = 0; i < 300 && played.tick(); ++i) played.move(greedy_policy(played));
+		std::vector<unsigned char> fork_point = played.saveState();
+		SnakeGame resumed{ 11u };
+		bool continues = resumed.loadState(fork_point.data(), fork_point.size());
+		for (int i = 0; i < 2000 && continues; ++i) {
+			played.move(greedy_policy(played));
+			resumed.move(greedy_policy(resumed));
+			bool a = played.tick(), b = resumed.tick();
+			continues = a == b && played.saveState() == resumed.saveState();
+			if (!a) break;
+		}
+
+		std::vector<unsigned char> before = resumed.saveState();
+		std::vector<unsigned char> broken = fork_point;
+		broken[0] = 'X';
+		// a count whose byte size wraps around to the real one, and a body longer than the board
+		std::vector<unsigned char> wrapped = fork_point, oversized(sizeof(SnakeGame::SaveStateHeader) + (SnakeGame::boardWidth * SnakeGame::boardHeight + 1) * sizeof(SnakeGame::SnakeSegment));
+		std::uint64_t count;
+		std::memcpy(&count, wrapped.data() + offsetof(SnakeGame::SaveStateHeader, segmentCount), sizeof(count));
+		count += std::uint64_t(1) << 62;
+		std::memcpy(wrapped.data() + offsetof(SnakeGame::SaveStateHeader, segmentCount), &count, sizeof(count));
+		std::memcpy(oversized.data(), fork_point.data(), sizeof(SnakeGame::SaveStateHeader));
+		count = SnakeGame::boardWidth * SnakeGame::boardHeight + 1;
+		std::memcpy(oversized.data() + offsetof(SnakeGame::SaveStateHeader, segmentCount), &count, sizeof(count));
+		bool rejects = !resumed.loadState(fork_point.data(), fork_point.size() - 1) && !resumed.loadState(broken.data(), broken.size())
+			&& !resumed.loadState(wrapped.data(), wrapped.size()) && !resumed.loadState(oversized.data(), oversized.size())
+			&& resumed.saveState() == before;
+
+		out << "resumed game matches original: " << (continues ? "yes" : "NO") << "\n"
+			<< "bad buffers rejected:          " << (rejects ? "yes" : "NO") << std::endl;
+		return ok && continues && rejects;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <SFML/Graphics.hpp>
+#include "SnakeNamespace/scene/GameSession.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_scene_benchmark(std::ostream& out)`
+	 *
+	 * Menu-to-first-game-frame latency, from the click to the first game frame returned
+	 * by `display()`, both ways the game has started:
+	 *  - window per game: opens a new 800x600 `sf::RenderWindow` for the game (the old
+	 *    nested loop in `SnakeScreen::MousePressed()`), closed again when the game ends;
+	 *  - one window: the GAME scene draws into the menu's window, so a start is just a
+	 *    `game_session`.
+	 * Needs a display, like the game itself.
+	 *************************************************************************************/
+
+	inline bool run_scene_benchmark(std::ostream& out) {
+		using clock = std::chrono::steady_clock;
+		const int starts = 20;
+
+		auto first_frame = [](sf::RenderWindow& window, std::optional<game_session>& session) {
+			session.emplace();
+			window.clear(sf::Color::Blue);
+			session->draw(window, session->latest());
+			window.display();
+		};
+
+		latency_histogram per_window, shared;
+		for (int i = 0; i < starts; ++i) {
+			std::optional<game_session> session;
+			auto start = clock::now();
+			{
+				sf::RenderWindow window(sf::VideoMode({ 800, 600 }), "Snake game");
+				first_frame(window, session);
+				per_window.add(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+				session->finish("");
+			}
+		}
+
+		sf::RenderWindow window(sf::VideoMode({ 800, 600 }), "Snake game");
+		for (int i = 0; i < starts; ++i) {
+			std::optional<game_session> session;
+			auto start = clock::now();
+			first_frame(window, session);
+			shared.add(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+			session->finish("");
+		}
+
+		out << "menu -> first game frame over " << starts << " starts\n";
+		latency_histogram::print_header(out, "start");
+		per_window.print_row(out, "window/game");
+		shared.print_row(out, "one window");
+		out << "one window saves " << std::fixed << std::setprecision(2) << (per_window.mean() - shared.mean()) / 1e6 << " ms per start" << std::endl;
+		return true;
+	}
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/input/InputQueue.hpp"
+#include "SnakeNamespace/threading/SimulationThread.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * BENCHMARK: `run_threading_benchmark(std::ostream& out, int ticks)`
+	 *
+	 * Runs the game loop twice without a window, with `display()` replaced by a sleep of
+	 * one 60 Hz frame that stalls for 150 ms every 12th frame:
+	 * - serial: poll input, `update()`, draw and display on one thread, as before;
+	 * - split:  `simulation_thread` ticks, the loop only draws `latest()` and displays.
+	 * An input thread keeps turning. Reports tick jitter (deviation of the tick interval
+	 * from 100 ms) and input-to-photon latency (press until the first displayed frame
+	 * showing it has been presented).
+	 *************************************************************************************/
+
+	inline bool run_threading_benchmark(std::ostream& out, int ticks = 40) {
+		using sc = sf::Keyboard::Scancode;
+		const std::int64_t period_ns = 100000000;
+
+		struct result {
+			latency_histogram jitter, photon;
+			std::vector<std::int64_t> tick_ns;
+			std::uint64_t frames = 0;
+		};
+
+		auto display = [](std::uint64_t frame_index) {
+			std::this_thread::sleep_for(std::chrono::microseconds(frame_index % 12 == 11 ? 150000 : 16667));
+		};
+		// clockwise turns keep a short snake circling, far from walls and itself
+		auto press_turns = [](input_queue& input, std::atomic<bool>& stop) {
+			const sc keys[4] = { sc::D, sc::S, sc::A, sc::W };
+			for (int i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+				input.push(keys[i & 3]);
+				std::this_thread::sleep_for(std::chrono::milliseconds(230));
+			}
+		};
+		// what a frame costs to build besides presenting it
+		auto draw = [](const std::vector<sf::Vector2f>& body, std::vector<sf::Vector2f>& target) { target.assign(body.begin(), body.end()); };
+
+		auto summarize = [&](result& r, std::int64_t shown_ns, std::int64_t& last_shown) {
+			if (shown_ns && shown_ns != last_shown) {
+				r.photon.add(double(input_queue::now_ns() - shown_ns));
+				last_shown = shown_ns;
+			}
+		};
+
+		auto serial = [&] {
+			result r;
+			SnakeGame game{ std::uint32_t(7) };
+			input_queue input;
+			std::atomic<bool> stop{ false };
+			std::thread presser([&] { press_turns(input, stop); });
+
+			sf::Clock frameClock;
+			std::vector<sf::Vector2f> body, scratch;
+			std::int64_t pending_press = 0, visible_press = 0, last_shown = 0;
+			while (game.getTicks() < std::uint64_t(ticks)) {
+				if (input.apply(game)) pending_press = input.get_last_pressed_ns();
+				std::uint64_t before = game.getTicks();
+				if (!game.update(frameClock.restart())) break;
+				if (game.getTicks() != before) {
+					r.tick_ns.push_back(input_queue::now_ns());
+					visible_press = pending_press;
+				}
+				body.clear();
+				for (const auto& segment : game.getBody()) body.push_back(segment.coords);
+				draw(body, scratch);
+				display(r.frames++);
+				summarize(r, visible_press, last_shown);
+			}
+			stop = true;
+			presser.join();
+			return r;
+		};
+
+		auto split = [&] {
+			result r;
+			SnakeGame game{ std::uint32_t(7) };
+			input_queue input;
+			std::atomic<bool> stop{ false };
+			std::thread presser([&] { press_turns(input, stop); });
+
+			std::vector<sf::Vector2f> scratch;
+			std::int64_t last_shown = 0;
+			{
+				simulation_thread simulation(game, input, sf::milliseconds(100), {},
+					[&](SnakeGame&) { r.tick_ns.push_back(input_queue::now_ns()); });
+				while (true) {
+					const frame& latest = simulation.latest();
+					if (!latest.alive || latest.tick >= std::uint64_t(ticks)) break;
+					draw(latest.body, scratch);
+					display(r.frames++);
+					summarize(r, latest.input_ns, last_shown);
+				}
+			}
+			stop = true;
+			presser.join();
+			return r;
+		};
+
+		out << ticks << " ticks of 100 ms, display stalls 150 ms every 12th frame\n";
+		result serial_run = serial();
+		result split_run = split();
+
+		bool ok = true;
+		auto report = [&](const std::string& label, result& r) {
+			double sum = 0, sum_sq = 0;
+			for (size_t i = 1; i < r.tick_ns.size(); ++i) {
+				std::int64_t interval = r.tick_ns[i] - r.tick_ns[i - 1];
+				r.jitter.add(double(std::llabs(interval - period_ns)));
+				sum += double(interval);
+				sum_sq += double(interval) * double(interval);
+			}
+			size_t n = r.tick_ns.size() > 1 ? r.tick_ns.size() - 1 : 1;
+			double mean = sum / n;
+			out << std::setw(14) << label << ": " << r.tick_ns.size() << " ticks, " << r.frames << " frames, tick interval "
+				<< std::fixed << std::setprecision(2) << mean / 1e6 << " ms +- " << std::sqrt(std::max(0.0, sum_sq / n - mean * mean)) / 1e6 << " ms\n";
+			ok = ok && r.tick_ns.size() >= size_t(ticks / 2);
+		};
+		report("serial", serial_run);
+		report("split", split_run);
+
+		out << "\ntick jitter (|interval - 100 ms|)\n";
+		latency_histogram::print_header(out, "loop");
+		serial_run.jitter.print_row(out, "serial");
+		split_run.jitter.print_row(out, "split");
+		out << "\ninput-to-photon latency\n";
+		latency_histogram::print_header(out, "loop");
+		serial_run.photon.print_row(out, "serial");
+		split_run.photon.print_row(out, "split");
+		out << std::flush;
+		return ok;
+	}
+}
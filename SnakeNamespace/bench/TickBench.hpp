@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	/// Per-call timings of one `SnakeGame` operation at one body length and layout.
+	struct tick_bench_result {
+		std::string operation;
+		size_t length = 0;
+		fill_pattern pattern = fill_pattern::rows;
+		size_t batch = 0;      ///< calls timed together per sample
+		size_t samples = 0;
+		double mean_ns = 0;
+		double stddev_ns = 0;
+		double min_ns = 0;
+		double median_ns = 0;
+		double p90_ns = 0;
+		double max_ns = 0;
+		bool valid = true;     ///< false when a tick ended the game, i.e. the setup is broken
+	};
+
+	namespace detail {
+		using tick_clock = std::chrono::steady_clock;
+
+		constexpr size_t tick_bench_warmup = 5;
+		constexpr size_t tick_bench_samples = 101;
+		constexpr double tick_bench_target_ns = 20000;   ///< a sample times this long a batch, when the operation allows
+
+		inline double elapsed_ns(tick_clock::time_point start) {
+			return std::chrono::duration<double, std::nano>(tick_clock::now() - start).count();
+		}
+
+		/// `text` as the inside of a JSON string: quotes and backslashes escaped, control characters made spaces.
+		inline std::string json_escaped(const std::string& text) {
+			std::string escaped;
+			for (char c : text) {
+				if (c == '"' || c == '\\') escaped += '\\';
+				if (static_cast<unsigned char>(c) < 0x20) escaped += ' ';
+				else escaped += c;
+			}
+			return escaped;
+		}
+
+		/// Median cost of an empty timed region, taken off every sample.
+		inline double timer_overhead_ns() {
+			std::vector<double> empty(1001);
+			for (double& ns : empty) {
+				auto start = tick_clock::now();
+				ns = elapsed_ns(start);
+			}
+			std::nth_element(empty.begin(), empty.begin() + empty.size() / 2, empty.end());
+			return empty[empty.size() / 2];
+		}
+
+		/*
+		 * @brief Times `batch` back-to-back calls of `op` per sample, after an untimed `prepare()`.
+		 *
+		 * The batch doubles from 1 until a sample takes `tick_bench_target_ns` or it would
+		 * pass `max_batch` (operations that change the game can only run a few calls before
+		 * the state has to be restored). The first samples are thrown away as warmup.
+		 */
+		template <typename Prepare, typename Op>
+		tick_bench_result time_operation(const char* operation, size_t max_batch, double overhead_ns, Prepare&& prepare, Op&& op) {
+			tick_bench_result result;
+			result.operation = operation;
+			size_t batch = 1;
+			for (;;) {
+				prepare();
+				auto start = tick_clock::now();
+				for (size_t i = 0; i < batch; ++i) op();
+				if (elapsed_ns(start) >= tick_bench_target_ns || batch * 2 > max_batch) break;
+				batch *= 2;
+			}
+
+			std::vector<double> per_call;
+			per_call.reserve(tick_bench_samples);
+			for (size_t s = 0; s < tick_bench_warmup + tick_bench_samples; ++s) {
+				prepare();
+				auto start = tick_clock::now();
+				for (size_t i = 0; i < batch; ++i) op();
+				double ns = std::max(0.0, elapsed_ns(start) - overhead_ns) / batch;
+				if (s >= tick_bench_warmup) per_call.push_back(ns);
+			}
+
+			std::sort(per_call.begin(), per_call.end());
+			double sum = 0, squares = 0;
+			for (double ns : per_call) sum += ns;
+			result.mean_ns = sum / per_call.size();
+			for (double ns : per_call) squares += (ns - result.mean_ns) * (ns - result.mean_ns);
+			result.stddev_ns = std::sqrt(squares / (per_call.size() - 1));
+			result.min_ns = per_call.front();
+			result.median_ns = per_call[per_call.size() / 2];
+			result.p90_ns = per_call[per_call.size() * 9 / 10];
+			result.max_ns = per_call.back();
+			result.batch = batch;
+			result.samples = per_call.size();
+			return result;
+		}
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_tick_benchmarks()`
+	 *
+	 * Every piece of a tick on its own, for bodies of exactly 1, 100, 1000 and 4800
+	 * segments laid out by each `fill_pattern` that fits them: `move()`,
+	 * `checkCollision()`, `generateApple()`, `add_snake()`, and whole `tick()` and
+	 * `update()` calls (101 ms per update, so each one ticks). Operations that change
+	 * the game run a few calls per sample from a restored snapshot, so the body keeps
+	 * its length and the snake never dies. On the full board the game is already won:
+	 * only `move()` and `checkCollision()` are timed there.
+	 *************************************************************************************/
+
+	inline std::vector<tick_bench_result> run_tick_benchmarks(double& overhead_ns) {
+		overhead_ns = detail::timer_overhead_ns();
+		std::vector<tick_bench_result> results;
+		volatile std::uint64_t sink = 0;
+		const size_t board = size_t(SnakeGame::boardWidth * SnakeGame::boardHeight);
+
+		for (fill_pattern pattern : { fill_pattern::rows, fill_pattern::comb }) {
+			for (size_t length : { size_t(1), size_t(100), size_t(1000), size_t(4800) }) {
+				if (length > fill_pattern_capacity(pattern)) continue;
+				const SnakeGame::Snapshot start = serpentine_snapshot(length, 1, pattern);
+				SnakeGame game{ 1u };
+				game.restore(start);
+				bool alive = true;
+				auto restore = [&] { game.restore(start); };
+				auto nothing = [] {};
+				auto keep = [&](tick_bench_result result) {
+					result.length = length;
+					result.pattern = pattern;
+					result.valid = alive;
+					results.push_back(result);
+				};
+
+				// far more calls than anything else: both only read the body or shift it in place
+				keep(detail::time_operation("move", 1 << 16, overhead_ns, nothing, [&] { game.move(); }));
+				game.restore(start);
+				keep(detail::time_operation("checkCollision", 1 << 16, overhead_ns, nothing, [&] { sink = sink + game.checkCollision(); }));
+				if (length == board) continue;
+
+				keep(detail::time_operation("generateApple", 1 << 16, overhead_ns, nothing, [&] { sink = sink + game.generateApple(); }));
+				keep(detail::time_operation("add_snake", std::min<size_t>(64, board - length), overhead_ns, restore, [&] { game.add_snake(); }));
+				// 8 steps ahead are free in every layout: the head always has a row or a column to itself
+				keep(detail::time_operation("tick", 8, overhead_ns, restore, [&] { alive = game.tick() && alive; }));
+				keep(detail::time_operation("update", 8, overhead_ns, restore, [&] { alive = game.update(sf::milliseconds(101)) && alive; }));
+			}
+		}
+		return results;
+	}
+
+	inline void print_tick_results(std::ostream& out, const std::vector<tick_bench_result>& results, double overhead_ns) {
+		const build_info build = current_build();
+		out << build.type << " build, " << build.compiler << ", commit " << build.commit << (build.vector_stats ? ", raw::vector stats on" : "") << "\n";
+		out << "timer overhead " << std::fixed << std::setprecision(1) << overhead_ns << " ns (subtracted); ns per call over "
+			<< detail::tick_bench_samples << " samples after " << detail::tick_bench_warmup << " warmup\n";
+		out << std::setw(8) << "layout" << std::setw(8) << "length" << std::setw(16) << "operation" << std::setw(8) << "batch"
+			<< std::setw(11) << "median" << std::setw(11) << "mean" << std::setw(10) << "stddev" << std::setw(11) << "min" << std::setw(11) << "p90" << "\n";
+		for (const tick_bench_result& r : results)
+			out << std::setw(8) << fill_pattern_name(r.pattern) << std::setw(8) << r.length << std::setw(16) << r.operation << std::setw(8) << r.batch
+				<< std::setw(11) << r.median_ns << std::setw(11) << r.mean_ns << std::setw(10) << r.stddev_ns << std::setw(11) << r.min_ns << std::setw(11) << r.p90_ns
+				<< (r.valid ? "" : "  (GAME ENDED)") << "\n";
+		out.flush();
+	}
+
+	/// The same results as one JSON document, for dashboards comparing builds.
+	inline void write_tick_json(std::ostream& out, const std::vector<tick_bench_result>& results, double overhead_ns) {
+		const build_info build = current_build();
+		out << std::fixed << std::setprecision(2) << "{\n  \"benchmark\": \"tick\",\n  \"version\": 1,\n"
+			<< "  \"build\": {\"type\": \"" << build.type << "\", \"compiler\": \"" << detail::json_escaped(build.compiler)
+			<< "\", \"commit\": \"" << detail::json_escaped(build.commit) << "\", \"vector_stats\": " << (build.vector_stats ? "true" : "false") << "},\n"
+			<< "  \"board\": [" << SnakeGame::boardWidth << ", " << SnakeGame::boardHeight << "],\n"
+			<< "  \"warmup_samples\": " << detail::tick_bench_warmup << ",\n"
+			<< "  \"timer_overhead_ns\": " << overhead_ns << ",\n  \"results\": [\n";
+		for (size_t i = 0; i < results.size(); ++i) {
+			const tick_bench_result& r = results[i];
+			out << "    {\"operation\": \"" << r.operation << "\", \"length\": " << r.length << ", \"layout\": \"" << fill_pattern_name(r.pattern)
+				<< "\", \"batch\": " << r.batch << ", \"samples\": " << r.samples << ", \"median_ns\": " << r.median_ns
+				<< ", \"mean_ns\": " << r.mean_ns << ", \"stddev_ns\": " << r.stddev_ns << ", \"min_ns\": " << r.min_ns
+				<< ", \"p90_ns\": " << r.p90_ns << ", \"max_ns\": " << r.max_ns << ", \"valid\": " << (r.valid ? "true" : "false") << "}"
+				<< (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}" << std::endl;
+	}
+
+	/*************************************************************************************
+	 * BENCHMARK: `run_tick_benchmark(std::ostream& out, std::ostream* json)`
+	 *
+	 * Runs `run_tick_benchmarks()`, prints the table to `out` and, if `json` is not
+	 * null, the JSON document to it. Fails if a timed tick ended the game.
+	 *************************************************************************************/
+
+	inline bool run_tick_benchmark(std::ostream& out, std::ostream* json = nullptr) {
+		double overhead_ns = 0;
+		std::vector<tick_bench_result> results = run_tick_benchmarks(overhead_ns);
+		print_tick_results(out, results, overhead_ns);
+		if (json) write_tick_json(*json, results, overhead_ns);
+		return std::all_of(results.begin(), results.end(), [](const tick_bench_result& r) { return r.valid; });
+	}
+}
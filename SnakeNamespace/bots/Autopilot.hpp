@@ -0,0 +1,305 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "SnakeGame.hpp"
+
+namespace snake {
+	/*
+	 * @brief Food-seeking bot that keeps a distance field instead of searching every tick.
+	 *
+	 * `dist[cell]` is the BFS distance from the food to `cell` through free cells. A tick only
+	 * changes two cells (the new head becomes blocked, the old tail becomes free), so the field
+	 * is patched locally:
+	 *
+	 * ## Updates:
+	 * - free cell    - relax outwards from the freed cell (distances can only shrink).
+	 * - blocked cell - collect the cells whose every shortest path ran through it (support
+	 *                  counting), then re-run a small Dijkstra over just those cells.
+	 * - food moved   - full BFS, O(board), once per apple.
+	 *
+	 * Before committing to a move the bot checks that the tail is still reachable from the new
+	 * head in the board as it will be after the move; if no move is safe it takes the one that
+	 * leaves the most room. Decisions are cached per tick, so `decide()` may be called every frame.
+	 */
+	class autopilot {
+	private:
+		static constexpr std::uint32_t unreachable = 0xFFFFFFFFu;
+		static constexpr int width = SnakeGame::boardWidth;
+		static constexpr int height = SnakeGame::boardHeight;
+
+		std::vector<std::uint16_t> occupied = std::vector<std::uint16_t>(width * height, 0);
+		std::vector<std::uint32_t> dist = std::vector<std::uint32_t>(width * height, unreachable);
+		std::deque<std::uint32_t> body;
+		std::uint32_t food = unreachable;
+
+		std::uint64_t synced_tick = ~std::uint64_t(0);
+		std::uint64_t decided_tick = ~std::uint64_t(0);
+		sf::Keyboard::Scancode decision = sf::Keyboard::Scancode::W;
+
+		std::vector<std::uint32_t> mark = std::vector<std::uint32_t>(width * height, 0);
+		std::vector<std::uint32_t> support_mark = std::vector<std::uint32_t>(width * height, 0);
+		std::vector<std::uint32_t> support = std::vector<std::uint32_t>(width * height, 0);
+		std::uint32_t generation = 0;
+		std::vector<std::uint32_t> work;
+
+		std::uint64_t rebuilds = 0;
+		std::uint64_t patches = 0;
+
+		/// The food's cell, `unreachable` once it has left the board.
+		static std::uint32_t food_cell(const SnakeGame& game) {
+			const int cell = SnakeGame::cellIndex(game.getFood());
+			return cell < 0 ? unreachable : std::uint32_t(cell);
+		}
+
+		/// Calls `fn(neighbour)` for the up to four on-board neighbours of `cell`.
+		template <typename Fn>
+		static void for_neighbours(std::uint32_t cell, Fn&& fn) {
+			std::uint32_t x = cell % width, y = cell / width;
+			if (y > 0) fn(cell - width);
+			if (x + 1 < std::uint32_t(width)) fn(cell + 1);
+			if (y + 1 < std::uint32_t(height)) fn(cell + width);
+			if (x > 0) fn(cell - 1);
+		}
+
+		std::uint32_t next_generation() {
+			if (++generation == 0) {
+				std::fill(mark.begin(), mark.end(), 0);
+				std::fill(support_mark.begin(), support_mark.end(), 0);
+				generation = 1;
+			}
+			return generation;
+		}
+
+		void rebuild_field() {
+			++rebuilds;
+			std::fill(dist.begin(), dist.end(), unreachable);
+			if (food == unreachable || occupied[food]) return;
+			work.clear();
+			work.push_back(food);
+			dist[food] = 0;
+			for (size_t i = 0; i < work.size(); ++i) {
+				std::uint32_t u = work[i];
+				for_neighbours(u, [&](std::uint32_t v) {
+					if (!occupied[v] && dist[v] == unreachable) { dist[v] = dist[u] + 1; work.push_back(v); }
+				});
+			}
+		}
+
+		void on_freed(std::uint32_t cell) {
+			++patches;
+			std::uint32_t best = unreachable;
+			for_neighbours(cell, [&](std::uint32_t n) { if (dist[n] != unreachable) best = std::min(best, dist[n] + 1); });
+			if (best == unreachable) return;
+			dist[cell] = best;
+			work.clear();
+			work.push_back(cell);
+			for (size_t i = 0; i < work.size(); ++i) {
+				std::uint32_t u = work[i];
+				for_neighbours(u, [&](std::uint32_t v) {
+					if (!occupied[v] && dist[u] + 1 < dist[v]) { dist[v] = dist[u] + 1; work.push_back(v); }
+				});
+			}
+		}
+
+		void on_blocked(std::uint32_t cell) {
+			++patches;
+			if (dist[cell] == unreachable) return;
+			std::uint32_t gen = next_generation();
+
+			// cells left without any parent (neighbour one step closer to the food) once `cell` is gone
+			work.clear();
+			work.push_back(cell);
+			mark[cell] = gen;
+			for (size_t i = 0; i < work.size(); ++i) {
+				std::uint32_t u = work[i];
+				for_neighbours(u, [&](std::uint32_t v) {
+					if (mark[v] == gen || occupied[v] || dist[v] != dist[u] + 1) return;
+					if (support_mark[v] != gen) {
+						support_mark[v] = gen;
+						support[v] = 0;
+						for_neighbours(v, [&](std::uint32_t p) { if (dist[p] + 1 == dist[v]) ++support[v]; });
+					}
+					if (--support[v] == 0) { mark[v] = gen; work.push_back(v); }
+				});
+			}
+
+			for (std::uint32_t u : work) dist[u] = unreachable;
+			using entry = std::pair<std::uint32_t, std::uint32_t>;
+			std::priority_queue<entry, std::vector<entry>, std::greater<entry>> frontier;
+			for (size_t i = 1; i < work.size(); ++i) {
+				std::uint32_t u = work[i];
+				for_neighbours(u, [&](std::uint32_t n) {
+					if (mark[n] != gen && dist[n] != unreachable && dist[n] + 1 < dist[u]) dist[u] = dist[n] + 1;
+				});
+				if (dist[u] != unreachable) frontier.push({ dist[u], u });
+			}
+			while (!frontier.empty()) {
+				auto [d, u] = frontier.top();
+				frontier.pop();
+				if (d != dist[u]) continue;
+				for_neighbours(u, [&](std::uint32_t v) {
+					if (mark[v] == gen && !occupied[v] && d + 1 < dist[v]) { dist[v] = d + 1; frontier.push({ d + 1, v }); }
+				});
+			}
+		}
+
+		void occupy(std::uint32_t cell, bool update_field) {
+			if (occupied[cell]++ == 0 && update_field) on_blocked(cell);
+		}
+		void vacate(std::uint32_t cell, bool update_field) {
+			if (--occupied[cell] == 0 && update_field) on_freed(cell);
+		}
+
+		void resync(const SnakeGame& game) {
+			std::fill(occupied.begin(), occupied.end(), 0);
+			body.clear();
+			for (const auto& segment : game.getBody()) {
+				const int cell = SnakeGame::cellIndex(segment.coords);
+				if (cell < 0) continue;
+				body.push_back(std::uint32_t(cell));
+				++occupied[cell];
+			}
+			food = food_cell(game);
+			rebuild_field();
+		}
+
+		/// Mirrors one tick: the head is pushed, the tail popped, and on a meal the game grows like `SnakeGame::add_snake()`.
+		void sync(const SnakeGame& game) {
+			const int head_index = SnakeGame::cellIndex(game.getHead());
+			const bool head_on_board = head_index >= 0;
+			const std::uint32_t head = head_on_board ? std::uint32_t(head_index) : 0, new_food = food_cell(game);
+
+			if (game.getTicks() != synced_tick + 1 || body.empty() || !head_on_board
+				|| (game.getLength() != body.size() && game.getLength() != body.size() + 1)) {
+				resync(game);
+			}
+			else {
+				bool food_moved = new_food != food;
+				bool grew = game.getLength() == body.size() + 1;
+				const std::uint32_t old_tail = body.back();
+				vacate(old_tail, !food_moved);
+				body.pop_back();
+				body.push_front(head);
+				occupy(head, !food_moved);
+				if (grew) {
+					// a copy of the new tail, or for a lone head the cell it just left
+					body.push_back(body.size() == 1 ? old_tail : body.back());
+					occupy(body.back(), false);
+				}
+				food = new_food;
+				if (food_moved) rebuild_field();
+			}
+			synced_tick = game.getTicks();
+		}
+
+		/// Whether the cell that will be the tail after moving to `next` can still be reached from `next`.
+		bool tail_reachable(std::uint32_t next, bool eats, size_t* area = nullptr, size_t area_cap = 0) {
+			if (body.size() == 1) { if (area) *area = area_cap; return true; }
+			std::uint32_t old_tail = body.back();
+			std::uint32_t new_tail = eats ? body.back() : body[body.size() - 2];
+			auto passable = [&](std::uint32_t c) {
+				return occupied[c] == 0 || (!eats && c == old_tail && occupied[c] == 1);
+			};
+
+			// depth-first, nearest-to-the-tail neighbour first: in open space this walks straight to it
+			auto remaining = [&](std::uint32_t c) {
+				int dx = int(c % width) - int(new_tail % width), dy = int(c / width) - int(new_tail / width);
+				return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+			};
+			std::uint32_t gen = next_generation();
+			work.clear();
+			work.push_back(next);
+			mark[next] = gen;
+			size_t seen = 1;
+			bool found = false;
+			while (!work.empty() && !found && (!area || seen < area_cap)) {
+				std::uint32_t u = work.back();
+				work.pop_back();
+				std::uint32_t open[4];
+				int count = 0;
+				for_neighbours(u, [&](std::uint32_t v) {
+					if (v == new_tail) found = true;
+					else if (mark[v] != gen && passable(v)) { mark[v] = gen; open[count++] = v; }
+				});
+				for (int i = 1; i < count; ++i)
+					for (int j = i; j > 0 && remaining(open[j - 1]) < remaining(open[j]); --j) std::swap(open[j - 1], open[j]);
+				work.insert(work.end(), open, open + count);
+				seen += count;
+			}
+			if (area) *area = seen;
+			return found;
+		}
+
+	public:
+		/*************************************************************************************
+		 * DECIDE FUNCTION: `decide(const SnakeGame& game)`
+		 *
+		 * Returns the key to feed into `SnakeGame::move()` before the next tick.
+		 * Calling it again before the game ticks returns the cached answer.
+		 *************************************************************************************/
+
+		sf::Keyboard::Scancode decide(const SnakeGame& game) {
+			if (game.getTicks() == decided_tick) return decision;
+			sync(game);
+			decided_tick = game.getTicks();
+			decision = game.getDirection();
+			if (body.empty()) return decision;
+
+			using sc = sf::Keyboard::Scancode;
+			const struct { sc key; sc opposite; int dx, dy; } options[4] = {
+				{ sc::W, sc::S, 0, -1 }, { sc::D, sc::A, 1, 0 }, { sc::S, sc::W, 0, 1 }, { sc::A, sc::D, -1, 0 },
+			};
+
+			std::uint32_t head = body.front();
+			int hx = int(head % width), hy = int(head / width);
+			bool have_safe = false;
+			std::uint32_t best_distance = unreachable;
+			size_t best_area = 0;
+			for (const auto& option : options) {
+				if (option.opposite == game.getDirection()) continue;
+				int x = hx + option.dx, y = hy + option.dy;
+				if (x < 0 || y < 0 || x >= width || y >= height) continue;
+				std::uint32_t next = std::uint32_t(y * width + x);
+				bool eats = next == food;
+				if (occupied[next] && !(next == body.back() && occupied[next] == 1 && body.size() > 1)) continue;
+
+				std::uint32_t distance = dist[next];
+				bool better_tie = option.key == game.getDirection();
+				if (tail_reachable(next, eats)) {
+					if (!have_safe || distance < best_distance || (distance == best_distance && better_tie)) {
+						have_safe = true;
+						best_distance = distance;
+						decision = option.key;
+					}
+				}
+				else if (!have_safe) {
+					size_t area = 0;
+					tail_reachable(next, eats, &area, body.size() + 1);
+					if (area > best_area) { best_area = area; decision = option.key; }
+				}
+			}
+			return decision;
+		}
+
+		/// Whether the body and food last synced are those of `game`, cell for cell from the head.
+		bool matches(const SnakeGame& game) const {
+			const auto& segments = game.getBody();
+			size_t i = 0;
+			for (const auto& segment : segments) {
+				const int cell = SnakeGame::cellIndex(segment.coords);
+				if (cell < 0) continue;
+				if (i == body.size() || body[i++] != std::uint32_t(cell)) return false;
+			}
+			return i == body.size() && food == food_cell(game);
+		}
+
+		/// Distance from every cell to the food through free cells, 0xFFFFFFFF where unreachable.
+		const std::vector<std::uint32_t>& get_distances() const { return dist; }
+		std::uint64_t get_rebuilds() const { return rebuilds; }
+		std::uint64_t get_patches() const { return patches; }
+	};
+}
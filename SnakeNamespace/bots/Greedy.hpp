@@ -0,0 +1,41 @@
+#pragma once
+#include <cmath>
+#include "SnakeGame.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * POLICY: `greedy_policy(const SnakeGame& game)`
+	 *
+	 * Picks the non-reversing direction whose next head cell is on the board, not on
+	 * the body, and closest (Manhattan) to the food. Keeps the current direction when
+	 * every option is blocked. O(length) per call; stateless and thread-safe.
+	 *************************************************************************************/
+
+	inline sf::Keyboard::Scancode greedy_policy(const SnakeGame& game) {
+		using sc = sf::Keyboard::Scancode;
+		const float cell = float(SnakeGame::cellSize);
+		const struct { sc key; sc opposite; float dx, dy; } options[4] = {
+			{ sc::W, sc::S, 0, -cell }, { sc::S, sc::W, 0, cell },
+			{ sc::A, sc::D, -cell, 0 }, { sc::D, sc::A, cell, 0 },
+		};
+
+		sf::Vector2f head = game.getHead(), food = game.getFood();
+		sc best = game.getDirection();
+		float best_distance = INFINITY;
+		for (const auto& option : options) {
+			if (option.opposite == game.getDirection()) continue;
+			sf::Vector2f next = { head.x + option.dx, head.y + option.dy };
+			if (next.x < 0 || next.y < 0 || next.x >= SnakeGame::boardWidth * cell || next.y >= SnakeGame::boardHeight * cell) continue;
+
+			bool hits_body = false;
+			for (const auto& segment : game.getBody()) {
+				if (segment.coords == next) { hits_body = true; break; }
+			}
+			if (hits_body) continue;
+
+			float distance = std::abs(next.x - food.x) + std::abs(next.y - food.y);
+			if (distance < best_distance) { best_distance = distance; best = option.key; }
+		}
+		return best;
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "SnakeGame.hpp"
+
+namespace snake {
+	/*
+	 * @brief Bot that follows a fixed Hamiltonian cycle and therefore always fills the board.
+	 *
+	 * The cycle runs down and up the columns of rows 1..H-1 (W is even, so it ends next to the
+	 * top row) and comes back along row 0. Because the head only ever moves forward along the
+	 * cycle, the body always lies inside the stretch of the cycle between tail and head, so a
+	 * cell is known to be free without looking at the body.
+	 *
+	 * ## Shortcuts:
+	 * While that stretch is short the bot may jump ahead to any neighbour that
+	 * - does not pass the food, and
+	 * - stays more than `tail_slack` cycle steps short of the tail (room to grow while eating).
+	 * This keeps the ordering invariant, so the snake still cannot trap itself.
+	 */
+	class hamiltonian_solver {
+	private:
+		static constexpr int width = SnakeGame::boardWidth;
+		static constexpr int height = SnakeGame::boardHeight;
+		static constexpr std::uint32_t cells = std::uint32_t(width * height);
+		static constexpr std::uint32_t tail_slack = 4;
+		static_assert(width % 2 == 0 && height >= 2, "the column cycle needs an even board width");
+
+		std::vector<std::uint32_t> order = std::vector<std::uint32_t>(cells);
+		std::vector<std::uint32_t> next = std::vector<std::uint32_t>(cells);
+		bool shortcuts;
+
+		/// Steps from `from` to `to` going forward along the cycle.
+		std::uint32_t ahead(std::uint32_t from, std::uint32_t to) const {
+			return (order[to] + cells - order[from]) % cells;
+		}
+
+		static sf::Keyboard::Scancode key_towards(std::uint32_t from, std::uint32_t to) {
+			if (to + width == from) return sf::Keyboard::Scancode::W;
+			if (to == from + width) return sf::Keyboard::Scancode::S;
+			if (to + 1 == from) return sf::Keyboard::Scancode::A;
+			return sf::Keyboard::Scancode::D;
+		}
+
+	public:
+		explicit hamiltonian_solver(bool allow_shortcuts = true) : shortcuts(allow_shortcuts) {
+			std::vector<std::uint32_t> path;
+			path.reserve(cells);
+			for (int x = 0; x < width; ++x) {
+				for (int i = 1; i < height; ++i)
+					path.push_back(std::uint32_t((x % 2 ? height - i : i) * width + x));
+			}
+			for (int x = width - 1; x >= 0; --x) path.push_back(std::uint32_t(x));
+			for (std::uint32_t i = 0; i < cells; ++i) {
+				order[path[i]] = i;
+				next[path[i]] = path[(i + 1) % cells];
+			}
+		}
+
+		/// Position of `cell` (y * width + x) along the cycle.
+		std::uint32_t get_order(std::uint32_t cell) const { return order[cell]; }
+
+		/*************************************************************************************
+		 * DECIDE FUNCTION: `decide(const SnakeGame& game)`
+		 *
+		 * Returns the key to feed into `SnakeGame::move()` before the next tick. Stateless,
+		 * so one solver can drive any number of games, also from several threads.
+		 *************************************************************************************/
+
+		sf::Keyboard::Scancode decide(const SnakeGame& game) const {
+			const int head_index = SnakeGame::cellIndex(game.getHead());
+			if (head_index < 0) return game.getDirection();
+			const int tail_index = SnakeGame::cellIndex(game.getBody()[game.getLength() - 1].coords);
+			const int food_index = SnakeGame::cellIndex(game.getFood());
+			const std::uint32_t head = std::uint32_t(head_index), tail = tail_index < 0 ? head : std::uint32_t(tail_index);
+			const bool has_food = food_index >= 0;
+			const std::uint32_t food = has_food ? std::uint32_t(food_index) : 0;
+
+			std::uint32_t x = head % width, y = head / width;
+			const std::uint32_t neighbours[4] = {
+				y > 0 ? head - width : head, x + 1 < std::uint32_t(width) ? head + 1 : head,
+				y + 1 < std::uint32_t(height) ? head + width : head, x > 0 ? head - 1 : head,
+			};
+			// with a one-cell body the game ignores a reversal, so never plan one
+			sf::Keyboard::Scancode facing = game.getDirection();
+			auto reverses = [&](std::uint32_t n) { return game.getLength() == 1 && key_towards(n, head) == facing; };
+
+			std::uint32_t best = next[head];
+			std::uint32_t best_step = 1;
+			if (reverses(best)) {
+				best_step = cells;
+				for (std::uint32_t n : neighbours) {
+					if (n != head && !reverses(n) && ahead(head, n) < best_step) { best = n; best_step = ahead(head, n); }
+				}
+			}
+
+			if (shortcuts && has_food) {
+				std::uint32_t room = game.getLength() == 1 ? cells : ahead(head, tail);
+				std::uint32_t limit = ahead(head, food);
+				for (std::uint32_t n : neighbours) {
+					if (n == head || reverses(n)) continue;
+					std::uint32_t step = ahead(head, n);
+					if (step <= best_step || step > limit || step + tail_slack >= room) continue;
+					best = n;
+					best_step = step;
+				}
+			}
+			return key_towards(head, best);
+		}
+	};
+}
@@ -0,0 +1,253 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bots/Greedy.hpp"
+#include "SnakeNamespace/bots/RolloutState.hpp"
+#include "SnakeNamespace/random/Random.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+#include "SnakeNamespace/threading/ThreadPool.hpp"
+
+namespace snake {
+	struct mcts_config {
+		size_t threads = 0;                                  ///< search threads, 0 for one per hardware thread
+		std::chrono::microseconds budget{ 2000 };            ///< search time per decision, 0 for none (then `max_rollouts` stops it)
+		std::uint64_t max_rollouts = 0;                      ///< per thread and decision; 0 leaves it to `budget`
+		int rollout_depth = 40;                              ///< moves past the tree before a rollout is scored
+		double rollout_greed = 0.8;                          ///< share of rollout moves that head for the food, the rest are random safe moves
+		double exploration = 0.8;                            ///< UCT constant
+		double discount = 0.97;                              ///< per move, so sooner food counts for more
+		double death_penalty = 2.0;
+		double closeness = 1.0;                              ///< worth of a rollout ending at the food, less the further away it ends
+		std::uint64_t seed = 1;
+	};
+
+	/// What the last `mcts_agent::decide()` did, summed over its threads.
+	struct mcts_stats {
+		std::uint64_t rollouts = 0;
+		std::uint64_t nodes = 0;
+		double seconds = 0;
+		size_t threads = 0;
+	};
+
+	/*************************************************************************************
+	 * CLASS: `mcts_agent`
+	 *
+	 * Monte Carlo tree search over `rollout_state`s, root-parallel: every thread grows
+	 * its own tree from the same root for the time budget and the root visit counts
+	 * are summed, so threads share nothing while searching.
+	 *
+	 * Food lands at random, so the trees are open-loop: a node stands for a sequence of
+	 * moves, and every iteration replays the sequence from a fresh fork of the root
+	 * whose food engine is re-seeded, so the search plans against where food may
+	 * appear, not where this game's engine will put it. An iteration descends by UCT,
+	 * adds one node, and plays on `rollout_depth` moves with a cheap policy (a safe
+	 * move, mostly towards the food). Food scores +1, death `-death_penalty` and
+	 * ending near the food up to `closeness`, all discounted per move. Forks go to a
+	 * per-thread `rollout_arena` reset after every iteration, so a search allocates
+	 * nothing once its trees and arenas have grown.
+	 *************************************************************************************/
+
+	class mcts_agent {
+	private:
+		struct node {
+			std::uint32_t children = 0;      ///< index of the first of 4 children (one per direction), 0 before expansion
+			std::uint32_t visits = 0;
+			double value = 0;                ///< sum of the returns through this node
+		};
+
+		struct worker {
+			std::vector<node> tree;
+			rollout_arena arena{ 1 << 15 };
+			xoshiro256ss rng;
+			std::vector<std::uint32_t> path;
+			std::vector<float> rewards;
+			std::uint64_t rollouts = 0;
+		};
+
+		mcts_config config;
+		thread_pool pool;
+		std::vector<worker> workers;
+		rollout_arena root_arena{ 1 << 13 };
+		rollout_state root;
+		std::chrono::steady_clock::time_point deadline;
+		std::uint64_t decisions = 0;
+		mcts_stats stats;
+		// built once: a std::function per decision would be a per-decision allocation
+		std::function<void(size_t, size_t)> search_range;
+
+		/// Plays `action` on `state` and returns its reward.
+		float play(rollout_state& state, std::uint8_t action) const {
+			std::uint32_t score = state.get_score();
+			if (!state.step(action)) return state.is_won() ? float(state.get_score() - score) : -float(config.death_penalty);
+			return float(state.get_score() - score);
+		}
+
+		/// A move that does not die at once, towards the food `rollout_greed` of the time; straight on when every move dies.
+		std::uint8_t rollout_action(const rollout_state& state, xoshiro256ss& rng) const {
+			static const int dx[4] = { 0, 1, 0, -1 }, dy[4] = { -1, 0, 1, 0 };
+			const int x = int(state.get_head() % rollout_state::width), y = int(state.get_head() / rollout_state::width);
+			const std::uint32_t tail = state.get_tail();
+			std::uint8_t safe[4];
+			int count = 0;
+			for (std::uint8_t a = 0; a < 4; ++a) {
+				if ((a ^ state.get_direction()) == 2) continue;
+				const int nx = x + dx[a], ny = y + dy[a];
+				// the tail moves away this step, unless it is doubled after a meal; a rollout may take that small risk
+				if (!state.is_blocked(nx, ny) || std::uint32_t(ny * rollout_state::width + nx) == tail) safe[count++] = a;
+			}
+			if (count == 0) return state.get_direction();
+			const std::uint64_t draw = rng();
+			if (state.get_food() != rollout_state::no_food && double(draw >> 11) * 0x1.0p-53 < config.rollout_greed) {
+				const int fx = state.get_food() % rollout_state::width, fy = state.get_food() / rollout_state::width;
+				std::uint8_t best = safe[0];
+				int best_distance = 1 << 30;
+				for (int i = 0; i < count; ++i) {
+					int distance = std::abs(x + dx[safe[i]] - fx) + std::abs(y + dy[safe[i]] - fy);
+					if (distance < best_distance) { best_distance = distance; best = safe[i]; }
+				}
+				return best;
+			}
+			return safe[draw % std::uint64_t(count)];
+		}
+
+		/// One iteration: select, expand, roll out, back up.
+		void iterate(worker& w) {
+			w.arena.reset();
+			rollout_state state = root.fork(w.arena, std::uint32_t(config.rollout_depth) + 64);
+			state.reseed(w.rng());
+			w.path.clear();
+			w.rewards.clear();
+			std::uint32_t current = 0;
+			const double log_scale = config.exploration * config.exploration;
+
+			while (state.is_alive()) {
+				node& parent = w.tree[current];
+				if (parent.children == 0) {
+					// expand; `current` is re-read below, as the tree may have moved
+					parent.children = std::uint32_t(w.tree.size());
+					w.tree.resize(w.tree.size() + 4);
+				}
+				const node& expanded = w.tree[current];
+				const double log_visits = std::log(double(expanded.visits) + 1);
+				std::uint32_t chosen = 0;
+				double best = -1e300;
+				int unvisited = 0;
+				for (std::uint8_t a = 0; a < 4; ++a) {
+					if ((a ^ state.get_direction()) == 2) continue;
+					const node& child = w.tree[expanded.children + a];
+					if (child.visits == 0) {
+						// unvisited children first, a uniformly random one of them
+						if (bounded(w.rng, std::uint32_t(++unvisited)) == 0) chosen = a;
+						continue;
+					}
+					double score = child.value / child.visits + std::sqrt(log_scale * log_visits / child.visits);
+					if (!unvisited && score > best) { best = score; chosen = a; }
+				}
+				const bool fresh = unvisited > 0;
+				current = expanded.children + chosen;
+				w.path.push_back(current);
+				w.rewards.push_back(play(state, std::uint8_t(chosen)));
+				if (fresh) break;
+			}
+
+			// rollout from the new node, its rewards folded into the last one on the path
+			double tail_return = 0, weight = 1;
+			for (int depth = 0; depth < config.rollout_depth && state.is_alive(); ++depth) {
+				tail_return += weight * play(state, rollout_action(state, w.rng));
+				weight *= config.discount;
+			}
+			// food further off than a rollout reaches would leave every move worth the same
+			if (state.is_alive() && state.get_food() != rollout_state::no_food) {
+				const int dx = int(state.get_food() % rollout_state::width) - int(state.get_head() % rollout_state::width);
+				const int dy = int(state.get_food() / rollout_state::width) - int(state.get_head() / rollout_state::width);
+				tail_return += weight * config.closeness * (1.0 - double(std::abs(dx) + std::abs(dy)) / (rollout_state::width + rollout_state::height));
+			}
+
+			double value = tail_return;
+			w.tree[0].visits++;
+			for (size_t i = w.path.size(); i-- > 0;) {
+				value = w.rewards[i] + config.discount * value;
+				node& n = w.tree[w.path[i]];
+				++n.visits;
+				n.value += value;
+			}
+			++w.rollouts;
+		}
+
+		void search(worker& w) {
+			w.tree.clear();
+			w.tree.push_back({});
+			w.rollouts = 0;
+			for (;;) {
+				iterate(w);
+				if (config.max_rollouts && w.rollouts >= config.max_rollouts) break;
+				if (config.budget.count() > 0 && std::chrono::steady_clock::now() >= deadline) break;
+			}
+		}
+
+	public:
+		explicit mcts_agent(const mcts_config& config_ = {}) : config(config_), pool(config_.threads) {
+			if (config.budget.count() <= 0 && config.max_rollouts == 0) config.budget = mcts_config{}.budget;
+			workers.resize(pool.get_thread_count());
+			search_range = [this](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) search(workers[i]);
+			};
+		}
+
+		mcts_agent(const mcts_agent&) = delete;
+		mcts_agent& operator=(const mcts_agent&) = delete;
+
+		/*************************************************************************************
+		 * DECIDE FUNCTION: `decide(const SnakeGame& game)`
+		 *
+		 * Searches for `config.budget` (or `config.max_rollouts` per thread) and returns
+		 * the most visited first move as the key for `SnakeGame::move()`.
+		 *************************************************************************************/
+
+		sf::Keyboard::Scancode decide(const SnakeGame& game) {
+			auto start = std::chrono::steady_clock::now();
+			root_arena.reset();
+			root = rollout_state::from_game(game, root_arena);
+			if (!root.is_alive()) return game.getDirection();
+			deadline = start + config.budget;
+			for (size_t i = 0; i < workers.size(); ++i) {
+				std::uint64_t state = config.seed ^ (decisions << 20) ^ i;
+				workers[i].rng = xoshiro256ss(splitmix64(state));
+			}
+			++decisions;
+			pool.parallel_for(0, workers.size(), 1, search_range);
+
+			std::uint64_t visits[4] = {};
+			double values[4] = {};
+			stats = { 0, 0, 0, workers.size() };
+			for (const worker& w : workers) {
+				stats.rollouts += w.rollouts;
+				stats.nodes += w.tree.size();
+				if (w.tree[0].children == 0) continue;
+				for (int a = 0; a < 4; ++a) {
+					visits[a] += w.tree[w.tree[0].children + a].visits;
+					values[a] += w.tree[w.tree[0].children + a].value;
+				}
+			}
+			stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			int best = -1;
+			for (int a = 0; a < 4; ++a) {
+				if ((a ^ root.get_direction()) == 2 || visits[a] == 0) continue;
+				// most visits, ties to the higher mean return
+				if (best < 0 || visits[a] > visits[best] || (visits[a] == visits[best] && values[a] / visits[a] > values[best] / visits[best])) best = a;
+			}
+			return best < 0 ? greedy_policy(game) : direction_key(std::uint8_t(best));
+		}
+
+		const mcts_stats& get_last_stats() const { return stats; }
+		const mcts_config& get_config() const { return config; }
+		size_t get_thread_count() const { return workers.size(); }
+	};
+}
@@ -0,0 +1,271 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/random/Random.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+
+namespace snake {
+	/*
+	 * @brief Bump allocator for the bodies of `rollout_state`s, one per search thread.
+	 *
+	 * `reset()` after every rollout frees everything at once. Blocks are never moved, so
+	 * bodies stay put while the arena grows; a reset that finds more than one block
+	 * replaces them with a single one as large as all of them, so a thread that keeps
+	 * its arena settles on one block and stops allocating.
+	 */
+	class rollout_arena {
+	private:
+		std::vector<std::unique_ptr<std::uint16_t[]>> blocks;
+		std::vector<size_t> sizes;
+		size_t used = 0;
+		size_t reserved = 0;
+
+	public:
+		explicit rollout_arena(size_t cells = 1 << 16) {
+			blocks.emplace_back(new std::uint16_t[cells]);
+			sizes.push_back(cells);
+		}
+
+		rollout_arena(const rollout_arena&) = delete;
+		rollout_arena& operator=(const rollout_arena&) = delete;
+		rollout_arena(rollout_arena&&) = default;
+		rollout_arena& operator=(rollout_arena&&) = default;
+
+		std::uint16_t* allocate(size_t count) {
+			if (used + count > sizes.back()) {
+				reserved += sizes.back();
+				size_t size = std::max(sizes.back() * 2, count);
+				blocks.emplace_back(new std::uint16_t[size]);
+				sizes.push_back(size);
+				used = 0;
+			}
+			std::uint16_t* cells = blocks.back().get() + used;
+			used += count;
+			return cells;
+		}
+
+		void reset() {
+			if (blocks.size() > 1) {
+				size_t total = reserved + sizes.back();
+				blocks.clear();
+				sizes.clear();
+				blocks.emplace_back(new std::uint16_t[total]);
+				sizes.push_back(total);
+				reserved = 0;
+			}
+			used = 0;
+		}
+
+		/// Cells the arena holds in all of its blocks.
+		size_t get_capacity() const { return reserved + sizes.back(); }
+	};
+
+	/*************************************************************************************
+	 * CLASS: `rollout_state`
+	 *
+	 * Everything `SnakeGame::tick()` depends on, in a form that forks in a few hundred
+	 * bytes: the body as board cells (`uint16`, tail first) in storage taken from a
+	 * `rollout_arena`, an occupancy bitboard, the food cell and the food engine. Even
+	 * `SnakeGame::fork()` copies 12-byte segments into a heap block of its own.
+	 *
+	 * `step()` plays exactly like `move()` + `tick()`, food draws included, so a state
+	 * made by `from_game()` stays in lockstep with the game for the same moves. The one
+	 * difference is that a move onto a wall or the body ends the state on that step,
+	 * where `tick()` only notices on the next one. A search that should not know where
+	 * food will appear re-seeds the engine with `reseed()` after forking.
+	 *************************************************************************************/
+
+	class rollout_state {
+	public:
+		static constexpr int width = SnakeGame::boardWidth;
+		static constexpr int height = SnakeGame::boardHeight;
+		static constexpr std::uint32_t cells = std::uint32_t(width * height);
+		static constexpr std::uint32_t words = (cells + 63) / 64;
+		static constexpr std::uint16_t no_food = 0xFFFF;
+		/// Room past the body a fork leaves for moves before its cells are compacted.
+		static constexpr std::uint32_t default_headroom = 64;
+
+	private:
+		std::uint64_t occupied[words];
+		std::uint16_t* body = nullptr;       ///< body[begin, end): tail first, head last
+		std::uint32_t begin = 0, end = 0, capacity = 0;
+		rollout_arena* arena = nullptr;
+		SnakeGame::rng_type gen;
+		std::uint16_t food = no_food;
+		std::uint8_t direction = 0;          ///< `direction_index()` of the last move
+		bool alive = true;
+		std::uint32_t score = 0;
+		std::uint64_t ticks = 0;
+
+		static int popcount(std::uint64_t word) {
+			word = word - ((word >> 1) & 0x5555555555555555ull);
+			word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+			word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			return int((word * 0x0101010101010101ull) >> 56);
+		}
+
+		void set(std::uint32_t cell) { occupied[cell >> 6] |= std::uint64_t(1) << (cell & 63); }
+		void clear(std::uint32_t cell) { occupied[cell >> 6] &= ~(std::uint64_t(1) << (cell & 63)); }
+
+		/// Makes room for one more head cell: slides the body down, or moves it to a larger block.
+		/// Either way one cell stays free in front of the tail, where growing puts its copy.
+		void make_room() {
+			const std::uint32_t length = get_length();
+			if (begin > 1) {
+				std::memmove(body + 1, body + begin, length * sizeof(std::uint16_t));
+			}
+			else {
+				std::uint32_t larger = capacity * 2 + default_headroom;
+				std::uint16_t* moved = arena->allocate(larger);
+				std::memcpy(moved + 1, body + begin, length * sizeof(std::uint16_t));
+				body = moved;
+				capacity = larger;
+			}
+			begin = 1;
+			end = length + 1;
+		}
+
+		/// `SnakeGame::generateApple()` over the bitboard: 16 random probes, then a draw among the free cells.
+		void place_food() {
+			if (get_length() >= cells) {
+				food = no_food;
+				return;
+			}
+			for (int attempt = 0; attempt < 16; ++attempt) {
+				std::uint32_t x = bounded(gen, width), y = bounded(gen, height);
+				food = std::uint16_t(y * width + x);
+				if (!is_occupied(food)) return;
+			}
+			std::uint32_t taken = 0;
+			for (std::uint32_t w = 0; w < words; ++w) taken += popcount(occupied[w]);
+			std::uint32_t pick = bounded(gen, cells - taken);
+			for (std::uint32_t w = 0;; ++w) {
+				std::uint64_t free = ~occupied[w];
+				int count = popcount(free);
+				if (pick >= std::uint32_t(count)) {
+					pick -= count;
+					continue;
+				}
+				for (; pick; --pick) free &= free - 1;
+				int bit = 0;
+				while (!(free >> bit & 1)) ++bit;
+				food = std::uint16_t(w * 64 + bit);
+				return;
+			}
+		}
+
+	public:
+		rollout_state() = default;
+
+		/// The state of `game`, its body stored in `arena` with `headroom` spare cells.
+		static rollout_state from_game(const SnakeGame& game, rollout_arena& arena, std::uint32_t headroom = default_headroom) {
+			rollout_state state;
+			std::memset(state.occupied, 0, sizeof(state.occupied));
+			const auto& body = game.getBody();
+			const std::uint32_t length = std::uint32_t(body.get_size());
+			state.arena = &arena;
+			state.capacity = length + headroom;
+			state.body = arena.allocate(state.capacity);
+			state.end = length;
+			for (std::uint32_t i = 0; i < length; ++i) {
+				sf::Vector2i cell = SnakeGame::cellOf(body[length - 1 - i].coords);
+				if (cell.x < 0 || cell.y < 0 || cell.x >= width || cell.y >= height) {
+					// only the head can be off the board, after a fatal move
+					state.alive = false;
+					cell.x = std::clamp(cell.x, 0, width - 1);
+					cell.y = std::clamp(cell.y, 0, height - 1);
+				}
+				state.body[i] = std::uint16_t(cell.y * width + cell.x);
+				state.set(state.body[i]);
+			}
+			state.alive = state.alive && !game.checkCollision() && !game.isWon();
+			state.gen = game.getRng();
+			const int food = SnakeGame::cellIndex(game.getFood());
+			state.food = food < 0 ? no_food : std::uint16_t(food);
+			state.direction = direction_index(game.getDirection());
+			state.score = game.getScore();
+			state.ticks = game.getTicks();
+			return state;
+		}
+
+		/// A copy of this state whose body lives in `into`: the live cells plus `headroom`, and the bitboard.
+		rollout_state fork(rollout_arena& into, std::uint32_t headroom = default_headroom) const {
+			rollout_state copy;
+			std::memcpy(copy.occupied, occupied, sizeof(occupied));
+			copy.arena = &into;
+			copy.capacity = get_length() + headroom;
+			copy.body = into.allocate(copy.capacity);
+			std::memcpy(copy.body, body + begin, get_length() * sizeof(std::uint16_t));
+			copy.end = get_length();
+			copy.gen = gen;
+			copy.food = food;
+			copy.direction = direction;
+			copy.alive = alive;
+			copy.score = score;
+			copy.ticks = ticks;
+			return copy;
+		}
+
+		void reseed(std::uint64_t seed) { gen = SnakeGame::rng_type(seed); }
+
+		/*************************************************************************************
+		 * STEP FUNCTION: `step(std::uint8_t action)`
+		 *
+		 * One tick with `action` (`direction_index()` order; turning back keeps going
+		 * straight). Returns false, and the state is over, when the move hits a wall or
+		 * the body, or when the last move filled the board.
+		 *************************************************************************************/
+
+		bool step(std::uint8_t action) {
+			if (!alive) return false;
+			if (get_length() >= cells) return alive = false;
+			if ((action ^ direction) == 2) action = direction;
+			direction = action;
+			++ticks;
+
+			const std::uint32_t from = get_head();
+			const int x = int(from % width) + (action == 1) - (action == 3);
+			const int y = int(from / width) + (action == 2) - (action == 0);
+			if (x < 0 || y < 0 || x >= width || y >= height) return alive = false;
+			const std::uint16_t to = std::uint16_t(y * width + x);
+
+			// the tail moves first, so the head may follow it into its cell; growing repeats the tail cell, which then stays
+			const std::uint16_t tail = body[begin++];
+			if (begin == end || body[begin] != tail) clear(tail);
+			if (is_occupied(to)) return alive = false;
+			if (end == capacity) make_room();
+			body[end++] = to;
+			set(to);
+
+			if (to == food) {
+				// SnakeGame::add_snake(): a copy of the new tail, or for a lone head the cell it left
+				const std::uint16_t grown = end - begin == 1 ? tail : body[begin];
+				body[--begin] = grown;
+				set(grown);
+				++score;
+				place_food();
+			}
+			return true;
+		}
+
+		bool is_alive() const { return alive; }
+		bool is_won() const { return get_length() >= cells; }
+		bool is_occupied(std::uint32_t cell) const { return (occupied[cell >> 6] >> (cell & 63)) & 1; }
+		std::uint32_t get_head() const { return body[end - 1]; }
+		std::uint32_t get_tail() const { return body[begin]; }
+		std::uint32_t get_length() const { return end - begin; }
+		std::uint16_t get_food() const { return food; }
+		std::uint8_t get_direction() const { return direction; }
+		std::uint32_t get_score() const { return score; }
+		std::uint64_t get_ticks() const { return ticks; }
+
+		/// Cell `x, y` is off the board or taken by the body.
+		bool is_blocked(int x, int y) const {
+			return x < 0 || y < 0 || x >= width || y >= height || is_occupied(std::uint32_t(y * width + x));
+		}
+	};
+}
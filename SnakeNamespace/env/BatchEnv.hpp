@@ -0,0 +1,185 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/env/SnakeEnv.h"
+#include "SnakeNamespace/random/Random.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+#include "SnakeNamespace/threading/ThreadPool.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * CLASS: `batch_env`
+	 *
+	 * `num_envs` `SnakeGame`s stepped together for reinforcement learning; the C API in
+	 * `SnakeEnv.h` is a thin wrapper around it. Games live in one array, forked from a
+	 * blank game so each body holds only its live segments instead of the whole board's
+	 * reservation (57.6 KB per game), and are restarted with `SnakeGame::reset()`, which
+	 * keeps the storage. A body grows only past the longest snake its env has had, so
+	 * steps soon stop allocating. Observations are patched in place (old tail, old and
+	 * new head, food): a step touches a handful of cells per game instead of all 14400
+	 * bytes of its planes.
+	 *
+	 * A step follows `SnakeGame::tick()`, except that a move onto a wall or the body ends
+	 * the episode on that step: `tick()` itself only notices on the next one, whatever
+	 * action comes then.
+	 *************************************************************************************/
+
+	class batch_env {
+	public:
+		static constexpr int width = SnakeGame::boardWidth;
+		static constexpr int height = SnakeGame::boardHeight;
+		static constexpr size_t cells = size_t(width) * height;
+		static constexpr size_t observation_size = SNAKE_ENV_PLANES * cells;
+		static_assert(width == SNAKE_ENV_WIDTH && height == SNAKE_ENV_HEIGHT, "SnakeEnv.h must describe the SnakeGame board");
+
+	private:
+		struct slot {
+			std::uint32_t episode = 0;       ///< episodes started
+			std::uint64_t steps = 0;
+			std::uint32_t hungry = 0;        ///< steps since the last food
+			snake_env_episode last{};
+		};
+
+		snake_env_config config;
+		std::vector<SnakeGame> games;
+		std::unique_ptr<slot[]> slots;
+		std::uint8_t* observations = nullptr;
+		float* rewards = nullptr;
+		std::uint8_t* dones = nullptr;
+		const std::uint8_t* actions = nullptr;
+		std::optional<thread_pool> pool;
+		// built once: a std::function per step would be a per-step cost of its own
+		std::function<void(size_t, size_t)> step_range;
+
+		std::uint32_t episode_seed(size_t index) const {
+			std::uint64_t state = config.seed ^ (std::uint64_t(index) << 32) ^ slots[index].episode;
+			return std::uint32_t(splitmix64(state) >> 32);
+		}
+
+		void start(size_t index) {
+			slot& s = slots[index];
+			games[index].reset(episode_seed(index));
+			++s.episode;
+			s.steps = 0;
+			s.hungry = 0;
+			if (observations) write_observation(games[index], observations + index * observation_size);
+		}
+
+		void step_one(size_t index) {
+			SnakeGame& game = games[index];
+			slot& s = slots[index];
+			const auto& body = game.getBody();
+			const int old_head = SnakeGame::cellIndex(game.getHead());
+			const int old_tail = SnakeGame::cellIndex(body[body.get_size() - 1].coords);
+			const sf::Vector2f old_food = game.getFood();
+			const unsigned int old_score = game.getScore();
+
+			game.move(direction_key(actions[index]));
+			bool alive = game.tick() && !game.checkCollision();
+			bool won = alive && game.isWon();
+			++s.steps;
+
+			float reward = config.step_reward;
+			if (game.getScore() != old_score) {
+				reward += config.food_reward * float(game.getScore() - old_score);
+				s.hungry = 0;
+			}
+			else
+				++s.hungry;
+			if (!alive) reward += config.death_reward;
+			if (won) reward += config.win_reward;
+
+			std::uint8_t done = !alive || won ? SNAKE_ENV_TERMINATED
+				: config.stall_steps && s.hungry >= config.stall_steps ? SNAKE_ENV_TRUNCATED : SNAKE_ENV_RUNNING;
+			rewards[index] = reward;
+			dones[index] = done;
+			if (done) {
+				s.last = { s.episode, game.getSeed(), game.getScore(), s.steps, done };
+				start(index);
+				return;
+			}
+
+			std::uint8_t* planes = observations + index * observation_size;
+			std::uint8_t* body_plane = planes + SNAKE_ENV_PLANE_BODY * cells;
+			std::uint8_t* head_plane = planes + SNAKE_ENV_PLANE_HEAD * cells;
+			std::uint8_t* food_plane = planes + SNAKE_ENV_PLANE_FOOD * cells;
+			const int new_head = SnakeGame::cellIndex(game.getHead());
+			// growing repeats the tail segment, which then stays where it was
+			if (SnakeGame::cellIndex(body[body.get_size() - 1].coords) != old_tail) body_plane[old_tail] = 0;
+			if (body.get_size() > 1) body_plane[old_head] = 1;
+			head_plane[old_head] = 0;
+			head_plane[new_head] = 1;
+			if (game.getFood() != old_food) {
+				if (old_food.x >= 0) food_plane[SnakeGame::cellIndex(old_food)] = 0;
+				if (game.getFood().x >= 0) food_plane[SnakeGame::cellIndex(game.getFood())] = 1;
+			}
+		}
+
+	public:
+		/// Throws std::bad_alloc when the games do not fit in memory, std::system_error when threads cannot start.
+		explicit batch_env(const snake_env_config& config_) : config(config_) {
+			config.num_envs = std::max<std::uint32_t>(config.num_envs, 1);
+			const SnakeGame blank{ 0u };
+			games.reserve(config.num_envs);
+			for (size_t i = 0; i < config.num_envs; ++i) games.push_back(blank.fork());
+			slots.reset(new slot[config.num_envs]);
+			for (size_t i = 0; i < config.num_envs; ++i) start(i);
+			if (config.threads > 1) pool.emplace(config.threads);
+			step_range = [this](size_t lo, size_t hi) {
+				for (size_t i = lo; i < hi; ++i) step_one(i);
+			};
+		}
+
+		batch_env(const batch_env&) = delete;
+		batch_env& operator=(const batch_env&) = delete;
+
+		/// The planes of `game` as `SnakeEnv.h` lays them out, written in full into `out`.
+		static void write_observation(const SnakeGame& game, std::uint8_t* out) {
+			std::memset(out, 0, observation_size);
+			const auto& body = game.getBody();
+			for (size_t i = 1; i < body.get_size(); ++i) out[SNAKE_ENV_PLANE_BODY * cells + SnakeGame::cellIndex(body[i].coords)] = 1;
+			out[SNAKE_ENV_PLANE_HEAD * cells + SnakeGame::cellIndex(game.getHead())] = 1;
+			if (game.getFood().x >= 0) out[SNAKE_ENV_PLANE_FOOD * cells + SnakeGame::cellIndex(game.getFood())] = 1;
+		}
+
+		void bind(std::uint8_t* observations_, float* rewards_, std::uint8_t* dones_) {
+			observations = observations_;
+			rewards = rewards_;
+			dones = dones_;
+			for (size_t i = 0; i < config.num_envs; ++i) {
+				write_observation(games[i], observations + i * observation_size);
+				rewards[i] = 0;
+				dones[i] = SNAKE_ENV_RUNNING;
+			}
+		}
+
+		bool is_bound() const { return observations && rewards && dones; }
+
+		void reset() {
+			for (size_t i = 0; i < config.num_envs; ++i) start(i);
+		}
+
+		/// Steps every game with `actions_[i]`; requires bound buffers.
+		void step(const std::uint8_t* actions_) {
+			actions = actions_;
+			if (pool) pool->parallel_for(0, config.num_envs, std::max<size_t>(1, config.num_envs / (pool->get_thread_count() * 8)), step_range);
+			else step_range(0, config.num_envs);
+		}
+
+		std::uint32_t get_num_envs() const { return config.num_envs; }
+		const SnakeGame& get_game(size_t index) const { return games[index]; }
+		/// Heap bytes the bodies of all games hold.
+		size_t get_body_bytes() const {
+			size_t capacity = 0;
+			for (const SnakeGame& game : games) capacity += game.getBody().get_capacity();
+			return capacity * sizeof(SnakeGame::SnakeSegment);
+		}
+		const snake_env_episode& get_last_episode(size_t index) const { return slots[index].last; }
+	};
+}
@@ -0,0 +1,381 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SNAKE_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC compiles any intrinsic without /arch; GCC and Clang need the target per function
+#define SNAKE_TARGET_AVX2
+#define SNAKE_TARGET_SSE2
+#else
+#define SNAKE_TARGET_AVX2 __attribute__((target("avx2")))
+#define SNAKE_TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+#else
+#define SNAKE_SIMD_X86 0
+#endif
+
+namespace snake {
+	/// Instruction sets the bitplane encoder can expand bits with; `detect_simd_level()` picks the best one present.
+	enum class simd_level { scalar, sse2, avx2 };
+
+	inline const char* simd_level_name(simd_level level) {
+		return level == simd_level::avx2 ? "avx2" : level == simd_level::sse2 ? "sse2" : "scalar";
+	}
+
+	inline simd_level detect_simd_level() {
+#if SNAKE_SIMD_X86 && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int leaves = info[0];
+		__cpuid(info, 1);
+		const bool sse2 = info[3] & (1 << 26);
+		// AVX state must also be enabled by the OS (OSXSAVE, then XCR0 bits 1 and 2)
+		const bool avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+		if (avx && leaves >= 7) {
+			__cpuidex(info, 7, 0);
+			if (info[1] & (1 << 5)) return simd_level::avx2;
+		}
+		return sse2 ? simd_level::sse2 : simd_level::scalar;
+#elif SNAKE_SIMD_X86
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") ? simd_level::avx2 : __builtin_cpu_supports("sse2") ? simd_level::sse2 : simd_level::scalar;
+#else
+		return simd_level::scalar;
+#endif
+	}
+
+	namespace bitplane_detail {
+		/// The low `count` (0 to 64) bits set.
+		inline std::uint64_t ones(int count) {
+			return count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+		}
+
+		/// `count` (at most 64) bits of `bits` from bit `pos` on; `bits` must have a readable word past the last one used.
+		inline std::uint64_t get_bits(const std::uint64_t* bits, size_t pos, int count) {
+			size_t word = pos >> 6;
+			int shift = int(pos & 63);
+			// branch-free: rows of a window start at every bit offset, so a test on the shift mispredicts
+			std::uint64_t value = bits[word] >> shift | (bits[word + 1] << 1) << (63 - shift);
+			return value & ones(count);
+		}
+
+		/// Writes a bit stream word by word, so consecutive rows never read back memory.
+		class bit_appender {
+		private:
+			std::uint64_t* word;
+			std::uint64_t pending = 0;
+			int filled = 0;
+
+		public:
+			explicit bit_appender(std::uint64_t* out) : word(out) {}
+
+			/// Appends the low `count` (1 to 64) bits of `value`, whose higher bits must be clear.
+			void append(std::uint64_t value, int count) {
+				pending |= value << filled;
+				filled += count;
+				if (filled < 64) return;
+				*word++ = pending;
+				filled -= 64;
+				pending = filled ? value >> (count - filled) : 0;
+			}
+
+			/// Writes the last, partial word.
+			void finish() {
+				if (filled) *word = pending;
+			}
+		};
+
+		/// Bit k of `byte` into byte k of the result: one multiply and an add instead of eight tests.
+		inline std::uint64_t spread_byte(std::uint8_t byte) {
+			std::uint64_t spread = (byte * 0x0101010101010101ull) & 0x8040201008040201ull;
+			return ((spread + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull;
+		}
+
+		/// Writes bit i of `bits` (LSB first) as byte 0 or 1 to `out[i]`, from bit `from` to `count`.
+		inline void expand_scalar(const std::uint64_t* bits, size_t from, size_t count, std::uint8_t* out) {
+			size_t i = from;
+			for (; i + 8 <= count; i += 8) {
+				std::uint64_t bytes = spread_byte(std::uint8_t(get_bits(bits, i, 8)));
+				std::memcpy(out + i, &bytes, 8);
+			}
+			for (; i < count; ++i) out[i] = std::uint8_t((bits[i >> 6] >> (i & 63)) & 1);
+		}
+
+#if SNAKE_SIMD_X86
+		SNAKE_TARGET_SSE2 inline void expand_sse2(const std::uint64_t* bits, size_t from, size_t count, std::uint8_t* out) {
+			// byte k of a 16-bit chunk tests bit k % 8 of chunk byte k / 8
+			const __m128i select = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+			const __m128i one = _mm_set1_epi8(1);
+			size_t i = from;
+			for (; i + 16 <= count; i += 16) {
+				std::uint32_t chunk = std::uint32_t(get_bits(bits, i, 16));
+				__m128i lo = _mm_set1_epi8(char(chunk & 0xFF)), hi = _mm_set1_epi8(char(chunk >> 8));
+				__m128i v = _mm_unpacklo_epi64(lo, hi);
+				v = _mm_cmpeq_epi8(_mm_and_si128(v, select), select);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(v, one));
+			}
+			expand_scalar(bits, i, count, out);
+		}
+
+		SNAKE_TARGET_AVX2 inline void expand_avx2(const std::uint64_t* bits, size_t from, size_t count, std::uint8_t* out) {
+			// broadcast 32 bits, move chunk byte k / 8 to output byte k (the shuffle stays within each 128-bit lane), test bit k % 8
+			const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+				2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+			const __m256i select = _mm256_set1_epi64x(std::int64_t(0x8040201008040201ull));
+			const __m256i one = _mm256_set1_epi8(1);
+			size_t i = from;
+			for (; i + 32 <= count; i += 32) {
+				__m256i v = _mm256_set1_epi32(int(std::uint32_t(get_bits(bits, i, 32))));
+				v = _mm256_shuffle_epi8(v, spread);
+				v = _mm256_cmpeq_epi8(_mm256_and_si256(v, select), select);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_and_si256(v, one));
+			}
+			expand_sse2(bits, i, count, out);
+		}
+#endif
+
+		/// Bits to 0/1 bytes with the widest path `level` allows.
+		inline void expand(simd_level level, const std::uint64_t* bits, size_t count, std::uint8_t* out) {
+#if SNAKE_SIMD_X86
+			if (level == simd_level::avx2) return expand_avx2(bits, 0, count, out);
+			if (level == simd_level::sse2) return expand_sse2(bits, 0, count, out);
+#endif
+			expand_scalar(bits, 0, count, out);
+		}
+	}
+
+	/// Part of the board an encoder emits. Egocentric windows are centred on the head; others start at the top-left cell.
+	struct bitplane_window {
+		int width = SnakeGame::boardWidth;
+		int height = SnakeGame::boardHeight;
+		bool egocentric = false;
+
+		/// A `(2 * radius + 1)` square around the head.
+		static bitplane_window around_head(int radius) { return { 2 * radius + 1, 2 * radius + 1, true }; }
+		bool is_whole_board() const { return !egocentric && width == SnakeGame::boardWidth && height == SnakeGame::boardHeight; }
+		size_t cells() const { return size_t(width) * size_t(height); }
+	};
+
+	/*************************************************************************************
+	 * CLASS: `bitplane_encoder`
+	 *
+	 * Keeps one bitboard per plane of a `SnakeGame` (occupancy, head, food, and each
+	 * segment's direction towards the head as two bits) and emits them, whole or as a
+	 * window, either packed (1 bit per cell) or as 0/1 bytes. `update()` after a tick
+	 * patches the few cells that changed; only a new game or a skipped tick goes back
+	 * over the body. Emitting whole-board packed planes is a copy; bytes are expanded
+	 * 32 (AVX2) or 16 (SSE2) cells at a time. Windows are first cut out row by row
+	 * with word shifts, then expanded the same way.
+	 *
+	 * Output layout: plane after plane, each `window.cells()` cells row-major. Packed
+	 * planes are bit streams (cell i is bit i % 8 of byte i / 8), each padded to whole
+	 * bytes. Cells off the board, which only windows can reach, read as occupied.
+	 *************************************************************************************/
+
+	class bitplane_encoder {
+	public:
+		enum plane { occupancy, head, food, direction_low, direction_high, plane_count };
+
+		static constexpr int width = SnakeGame::boardWidth;
+		static constexpr int height = SnakeGame::boardHeight;
+		static constexpr size_t cells = size_t(width) * height;
+		/// One spare word, so a two-word read at the last cell stays inside the plane.
+		static constexpr size_t words = (cells + 63) / 64 + 1;
+
+	private:
+		simd_level level;
+		std::uint64_t planes[plane_count][words] = {};
+		std::uint64_t ticks = ~std::uint64_t(0);
+		std::uint32_t seed = 0;
+		size_t length = 0;
+		int head_cell = -1, tail_cell = -1;
+		int head_x = 0, head_y = 0;          ///< kept apart from `head_cell`: after a fatal move the head is off the board
+		sf::Vector2f food_coords;
+		mutable std::vector<std::uint64_t> window_bits;
+
+		void track_head(sf::Vector2f coords) {
+			const sf::Vector2i cell = SnakeGame::cellOf(coords);
+			head_x = cell.x;
+			head_y = cell.y;
+		}
+
+		void set(plane p, int cell, bool on) {
+			if (cell < 0) return;
+			std::uint64_t bit = std::uint64_t(1) << (cell & 63);
+			if (on) planes[p][cell >> 6] |= bit;
+			else planes[p][cell >> 6] &= ~bit;
+		}
+
+		void set_direction(int cell, std::uint8_t direction) {
+			set(direction_low, cell, direction & 1);
+			set(direction_high, cell, direction & 2);
+		}
+
+		/// Cuts plane `p` of `window` out as a bit stream into `out` (`window.cells()` bits).
+		void cut_window(plane p, const bitplane_window& window, int x0, int y0, std::uint64_t* out) const {
+			using bitplane_detail::get_bits;
+			using bitplane_detail::ones;
+			const bool walls = p == occupancy;
+			// the columns off the board are the same in every row
+			const int left = std::clamp(-x0, 0, window.width);
+			const int right = std::clamp(x0 + window.width - width, 0, window.width - left);
+			const int inside = window.width - left - right;
+			bitplane_detail::bit_appender stream(out);
+			if (window.width <= 64) {
+				// a row is one word: the board's cells shifted past the left wall, the walls ORed in
+				const std::uint64_t side_walls = walls ? ones(left) | (right ? ones(right) << (window.width - right) : 0) : 0;
+				const std::uint64_t wall_row = walls ? ones(window.width) : 0;
+				for (int y = y0; y < y0 + window.height; ++y) {
+					stream.append(y < 0 || y >= height ? wall_row
+						: (inside ? get_bits(planes[p], size_t(y) * width + size_t(x0 + left), inside) << left : 0) | side_walls, window.width);
+				}
+				stream.finish();
+				return;
+			}
+			for (int y = y0; y < y0 + window.height; ++y) {
+				const bool off_board = y < 0 || y >= height;
+				for (int x = 0; x < window.width; x += 64) {
+					const int count = std::min(64, window.width - x);
+					std::uint64_t bits = 0;
+					if (walls) {
+						// wall cells of this word: all of them on an off-board row, else those left or right of the board
+						bits = off_board ? ones(count) : ones(std::clamp(left - x, 0, count))
+							| (~ones(std::clamp(window.width - right - x, 0, count)) & ones(count));
+					}
+					// board cells of this word, [from, to) within it
+					const int from = std::clamp(left - x, 0, count), to = std::clamp(left + inside - x, 0, count);
+					if (!off_board && to > from)
+						bits |= get_bits(planes[p], size_t(y) * width + size_t(x0 + x + from), to - from) << from;
+					stream.append(bits, count);
+				}
+			}
+			stream.finish();
+		}
+
+		/// Calls `emit(p, bits)` with each plane of `window` as a bit stream (with a spare word at the end).
+		template <typename Emit>
+		void for_each_window_plane(const bitplane_window& window, Emit&& emit) const {
+			if (window.is_whole_board()) {
+				for (int p = 0; p < plane_count; ++p) emit(p, planes[p]);
+				return;
+			}
+			int x0 = 0, y0 = 0;
+			if (window.egocentric) {
+				x0 = head_x - window.width / 2;
+				y0 = head_y - window.height / 2;
+			}
+			const size_t stream_words = (window.cells() + 63) / 64 + 1;
+			window_bits.resize(stream_words);
+			for (int p = 0; p < plane_count; ++p) {
+				cut_window(plane(p), window, x0, y0, window_bits.data());
+				emit(p, window_bits.data());
+			}
+		}
+
+	public:
+		explicit bitplane_encoder(simd_level level_ = detect_simd_level()) : level(level_) {}
+
+		simd_level get_simd_level() const { return level; }
+		void set_simd_level(simd_level level_) { level = level_; }
+
+		/// Builds every plane from the body: O(length).
+		void rebuild(const SnakeGame& game) {
+			std::memset(planes, 0, sizeof(planes));
+			const auto& body = game.getBody();
+			for (size_t i = 0; i < body.get_size(); ++i) {
+				int cell = SnakeGame::cellIndex(body[i].coords);
+				set(occupancy, cell, true);
+				// growing repeats the tail segment; the copy keeps the direction of the one it copies
+				if (i == 0 || body[i].coords == body[i - 1].coords) continue;
+				sf::Vector2f step = body[i - 1].coords - body[i].coords;
+				set_direction(cell, step.y < 0 ? 0 : step.x > 0 ? 1 : step.y > 0 ? 2 : 3);
+			}
+			head_cell = SnakeGame::cellIndex(game.getHead());
+			// last, as in update(): a head that ran into the body shows its own direction there
+			set_direction(head_cell, direction_index(game.getDirection()));
+			tail_cell = SnakeGame::cellIndex(body[body.get_size() - 1].coords);
+			track_head(game.getHead());
+			set(head, head_cell, true);
+			food_coords = game.getFood();
+			set(food, SnakeGame::cellIndex(food_coords), true);
+			length = body.get_size();
+			ticks = game.getTicks();
+			seed = game.getSeed();
+		}
+
+		/// Brings the planes up to `game`: O(1) when it is one tick past the last call, otherwise a `rebuild()`.
+		void update(const SnakeGame& game) {
+			if (game.getSeed() != seed) {
+				rebuild(game);
+				return;
+			}
+			if (game.getTicks() == ticks && game.getLength() == length) return;
+			const int new_head = SnakeGame::cellIndex(game.getHead());
+			const auto& body = game.getBody();
+			const bool one_step = head_cell >= 0 && new_head != head_cell
+				&& std::abs(new_head % width - head_cell % width) + std::abs(new_head / width - head_cell / width) == 1;
+			if (game.getTicks() != ticks + 1 || game.getLength() < length || game.getLength() > length + 1 || !one_step) {
+				rebuild(game);
+				return;
+			}
+
+			const std::uint8_t direction = direction_index(game.getDirection());
+			const int new_tail = SnakeGame::cellIndex(body[body.get_size() - 1].coords);
+			if (new_tail != tail_cell) {
+				set(occupancy, tail_cell, false);
+				set_direction(tail_cell, 0);
+			}
+			// the old head becomes the neck and points at the new head, unless the snake is a lone head
+			if (body.get_size() > 1) set_direction(head_cell, direction);
+			set(head, head_cell, false);
+			set(head, new_head, true);
+			set(occupancy, new_head, true);
+			set_direction(new_head, direction);
+			if (game.getFood() != food_coords) {
+				set(food, SnakeGame::cellIndex(food_coords), false);
+				food_coords = game.getFood();
+				set(food, SnakeGame::cellIndex(food_coords), true);
+			}
+			head_cell = new_head;
+			tail_cell = new_tail;
+			track_head(game.getHead());
+			length = body.get_size();
+			ticks = game.getTicks();
+		}
+
+		static size_t packed_plane_size(const bitplane_window& window = {}) { return (window.cells() + 7) / 8; }
+		static size_t packed_size(const bitplane_window& window = {}) { return plane_count * packed_plane_size(window); }
+		static size_t bytes_size(const bitplane_window& window = {}) { return plane_count * window.cells(); }
+
+		/// `packed_size(window)` bytes: every plane at 1 bit per cell.
+		void encode_packed(std::uint8_t* out, const bitplane_window& window = {}) const {
+			const size_t plane_bytes = packed_plane_size(window);
+			for_each_window_plane(window, [&](int p, const std::uint64_t* bits) {
+				// little-endian words are already the bit stream's byte order
+				std::memcpy(out + p * plane_bytes, bits, plane_bytes);
+			});
+		}
+
+		/// `bytes_size(window)` bytes: every plane at one 0/1 byte per cell.
+		void encode_bytes(std::uint8_t* out, const bitplane_window& window = {}) const {
+			for_each_window_plane(window, [&](int p, const std::uint64_t* bits) {
+				bitplane_detail::expand(level, bits, window.cells(), out + p * window.cells());
+			});
+		}
+
+		bool test(plane p, int x, int y) const {
+			if (x < 0 || y < 0 || x >= width || y >= height) return p == occupancy;
+			int cell = y * width + x;
+			return (planes[p][cell >> 6] >> (cell & 63)) & 1;
+		}
+	};
+}
@@ -0,0 +1,97 @@
+/*
+ * @brief C interface of the batched Snake environment (`snake::batch_env`), for RL trainers.
+ *
+ * One `snake_env` steps `num_envs` games of `SnakeGame` together. The caller owns every
+ * buffer and binds it once; `snake_env_step()` then writes rewards, done flags and
+ * observations straight into them, so nothing is copied out, and nothing is allocated
+ * per step once every body has grown to the longest snake its env has had. A finished game restarts at once with a new seed (auto-reset): the
+ * observation of a done env is already the first frame of its next episode, and
+ * `snake_env_last_episode()` tells how the finished one went.
+ *
+ * ## Observations:
+ * `uint8 [num_envs][SNAKE_ENV_PLANES][SNAKE_ENV_HEIGHT][SNAKE_ENV_WIDTH]`, 0 or 1 per cell:
+ * body (every segment but the head), head and food. They are updated in place, only the
+ * cells that changed, so the caller must treat the buffer as read-only between steps.
+ *
+ * ## Actions:
+ * `uint8 [num_envs]`, `SNAKE_ENV_UP` .. `SNAKE_ENV_LEFT`; turning back keeps going straight.
+ *
+ * ## Done flags:
+ * `uint8 [num_envs]`: 0 running, `SNAKE_ENV_TERMINATED` (hit a wall or itself, or filled
+ * the board), `SNAKE_ENV_TRUNCATED` (`stall_steps` without eating).
+ *
+ * The functions are defined by `SnakeEnvApi.hpp`, which one C++ translation unit of the
+ * program or library includes. A `snake_env` must not be used from two threads at once.
+ */
+#ifndef SNAKE_ENV_H
+#define SNAKE_ENV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SNAKE_ENV_API
+#define SNAKE_ENV_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum { SNAKE_ENV_WIDTH = 80, SNAKE_ENV_HEIGHT = 60, SNAKE_ENV_PLANES = 3 };
+enum { SNAKE_ENV_PLANE_BODY = 0, SNAKE_ENV_PLANE_HEAD = 1, SNAKE_ENV_PLANE_FOOD = 2 };
+enum { SNAKE_ENV_UP = 0, SNAKE_ENV_RIGHT = 1, SNAKE_ENV_DOWN = 2, SNAKE_ENV_LEFT = 3 };
+enum { SNAKE_ENV_RUNNING = 0, SNAKE_ENV_TERMINATED = 1, SNAKE_ENV_TRUNCATED = 2 };
+
+typedef struct snake_env snake_env;
+
+typedef struct snake_env_config {
+	uint32_t num_envs;
+	uint64_t seed;           /* episode seeds derive from it; the same seed replays the same batch */
+	uint32_t stall_steps;    /* truncate after this many steps without food; 0 never */
+	uint32_t threads;        /* 0 or 1 steps on the calling thread */
+	float food_reward;
+	float death_reward;
+	float win_reward;
+	float step_reward;
+} snake_env_config;
+
+typedef struct snake_env_episode {
+	uint32_t number;         /* episodes this env has finished so far, this one included */
+	uint32_t seed;
+	uint32_t score;
+	uint64_t steps;
+	uint8_t done;            /* SNAKE_ENV_TERMINATED or SNAKE_ENV_TRUNCATED; 0 before the first episode ends */
+} snake_env_episode;
+
+/* Fills `config` with the defaults: +1 per food, -1 on death, +10 for a full board, 0 per step, 4800 stall steps. */
+SNAKE_ENV_API void snake_env_default_config(snake_env_config* config, uint32_t num_envs);
+
+/* NULL when `config` is invalid, memory ran out or the threads could not start. */
+SNAKE_ENV_API snake_env* snake_env_create(const snake_env_config* config);
+SNAKE_ENV_API void snake_env_destroy(snake_env* env);
+
+SNAKE_ENV_API uint32_t snake_env_num_envs(const snake_env* env);
+/* Bytes of one env's observation; the observation buffer holds `num_envs` of them. */
+SNAKE_ENV_API size_t snake_env_observation_size(void);
+
+/*
+ * Binds the output buffers (observations, num_envs floats, num_envs bytes) and writes every
+ * observation in full. They must stay valid until the next bind or `snake_env_destroy()`.
+ * Returns 0, or -1 when a buffer is NULL.
+ */
+SNAKE_ENV_API int snake_env_bind(snake_env* env, uint8_t* observations, float* rewards, uint8_t* dones);
+
+/* Restarts every game from its next seed and rewrites the observations. */
+SNAKE_ENV_API void snake_env_reset(snake_env* env);
+
+/* Steps every game once. Returns 0, or -1 when no buffers are bound or a body could not grow. */
+SNAKE_ENV_API int snake_env_step(snake_env* env, const uint8_t* actions);
+
+/* The last finished episode of env `index`. Returns 0, or -1 for a bad index. */
+SNAKE_ENV_API int snake_env_last_episode(const snake_env* env, uint32_t index, snake_env_episode* episode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
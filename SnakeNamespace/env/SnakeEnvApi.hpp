@@ -0,0 +1,82 @@
+#pragma once
+#include "SnakeNamespace/env/BatchEnv.hpp"
+
+/*
+ * @brief Definitions of the `SnakeEnv.h` functions over `snake::batch_env`.
+ *
+ * They are not inline, so include this header in exactly one translation unit of the
+ * program or shared library that exports them.
+ */
+
+struct snake_env {
+	snake::batch_env env;
+};
+
+extern "C" {
+	// no exception may cross into C: every entry point that can throw catches all of them
+	SNAKE_ENV_API void snake_env_default_config(snake_env_config* config, uint32_t num_envs) {
+		if (!config) return;
+		*config = { num_envs, 1, snake::batch_env::cells, 1, 1.0f, -1.0f, 10.0f, 0.0f };
+	}
+
+	SNAKE_ENV_API snake_env* snake_env_create(const snake_env_config* config) {
+		if (!config || config->num_envs == 0) return nullptr;
+		try {
+			return new snake_env{ snake::batch_env(*config) };
+		}
+		catch (...) {
+			return nullptr;
+		}
+	}
+
+	SNAKE_ENV_API void snake_env_destroy(snake_env* env) {
+		try {
+			delete env;
+		}
+		catch (...) {}
+	}
+
+	SNAKE_ENV_API uint32_t snake_env_num_envs(const snake_env* env) {
+		return env ? env->env.get_num_envs() : 0;
+	}
+
+	SNAKE_ENV_API size_t snake_env_observation_size(void) {
+		return snake::batch_env::observation_size;
+	}
+
+	SNAKE_ENV_API int snake_env_bind(snake_env* env, uint8_t* observations, float* rewards, uint8_t* dones) {
+		if (!env || !observations || !rewards || !dones) return -1;
+		try {
+			env->env.bind(observations, rewards, dones);
+			return 0;
+		}
+		catch (...) {
+			return -1;
+		}
+	}
+
+	SNAKE_ENV_API void snake_env_reset(snake_env* env) {
+		if (!env) return;
+		try {
+			env->env.reset();
+		}
+		catch (...) {}
+	}
+
+	SNAKE_ENV_API int snake_env_step(snake_env* env, const uint8_t* actions) {
+		if (!env || !env->env.is_bound() || !actions) return -1;
+		try {
+			env->env.step(actions);
+			return 0;
+		}
+		catch (...) {
+			return -1;
+		}
+	}
+
+	SNAKE_ENV_API int snake_env_last_episode(const snake_env* env, uint32_t index, snake_env_episode* episode) {
+		if (!env || !episode || index >= env->env.get_num_envs()) return -1;
+		*episode = env->env.get_last_episode(index);
+		return 0;
+	}
+}
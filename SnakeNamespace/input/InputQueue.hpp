@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "SnakeGame.hpp"
+
+namespace snake {
+	/*
+	 * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+	 *
+	 * `head` is only written by the consumer and `tail` only by the producer, each on its own
+	 * cache line; a slot is published with a release store of `tail` and handed back with a
+	 * release store of `head`. `Capacity` must be a power of two.
+	 */
+	template <typename T, size_t Capacity>
+	class spsc_queue {
+	private:
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+		static constexpr size_t mask = Capacity - 1;
+
+		alignas(64) std::atomic<size_t> head{ 0 };
+		alignas(64) std::atomic<size_t> tail{ 0 };
+		alignas(64) T slots[Capacity];
+
+	public:
+		/// Producer side. Returns false, leaving the queue untouched, when it is full.
+		bool try_push(const T& value) {
+			size_t t = tail.load(std::memory_order_relaxed);
+			if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+			slots[t & mask] = value;
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// Consumer side. Returns false when the queue is empty.
+		bool try_pop(T& value) {
+			size_t h = head.load(std::memory_order_relaxed);
+			if (h == tail.load(std::memory_order_acquire)) return false;
+			value = slots[h & mask];
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// Exact from either side when the other side is idle, a snapshot otherwise.
+		size_t size() const {
+			return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+		}
+
+		static constexpr size_t capacity() { return Capacity; }
+	};
+
+	/*************************************************************************************
+	 * CLASS: `input_queue`
+	 *
+	 * Buffers direction key presses so that quick sequences (W then D inside one tick)
+	 * all take effect, one per tick, instead of the last press overwriting the others.
+	 *
+	 * `push()` may be called from an input thread, `apply()` from the simulation thread.
+	 * `apply()` hands at most one press per game tick to `SnakeGame::move()`, skipping
+	 * presses that would not change the direction (same key or a reversal) at that point.
+	 *************************************************************************************/
+
+	class input_queue {
+	private:
+		struct entry {
+			sf::Keyboard::Scancode key = sf::Keyboard::Scancode::W;
+			std::int64_t pressed_ns = 0;
+		};
+
+		spsc_queue<entry, 16> queue;
+		std::atomic<std::uint64_t> pushed{ 0 };
+		std::atomic<std::uint64_t> dropped{ 0 };
+
+		std::uint64_t applied = 0;
+		std::uint64_t rejected = 0;
+		std::uint64_t applied_tick = ~std::uint64_t(0);
+		std::int64_t last_latency_ns = 0;
+		std::int64_t last_pressed_ns = 0;
+
+		static bool is_turn(sf::Keyboard::Scancode key, sf::Keyboard::Scancode facing) {
+			using sc = sf::Keyboard::Scancode;
+			switch (key) {
+			case sc::W: return facing != sc::W && facing != sc::S;
+			case sc::S: return facing != sc::S && facing != sc::W;
+			case sc::A: return facing != sc::A && facing != sc::D;
+			case sc::D: return facing != sc::D && facing != sc::A;
+			default: return false;
+			}
+		}
+
+	public:
+		static std::int64_t now_ns() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		/// Producer side. Returns false if the press was dropped because the queue is full.
+		bool push(sf::Keyboard::Scancode key, std::int64_t pressed_ns = now_ns()) {
+			pushed.fetch_add(1, std::memory_order_relaxed);
+			if (queue.try_push({ key, pressed_ns })) return true;
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		/// Consumer side; call every frame before `SnakeGame::update()`. Returns true if a press was applied.
+		bool apply(SnakeGame& game) {
+			if (game.getTicks() == applied_tick) return false;
+			entry next;
+			while (queue.try_pop(next)) {
+				if (!is_turn(next.key, game.getDirection())) { ++rejected; continue; }
+				game.move(next.key);
+				applied_tick = game.getTicks();
+				last_pressed_ns = next.pressed_ns;
+				last_latency_ns = now_ns() - next.pressed_ns;
+				++applied;
+				return true;
+			}
+			return false;
+		}
+
+		/// Discards queued presses, e.g. after the game jumped to a loaded state.
+		void clear() {
+			entry discard;
+			while (queue.try_pop(discard)) {}
+			applied_tick = ~std::uint64_t(0);
+		}
+
+		std::uint64_t get_pushed() const { return pushed.load(std::memory_order_relaxed); }
+		std::uint64_t get_dropped() const { return dropped.load(std::memory_order_relaxed); }
+		std::uint64_t get_applied() const { return applied; }
+		std::uint64_t get_rejected() const { return rejected; }
+		/// Press-to-apply time of the press most recently applied.
+		std::int64_t get_last_latency_ns() const { return last_latency_ns; }
+		/// `now_ns()` timestamp of the press most recently applied, 0 before the first.
+		std::int64_t get_last_pressed_ns() const { return last_pressed_ns; }
+		size_t get_pending() const { return queue.size(); }
+	};
+}
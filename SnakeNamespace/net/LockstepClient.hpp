@@ -0,0 +1,199 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <SFML/Network.hpp>
+#include "SnakeNamespace/net/Protocol.hpp"
+#include "SnakeNamespace/net/LockstepServer.hpp"
+#include "SnakeNamespace/bench/BenchUtil.hpp"
+
+namespace snake {
+	struct lockstep_client_report {
+		std::uint64_t ticks_applied = 0;
+		std::uint64_t snapshots = 0;
+		std::uint64_t desyncs = 0;           ///< checksum mismatches; each one is repaired by a snapshot
+		std::uint64_t stale_records = 0;     ///< resent ticks the client already had
+		std::uint64_t dropped = 0;           ///< datagrams thrown away by `set_drop_rate()`
+		std::uint64_t foreign = 0;           ///< datagrams from anywhere but the server, ignored
+		std::uint64_t rejected = 0;          ///< server datagrams that failed validation, ignored
+		std::uint64_t inputs_sent = 0;
+		latency_histogram latency;           ///< from `send_input()` to the tick that applied it arriving
+		net_traffic traffic;
+	};
+
+	/*************************************************************************************
+	 * CLASS: `lockstep_client`
+	 *
+	 * A replica of the server's `versus_game`, kept in step by its tick records. Inputs
+	 * are tagged with the tick they are meant for and resent until the server echoes
+	 * them back. Only datagrams from the server's address and port are read. A record
+	 * is applied only once it fits the game (`versus_game::can_apply()`) and the state
+	 * it leads to has the server's checksum; otherwise the client keeps its state
+	 * untouched, drops it, and acknowledges nothing until a fresh snapshot arrives.
+	 * Single-threaded: one thread calls `poll()` and `send_input()`.
+	 *************************************************************************************/
+
+	class lockstep_client {
+	private:
+		using clock = std::chrono::steady_clock;
+
+		sf::UdpSocket socket;
+		sf::SocketSelector selector;
+		sf::IpAddress server = sf::IpAddress::LocalHost;
+		unsigned short server_port = 0;
+		versus_game game;
+		int player = -1;
+		bool joined = false;
+		bool has_state = false;
+		clock::time_point last_hello;
+		std::vector<input_entry> unconfirmed;
+		std::deque<std::pair<std::uint32_t, clock::time_point>> sent_at;
+		double drop_rate = 0;
+		xoshiro256ss loss_rng{ 1 };
+		lockstep_client_report report;
+		std::vector<std::uint8_t> packet;
+		std::vector<tick_record> records;
+
+		bool lose() {
+			if (drop_rate <= 0 || double(loss_rng() >> 11) * 0x1.0p-53 >= drop_rate) return false;
+			++report.dropped;
+			return true;
+		}
+
+		void send() {
+			if (lose()) return;
+			if (socket.send(packet.data(), packet.size(), server, server_port) == sf::Socket::Status::Done) {
+				++report.traffic.packets_sent;
+				report.traffic.bytes_sent += packet.size();
+			}
+		}
+
+		void send_ack() {
+			write_input(packet, player, has_state ? std::uint32_t(game.get_tick()) : no_ack, unconfirmed);
+			send();
+		}
+
+		void confirm(std::uint32_t applied, clock::time_point now) {
+			unconfirmed.erase(std::remove_if(unconfirmed.begin(), unconfirmed.end(), [&](const input_entry& e) { return e.tick <= applied; }), unconfirmed.end());
+			while (!sent_at.empty() && sent_at.front().first <= applied) {
+				if (sent_at.front().first == applied)
+					report.latency.add(std::chrono::duration<double, std::nano>(now - sent_at.front().second).count());
+				sent_at.pop_front();
+			}
+		}
+
+		/// Applies the records that continue the current state; false when one did not match the server.
+		bool apply_records(clock::time_point now) {
+			for (const tick_record& rec : records) {
+				if (rec.delta.tick <= game.get_tick()) { ++report.stale_records; continue; }
+				// a gap: an older datagram overtook by a newer one was lost; the next packet restarts from the ack
+				if (rec.delta.tick != game.get_tick() + 1) break;
+				if (!game.can_apply(rec.delta) || game.checksum_after(rec.delta) != rec.checksum) return false;
+				game.apply(rec.delta);
+				++report.ticks_applied;
+				if (player >= 0 && rec.input_age[player] != no_input_age)
+					confirm(std::uint32_t(rec.delta.tick - rec.input_age[player]), now);
+			}
+			return true;
+		}
+
+	public:
+		/// Binds a local port and starts saying hello; `poll()` finishes joining.
+		bool connect(sf::IpAddress server_, unsigned short port) {
+			server = server_;
+			server_port = port;
+			if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Status::Done) return false;
+			socket.setBlocking(false);
+			selector.add(socket);
+			write_hello(packet);
+			send();
+			last_hello = clock::now();
+			return true;
+		}
+
+		/// Drops this share of datagrams both ways, to test the recovery paths over loopback.
+		void set_drop_rate(double rate, std::uint64_t seed = 1) {
+			drop_rate = rate;
+			loss_rng = xoshiro256ss(seed);
+		}
+
+		/*************************************************************************************
+		 * POLL FUNCTION: `poll(sf::Time timeout)`
+		 *
+		 * Waits up to `timeout` for datagrams, applies them and acknowledges. Returns
+		 * true when the game moved on (new ticks or a snapshot).
+		 *************************************************************************************/
+
+		bool poll(sf::Time timeout) {
+			auto now = clock::now();
+			if (!joined && now - last_hello > std::chrono::milliseconds(100)) {
+				write_hello(packet);
+				send();
+				last_hello = now;
+			}
+			if (!selector.wait(timeout)) return false;
+
+			bool advanced = false;
+			std::uint8_t buffer[2048];
+			std::size_t received = 0;
+			std::optional<sf::IpAddress> address;
+			unsigned short port = 0;
+			while (socket.receive(buffer, sizeof(buffer), received, address, port) == sf::Socket::Status::Done) {
+				if (!address || *address != server || port != server_port) { ++report.foreign; continue; }
+				if (lose()) continue;
+				++report.traffic.packets_received;
+				report.traffic.bytes_received += received;
+				packet_reader r(buffer, received);
+				if (!r.ok()) continue;
+				now = clock::now();
+
+				if (r.type() == net_message::snapshot) {
+					versus_game::snapshot snap;
+					int seat = -1;
+					if (!read_snapshot(r, seat, snap)) { ++report.rejected; continue; }
+					if (has_state && snap.tick <= game.get_tick()) continue;
+					game.restore(snap);
+					player = seat;
+					joined = has_state = true;
+					++report.snapshots;
+					advanced = true;
+				}
+				else if (r.type() == net_message::state && has_state) {
+					if (!read_state(r, game.get_player_count(), records)) { ++report.rejected; continue; }
+					std::uint64_t before = game.get_tick();
+					if (!apply_records(now)) {
+						++report.desyncs;
+						has_state = false;
+					}
+					advanced = advanced || game.get_tick() != before;
+				}
+			}
+			if (joined && (advanced || !has_state)) send_ack();
+			return advanced;
+		}
+
+		/// Asks to turn `dir` on the next tick; resent with every acknowledgement until echoed.
+		void send_input(versus_game::direction dir) {
+			if (!has_state || player < 0) return;
+			std::uint32_t tick = std::uint32_t(game.get_tick() + 1);
+			if (!unconfirmed.empty() && unconfirmed.back().tick == tick) unconfirmed.back().dir = dir;
+			else {
+				unconfirmed.push_back({ tick, dir });
+				sent_at.emplace_back(tick, clock::now());
+			}
+			++report.inputs_sent;
+			send_ack();
+		}
+
+		bool is_joined() const { return joined; }
+		bool is_over() const { return has_state && game.is_over(); }
+		int get_player() const { return player; }
+		unsigned short get_local_port() const { return socket.getLocalPort(); }
+		const versus_game& get_game() const { return game; }
+		const lockstep_client_report& get_report() const { return report; }
+	};
+}
@@ -0,0 +1,303 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <vector>
+#include <SFML/Network.hpp>
+#include "SnakeNamespace/net/Protocol.hpp"
+
+namespace snake {
+	/// Datagrams and bytes one endpoint moved, UDP payload only.
+	struct net_traffic {
+		std::uint64_t packets_sent = 0;
+		std::uint64_t bytes_sent = 0;
+		std::uint64_t packets_received = 0;
+		std::uint64_t bytes_received = 0;
+	};
+
+	struct lockstep_server_options {
+		unsigned short port = 53000;     ///< 0 picks a free one, see `lockstep_server::get_port()`
+		int players = 2;
+		double tick_hz = 10;             ///< `SnakeGame` speed
+		std::uint64_t seed = 1;
+		std::uint64_t max_ticks = 0;     ///< ends the game after this many ticks; 0 plays until one player is left
+		double linger_seconds = 0.5;     ///< keeps resending the final ticks this long after the game ends
+		int max_spectators = 8;          ///< hellos past the seats and this many watchers are ignored
+		double client_timeout_seconds = 5; ///< a client silent this long is dropped; a player can say hello again to get the seat back
+		std::uint32_t max_input_lead = 8;  ///< inputs tagged further ahead of the game than this are dropped
+	};
+
+	struct lockstep_server_report {
+		std::uint64_t ticks = 0;
+		std::uint64_t clients = 0;
+		std::uint64_t peak_clients = 0;
+		std::uint64_t snapshots_sent = 0;
+		std::uint64_t state_packets_sent = 0;
+		std::uint64_t inputs_applied = 0;
+		std::uint64_t late_inputs = 0;        ///< arrived after the tick they were tagged for; applied on the next one
+		std::uint64_t refused_inputs = 0;     ///< tagged more than `max_input_lead` ticks ahead
+		std::uint64_t refused_clients = 0;    ///< hellos that found every seat and spectator place taken
+		std::uint64_t dropped_clients = 0;    ///< silent for `client_timeout_seconds`
+		std::uint64_t full_state_bytes = 0;   ///< what a snapshot per client per tick would have cost instead
+		double max_tick_lateness_ms = 0;      ///< worst delay of a tick behind its fixed-rate schedule
+		double seconds = 0;
+		net_traffic traffic;
+		std::uint32_t final_checksum = 0;
+	};
+
+	/*************************************************************************************
+	 * CLASS: `lockstep_server`
+	 *
+	 * Owns the authoritative `versus_game` and one UDP socket. `run()` seats the first
+	 * `players` clients that say hello (up to `max_spectators` later ones watch), then
+	 * ticks at a fixed rate: each tick applies the newest input every player tagged for
+	 * it or earlier, steps the game, and sends each client the tick records it has not
+	 * acknowledged yet, or a snapshot when that is smaller. The last `history` records
+	 * are kept; a client further behind gets a snapshot. Anything a datagram can make
+	 * the server hold is bounded: clients by the seats and spectator places, each
+	 * player's queued inputs by `max_input_lead`, and clients that go silent are dropped.
+	 *************************************************************************************/
+
+	class lockstep_server {
+	private:
+		static constexpr size_t history = 32;
+
+		using clock = std::chrono::steady_clock;
+
+		struct client {
+			sf::IpAddress address;
+			unsigned short port = 0;
+			int player = -1;
+			std::uint32_t acked = no_ack;
+			clock::time_point heard;
+		};
+
+		/// Who holds a seat, kept when its client is dropped so the same endpoint can come back to it.
+		struct seat {
+			sf::IpAddress address;
+			unsigned short port = 0;
+		};
+
+		lockstep_server_options options;
+		sf::UdpSocket socket;
+		versus_game game;
+		std::vector<client> clients;
+		std::vector<seat> seats;
+		std::deque<tick_record> records;
+		std::vector<input_entry> pending[versus_game::max_players];
+		versus_game::direction wanted[versus_game::max_players] = {};
+		std::uint32_t newest_applied[versus_game::max_players] = {};
+		int seated = 0;
+		lockstep_server_report report;
+		size_t snapshot_bytes = 0;        ///< size of a snapshot of the current tick
+		std::vector<std::uint8_t> packet;
+		std::vector<input_entry> received_inputs;
+
+		void send(const client& c) {
+			if (socket.send(packet.data(), packet.size(), c.address, c.port) == sf::Socket::Status::Done) {
+				++report.traffic.packets_sent;
+				report.traffic.bytes_sent += packet.size();
+			}
+		}
+
+		void send_update(const client& c) {
+			std::uint64_t newest = game.get_tick();
+			if (c.acked != no_ack && c.acked >= newest) return;
+			bool behind = c.acked == no_ack || records.empty() || c.acked + 1 < records.front().delta.tick;
+			if (behind) {
+				write_snapshot(packet, c.player, game.make_snapshot());
+				++report.snapshots_sent;
+			}
+			else {
+				size_t first = size_t(c.acked + 1 - records.front().delta.tick);
+				write_state(packet, game.get_player_count(), &records[first], records.size() - first);
+				// a long unacknowledged run (a lossy link) costs more than the state itself
+				if (packet.size() > snapshot_bytes) {
+					write_snapshot(packet, c.player, game.make_snapshot());
+					++report.snapshots_sent;
+				}
+				else
+					++report.state_packets_sent;
+			}
+			send(c);
+		}
+
+		void receive_all() {
+			std::uint8_t buffer[2048];
+			std::size_t received = 0;
+			std::optional<sf::IpAddress> address;
+			unsigned short port = 0;
+			while (socket.receive(buffer, sizeof(buffer), received, address, port) == sf::Socket::Status::Done) {
+				++report.traffic.packets_received;
+				report.traffic.bytes_received += received;
+				packet_reader r(buffer, received);
+				if (!r.ok() || !address) continue;
+
+				auto known = std::find_if(clients.begin(), clients.end(), [&](const client& c) { return c.address == *address && c.port == port; });
+				if (known != clients.end()) known->heard = clock::now();
+				if (r.type() == net_message::hello) {
+					if (known == clients.end()) {
+						auto held = std::find_if(seats.begin(), seats.end(), [&](const seat& s) { return s.address == *address && s.port == port; });
+						int player = held != seats.end() ? int(held - seats.begin()) : -1;
+						if (player < 0 && seated < game.get_player_count()) {
+							player = seated++;
+							seats.push_back({ *address, port });
+						}
+						if (player < 0 && std::count_if(clients.begin(), clients.end(), [](const client& c) { return c.player < 0; }) >= options.max_spectators) {
+							++report.refused_clients;
+							continue;
+						}
+						clients.push_back({ *address, port, player, no_ack, clock::now() });
+						known = clients.end() - 1;
+						report.peak_clients = std::max<std::uint64_t>(report.peak_clients, clients.size());
+					}
+					// also answers a repeated hello whose snapshot got lost
+					write_snapshot(packet, known->player, game.make_snapshot());
+					++report.snapshots_sent;
+					send(*known);
+				}
+				else if (r.type() == net_message::input && known != clients.end()) {
+					int player = 0;
+					std::uint32_t acked = no_ack;
+					if (!read_input(r, player, acked, received_inputs)) continue;
+					// an ack older than the last one is a reordered datagram; no_ack asks for a snapshot
+					if (acked == no_ack || known->acked == no_ack || acked > known->acked) known->acked = acked;
+					if (player != known->player || player < 0) continue;
+					for (const input_entry& entry : received_inputs) {
+						if (entry.tick <= newest_applied[player]) continue;
+						if (entry.tick > game.get_tick() + options.max_input_lead) {
+							++report.refused_inputs;
+							continue;
+						}
+						// a resent input replaces the queued one for its tick, so the queue never outgrows the lead
+						std::vector<input_entry>& queue = pending[player];
+						auto same = std::find_if(queue.begin(), queue.end(), [&](const input_entry& e) { return e.tick == entry.tick; });
+						if (same != queue.end()) same->dir = entry.dir;
+						else queue.push_back(entry);
+					}
+				}
+			}
+		}
+
+		void take_inputs(tick_record& record) {
+			const std::uint32_t tick = std::uint32_t(game.get_tick() + 1);
+			for (int id = 0; id < game.get_player_count(); ++id) {
+				std::vector<input_entry>& queue = pending[id];
+				const input_entry* newest = nullptr;
+				for (const input_entry& entry : queue)
+					if (entry.tick <= tick && entry.tick > newest_applied[id] && (!newest || entry.tick > newest->tick)) newest = &entry;
+				if (newest) {
+					wanted[id] = newest->dir;
+					record.input_age[id] = std::uint8_t(std::min<std::uint32_t>(tick - newest->tick, no_input_age - 1));
+					report.late_inputs += newest->tick < tick;
+					++report.inputs_applied;
+					newest_applied[id] = newest->tick;
+				}
+				queue.erase(std::remove_if(queue.begin(), queue.end(), [&](const input_entry& e) { return e.tick <= newest_applied[id]; }), queue.end());
+			}
+		}
+
+	public:
+		explicit lockstep_server(const lockstep_server_options& options_) : options(options_), game(options_.players, options_.seed) {
+			for (int id = 0; id < versus_game::max_players; ++id) wanted[id] = game.get_player(id).heading;
+		}
+
+		/// Binds the UDP port; false when it is taken.
+		bool bind() {
+			if (socket.bind(options.port) != sf::Socket::Status::Done) return false;
+			socket.setBlocking(false);
+			return true;
+		}
+
+		unsigned short get_port() const { return socket.getLocalPort(); }
+		const versus_game& get_game() const { return game; }
+
+		/*************************************************************************************
+		 * RUN FUNCTION: `run(const std::atomic<bool>* stop)`
+		 *
+		 * Blocks until every seat is taken, plays the game to its end (or `max_ticks`),
+		 * lingers, and returns the report. `stop` ends it early from another thread.
+		 *************************************************************************************/
+
+		lockstep_server_report run(const std::atomic<bool>* stop = nullptr) {
+			auto stopped = [&] { return stop && stop->load(std::memory_order_relaxed); };
+			sf::SocketSelector selector;
+			selector.add(socket);
+
+			while (seated < game.get_player_count() && !stopped()) {
+				if (selector.wait(sf::milliseconds(100))) receive_all();
+			}
+
+			const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / options.tick_hz));
+			const auto start = clock::now();
+			auto next_tick = start + period;
+			auto linger_until = clock::time_point::max();
+			while (!stopped()) {
+				auto now = clock::now();
+				if (now < next_tick) {
+					auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(next_tick - now).count();
+					if (selector.wait(sf::microseconds(std::max<std::int64_t>(wait_us, 1)))) receive_all();
+					continue;
+				}
+				receive_all();
+				report.max_tick_lateness_ms = std::max(report.max_tick_lateness_ms, std::chrono::duration<double, std::milli>(now - next_tick).count());
+				next_tick += period;
+
+				if (!game.is_over()) {
+					tick_record record;
+					take_inputs(record);
+					record.delta = game.step(wanted, options.max_ticks && game.get_tick() + 1 >= options.max_ticks);
+					record.checksum = game.checksum();
+					records.push_back(record);
+					if (records.size() > history) records.pop_front();
+					++report.ticks;
+					write_snapshot(packet, 0, game.make_snapshot());
+					snapshot_bytes = packet.size();
+					report.full_state_bytes += packet.size() * clients.size();
+				}
+				else if (linger_until == clock::time_point::max())
+					linger_until = now + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(options.linger_seconds));
+				else if (now >= linger_until)
+					break;
+				const auto silent = now - std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(options.client_timeout_seconds));
+				const size_t before = clients.size();
+				clients.erase(std::remove_if(clients.begin(), clients.end(), [&](const client& c) { return c.heard < silent; }), clients.end());
+				report.dropped_clients += before - clients.size();
+				for (const client& c : clients) send_update(c);
+			}
+			report.seconds = std::chrono::duration<double>(clock::now() - start).count();
+			report.clients = clients.size();
+			report.final_checksum = game.checksum();
+			return report;
+		}
+	};
+
+	inline void print_traffic(std::ostream& out, const char* who, const net_traffic& traffic, std::uint64_t ticks) {
+		double per_tick = ticks ? 1.0 / double(ticks) : 0;
+		out << std::setw(10) << who << std::fixed << std::setprecision(1)
+			<< std::setw(9) << traffic.packets_sent << std::setw(11) << traffic.bytes_sent << std::setw(10) << traffic.bytes_sent * per_tick
+			<< std::setw(9) << traffic.packets_received << std::setw(11) << traffic.bytes_received << std::setw(10) << traffic.bytes_received * per_tick << "\n";
+	}
+
+	inline void print_traffic_header(std::ostream& out) {
+		out << std::setw(10) << "endpoint" << std::setw(9) << "pkts out" << std::setw(11) << "bytes out" << std::setw(10) << "B/tick"
+			<< std::setw(9) << "pkts in" << std::setw(11) << "bytes in" << std::setw(10) << "B/tick" << "\n";
+	}
+
+	inline void print_server_report(std::ostream& out, const lockstep_server_report& report) {
+		out << report.ticks << " ticks in " << std::fixed << std::setprecision(2) << report.seconds << " s to " << report.clients << " clients; "
+			<< report.state_packets_sent << " delta packets, " << report.snapshots_sent << " snapshots; "
+			<< report.inputs_applied << " inputs applied (" << report.late_inputs << " late, " << report.refused_inputs << " too far ahead); "
+			<< report.refused_clients << " hellos refused, " << report.dropped_clients << " silent clients dropped; worst tick lateness "
+			<< report.max_tick_lateness_ms << " ms; final checksum " << std::hex << report.final_checksum << std::dec << "\n";
+		if (report.ticks && report.clients)
+			out << "sent " << std::setprecision(1) << double(report.traffic.bytes_sent) / report.ticks / report.clients << " B/tick per client; a snapshot every tick would be "
+				<< double(report.full_state_bytes) / report.ticks / report.clients << " B/tick\n";
+		out.flush();
+	}
+}
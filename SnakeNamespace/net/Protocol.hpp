@@ -0,0 +1,222 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "SnakeNamespace/net/VersusGame.hpp"
+
+namespace snake {
+	/*
+	 * @brief Wire format of the lockstep server (`lockstep_server`, `lockstep_client`).
+	 *
+	 * Every datagram starts with "SN", `net_version` and a `net_message`; all integers are
+	 * little-endian. Cells are board indices `y * width + x`.
+	 *
+	 * ## Client to server:
+	 * - hello    - asks for a seat; repeated until a snapshot arrives.
+	 * - input    - `uint8 player (0xFF spectator), uint32 acked tick (~0 = no state), uint8 n, n x (uint32 tick, uint8 direction)`:
+	 *              the acknowledgement plus every input not yet echoed back, so a lost datagram
+	 *              is covered by the next one. Sent after every state packet (heartbeat) and on
+	 *              every input.
+	 *
+	 * ## Server to client:
+	 * - snapshot - `uint8 your player (0xFF spectator)` and the whole game: per player the head
+	 *              cell and 2 bits per following segment. Sent on joining, when a client fell
+	 *              behind the delta history, and after it reported a desync.
+	 * - state    - `uint8 n` tick records, every tick after the client's acknowledged one:
+	 *              `uint32 tick, uint8 flags (1 food changed, 2 over), [uint16 food], uint32 checksum`,
+	 *              then per player `uint8 flags` (`versus_game::player_flags`, 8 = echo present),
+	 *              `[uint16 head]`, `[uint8 ticks since the newest input applied this tick]`.
+	 */
+	constexpr std::uint8_t net_version = 1;
+
+	enum class net_message : std::uint8_t { hello, input, snapshot, state };
+
+	constexpr std::uint8_t no_input_age = 0xFF;
+	constexpr std::uint32_t no_ack = 0xFFFFFFFFu;
+
+	/// One tick as the server sends it: the game delta plus what only the network needs.
+	/// The readers below only check the format and cell ranges; whether a delta fits the
+	/// game is `versus_game::can_apply()`'s to say.
+	struct tick_record {
+		versus_game::tick_delta delta;
+		std::uint32_t checksum = 0;
+		std::uint8_t input_age[versus_game::max_players] = { no_input_age, no_input_age, no_input_age, no_input_age };
+	};
+
+	struct input_entry {
+		std::uint32_t tick = 0;
+		versus_game::direction dir = versus_game::direction::up;
+	};
+
+	class packet_writer {
+	private:
+		std::vector<std::uint8_t>& out;
+
+	public:
+		packet_writer(std::vector<std::uint8_t>& out_, net_message type) : out(out_) {
+			out.clear();
+			out.insert(out.end(), { 'S', 'N', net_version, std::uint8_t(type) });
+		}
+
+		void put(std::uint64_t value, int bytes) {
+			for (int i = 0; i < bytes; ++i) out.push_back(std::uint8_t(value >> (8 * i)));
+		}
+	};
+
+	/// Bounds-checked reads; after reading past the end `ok()` is false and every read returns 0.
+	class packet_reader {
+	private:
+		const std::uint8_t* data;
+		size_t size;
+		size_t pos = 4;
+		bool good;
+
+	public:
+		packet_reader(const void* data_, size_t size_)
+			: data(static_cast<const std::uint8_t*>(data_)), size(size_),
+			good(size_ >= 4 && data[0] == 'S' && data[1] == 'N' && data[2] == net_version) {}
+
+		net_message type() const { return net_message(data[3]); }
+		bool ok() const { return good; }
+		bool at_end() const { return pos == size; }
+
+		std::uint64_t get(int bytes) {
+			if (!good || size - pos < size_t(bytes)) { good = false; return 0; }
+			std::uint64_t value = 0;
+			for (int i = 0; i < bytes; ++i) value |= std::uint64_t(data[pos++]) << (8 * i);
+			return value;
+		}
+	};
+
+	inline void write_hello(std::vector<std::uint8_t>& out) {
+		packet_writer w(out, net_message::hello);
+	}
+
+	inline void write_input(std::vector<std::uint8_t>& out, int player, std::uint32_t acked, const std::vector<input_entry>& inputs) {
+		packet_writer w(out, net_message::input);
+		w.put(player < 0 ? 0xFF : player, 1);
+		w.put(acked, 4);
+		size_t n = std::min<size_t>(inputs.size(), 32);
+		w.put(n, 1);
+		for (size_t i = inputs.size() - n; i < inputs.size(); ++i) {
+			w.put(inputs[i].tick, 4);
+			w.put(std::uint8_t(inputs[i].dir), 1);
+		}
+	}
+
+	inline bool read_input(packet_reader& r, int& player, std::uint32_t& acked, std::vector<input_entry>& inputs) {
+		std::uint8_t seat = std::uint8_t(r.get(1));
+		player = seat == 0xFF ? -1 : seat;
+		acked = std::uint32_t(r.get(4));
+		size_t n = size_t(r.get(1));
+		inputs.clear();
+		for (size_t i = 0; i < n && r.ok(); ++i) {
+			input_entry entry;
+			entry.tick = std::uint32_t(r.get(4));
+			entry.dir = versus_game::direction(r.get(1) & 3);
+			inputs.push_back(entry);
+		}
+		return r.ok() && r.at_end() && player < versus_game::max_players;
+	}
+
+	inline void write_snapshot(std::vector<std::uint8_t>& out, int player, const versus_game::snapshot& snap) {
+		packet_writer w(out, net_message::snapshot);
+		w.put(player < 0 ? 0xFF : player, 1);
+		w.put(snap.players, 1);
+		w.put(snap.tick, 4);
+		w.put(snap.food, 2);
+		w.put(snap.over, 1);
+		for (int id = 0; id < snap.players; ++id) {
+			const std::vector<std::uint16_t>& body = snap.bodies[id];
+			w.put(snap.alive[id] | (std::uint8_t(snap.headings[id]) << 1), 1);
+			w.put(snap.scores[id], 4);
+			w.put(body.size(), 2);
+			if (body.empty()) continue;
+			w.put(body[0], 2);
+			std::uint8_t packed = 0;
+			for (size_t i = 1; i < body.size(); ++i) {
+				int delta = int(body[i]) - int(body[i - 1]);
+				std::uint8_t dir = std::uint8_t(delta == -versus_game::width ? versus_game::direction::up : delta == 1 ? versus_game::direction::right
+					: delta == versus_game::width ? versus_game::direction::down : versus_game::direction::left);
+				packed |= std::uint8_t(dir << (2 * ((i - 1) % 4)));
+				if ((i - 1) % 4 == 3 || i + 1 == body.size()) { w.put(packed, 1); packed = 0; }
+			}
+		}
+	}
+
+	inline bool read_snapshot(packet_reader& r, int& player, versus_game::snapshot& snap) {
+		std::uint8_t seat = std::uint8_t(r.get(1));
+		player = seat == 0xFF ? -1 : seat;
+		snap.players = int(r.get(1));
+		if (snap.players > versus_game::max_players) return false;
+		snap.tick = r.get(4);
+		snap.food = std::uint16_t(r.get(2));
+		snap.over = r.get(1) != 0;
+		for (int id = 0; id < snap.players && r.ok(); ++id) {
+			std::uint8_t state = std::uint8_t(r.get(1));
+			snap.alive[id] = state & 1;
+			snap.headings[id] = versus_game::direction((state >> 1) & 3);
+			snap.scores[id] = std::uint32_t(r.get(4));
+			size_t length = size_t(r.get(2));
+			if (length > versus_game::cells) return false;
+			snap.bodies[id].clear();
+			if (!length) continue;
+			std::uint16_t cell = std::uint16_t(r.get(2));
+			if (cell >= versus_game::cells) return false;
+			snap.bodies[id].push_back(cell);
+			std::uint8_t packed = 0;
+			for (size_t i = 1; i < length && r.ok(); ++i) {
+				if ((i - 1) % 4 == 0) packed = std::uint8_t(r.get(1));
+				cell = versus_game::next_cell(cell, versus_game::direction((packed >> (2 * ((i - 1) % 4))) & 3));
+				if (cell == versus_game::no_cell) return false;
+				snap.bodies[id].push_back(cell);
+			}
+		}
+		return r.ok() && r.at_end() && player < snap.players && versus_game::is_valid(snap);
+	}
+
+	inline void write_state(std::vector<std::uint8_t>& out, int players, const tick_record* records, size_t count) {
+		packet_writer w(out, net_message::state);
+		w.put(count, 1);
+		for (size_t i = 0; i < count; ++i) {
+			const tick_record& rec = records[i];
+			w.put(rec.delta.tick, 4);
+			w.put((rec.delta.food_changed ? 1 : 0) | (rec.delta.over ? 2 : 0), 1);
+			if (rec.delta.food_changed) w.put(rec.delta.food, 2);
+			w.put(rec.checksum, 4);
+			for (int id = 0; id < players; ++id) {
+				bool echo = rec.input_age[id] != no_input_age;
+				w.put(rec.delta.flags[id] | (echo ? 8 : 0), 1);
+				if (rec.delta.flags[id] & versus_game::moved) w.put(rec.delta.head[id], 2);
+				if (echo) w.put(rec.input_age[id], 1);
+			}
+		}
+	}
+
+	inline bool read_state(packet_reader& r, int players, std::vector<tick_record>& records) {
+		size_t count = size_t(r.get(1));
+		records.assign(count, tick_record{});
+		for (tick_record& rec : records) {
+			rec.delta.tick = r.get(4);
+			std::uint8_t flags = std::uint8_t(r.get(1));
+			rec.delta.food_changed = flags & 1;
+			rec.delta.over = flags & 2;
+			if (rec.delta.food_changed) {
+				rec.delta.food = std::uint16_t(r.get(2));
+				if (rec.delta.food != versus_game::no_cell && rec.delta.food >= versus_game::cells) return false;
+			}
+			rec.checksum = std::uint32_t(r.get(4));
+			for (int id = 0; id < players; ++id) {
+				std::uint8_t player_flags = std::uint8_t(r.get(1));
+				rec.delta.flags[id] = player_flags & 7;
+				if (player_flags & versus_game::moved) {
+					rec.delta.head[id] = std::uint16_t(r.get(2));
+					if (rec.delta.head[id] >= versus_game::cells) return false;
+				}
+				if (player_flags & 8) rec.input_age[id] = std::uint8_t(r.get(1));
+			}
+		}
+		return r.ok() && r.at_end();
+	}
+}
@@ -0,0 +1,403 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/random/Random.hpp"
+#include "SnakeNamespace/render/RenderBackend.hpp"
+
+namespace snake {
+	/*
+	 * @brief Head-to-head snake on the `SnakeGame` board: up to four players, one food.
+	 *
+	 * The server advances it with `step()`, which returns what changed as a `tick_delta`
+	 * (a head added, a tail removed, a death, a new food cell). Clients never simulate:
+	 * they replay the server's deltas with `apply()`, the same code `step()` itself ends
+	 * in, so both sides hold the same state and `checksum()` can compare them. Data off
+	 * the network is checked first: a snapshot with `is_valid()`, a delta with
+	 * `can_apply()`, and its checksum with `checksum_after()`, before anything changes.
+	 *
+	 * ## Rules (the `arena` ones, for players):
+	 * - a head leaving the board or entering a body cell dies; a tail that moves away this
+	 *   tick does not block;
+	 * - two heads entering one cell both die;
+	 * - the dead leave the board and stay out; the game is over when at most one player
+	 *   is left (none, in a one-player game).
+	 */
+	class versus_game {
+	public:
+		static constexpr int width = SnakeGame::boardWidth;
+		static constexpr int height = SnakeGame::boardHeight;
+		static constexpr int max_players = 4;
+		static constexpr std::uint16_t no_cell = 0xFFFF;
+		static constexpr std::uint32_t cells = std::uint32_t(width * height);
+
+		enum class direction : std::uint8_t { up, right, down, left };
+
+		enum player_flags : std::uint8_t {
+			moved = 1,          ///< `head` is the new head cell
+			tail_removed = 2,   ///< the tail cell was freed (the player did not eat)
+			died = 4,           ///< the whole body left the board
+		};
+
+		struct tick_delta {
+			std::uint64_t tick = 0;             ///< the tick this delta leads to
+			std::uint16_t food = no_cell;
+			bool food_changed = false;
+			bool over = false;
+			std::uint8_t flags[max_players] = {};
+			std::uint16_t head[max_players] = {};
+		};
+
+		struct player {
+			std::deque<std::uint16_t> body;     ///< head first
+			direction heading = direction::right;
+			bool alive = false;
+			std::uint32_t score = 0;
+			std::uint64_t body_hash = 0;        ///< sum of `cell_key()` over the body, kept up to date per move
+		};
+
+		/// Everything needed to rebuild a game; a client's starting point and its recovery after a desync.
+		struct snapshot {
+			std::uint64_t tick = 0;
+			std::uint16_t food = no_cell;
+			bool over = false;
+			int players = 0;
+			std::vector<std::uint16_t> bodies[max_players];
+			direction headings[max_players] = {};
+			bool alive[max_players] = {};
+			std::uint32_t scores[max_players] = {};
+		};
+
+	private:
+		int player_count = 0;
+		player players[max_players];
+		std::vector<std::uint8_t> occupancy;   ///< owner + 1 per cell, 0 when empty
+		std::uint16_t food = no_cell;
+		std::uint64_t tick = 0;
+		bool over = false;
+		xoshiro256ss rng;
+
+		/// What `checksum()` digests of one player.
+		struct player_summary {
+			std::uint64_t body_hash = 0;
+			std::uint32_t score = 0;
+			bool alive = false;
+			std::uint16_t head = no_cell;
+			size_t length = 0;
+		};
+
+		static std::uint32_t digest(std::uint64_t tick_, std::uint16_t food_, bool over_, const player_summary* summaries, int count) {
+			std::uint64_t h = tick_ * 0x9E3779B97F4A7C15ull ^ (std::uint64_t(food_) << 1) ^ std::uint64_t(over_);
+			for (int id = 0; id < count; ++id) {
+				const player_summary& p = summaries[id];
+				std::uint64_t state = p.body_hash ^ (std::uint64_t(p.score) << 32) ^ (std::uint64_t(p.alive) << 63)
+					^ p.head ^ (std::uint64_t(p.length) << 16);
+				h = (h ^ splitmix64(state)) * 0x100000001B3ull;
+			}
+			return std::uint32_t(h ^ (h >> 32));
+		}
+
+		player_summary summary(int id) const {
+			const player& p = players[id];
+			return { p.body_hash, p.score, p.alive, p.body.empty() ? no_cell : p.body.front(), p.body.size() };
+		}
+
+		static std::uint64_t cell_key(int id, std::uint16_t cell) {
+			std::uint64_t state = (std::uint64_t(id) << 16) | cell;
+			return splitmix64(state);
+		}
+
+		static std::uint16_t step_cell(std::uint16_t cell, direction dir) {
+			int x = cell % width, y = cell / width;
+			switch (dir) {
+			case direction::up:    return y == 0 ? no_cell : std::uint16_t(cell - width);
+			case direction::down:  return y + 1 == height ? no_cell : std::uint16_t(cell + width);
+			case direction::left:  return x == 0 ? no_cell : std::uint16_t(cell - 1);
+			case direction::right: return x + 1 == width ? no_cell : std::uint16_t(cell + 1);
+			}
+			return no_cell;
+		}
+
+		void add_head(int id, std::uint16_t cell) {
+			players[id].body.push_front(cell);
+			players[id].body_hash += cell_key(id, cell);
+			occupancy[cell] = std::uint8_t(id + 1);
+		}
+
+		void remove_tail(int id) {
+			std::uint16_t cell = players[id].body.back();
+			players[id].body.pop_back();
+			players[id].body_hash -= cell_key(id, cell);
+			// a head may have moved onto this cell in the same tick
+			if (occupancy[cell] == id + 1) occupancy[cell] = 0;
+		}
+
+		std::uint16_t random_free_cell() {
+			for (int attempt = 0; attempt < 64; ++attempt) {
+				std::uint16_t cell = std::uint16_t(bounded(rng, cells));
+				if (!occupancy[cell]) return cell;
+			}
+			std::uint32_t free_cells = std::uint32_t(std::count(occupancy.begin(), occupancy.end(), 0));
+			if (!free_cells) return no_cell;
+			std::uint32_t pick = bounded(rng, free_cells);
+			for (std::uint16_t cell = 0;; ++cell)
+				if (!occupancy[cell] && pick-- == 0) return cell;
+		}
+
+		void apply_players(const tick_delta& delta) {
+			for (int id = 0; id < player_count; ++id) {
+				player& p = players[id];
+				if (delta.flags[id] & died) {
+					while (!p.body.empty()) remove_tail(id);
+					p.alive = false;
+				}
+			}
+			for (int id = 0; id < player_count; ++id)
+				if (delta.flags[id] & tail_removed) remove_tail(id);
+			for (int id = 0; id < player_count; ++id) {
+				if (!(delta.flags[id] & moved)) continue;
+				player& p = players[id];
+				if (p.body.size() > 0) {
+					std::uint16_t old_head = p.body.front();
+					int dx = delta.head[id] % width - old_head % width;
+					p.heading = dx > 0 ? direction::right : dx < 0 ? direction::left
+						: delta.head[id] > old_head ? direction::down : direction::up;
+				}
+				add_head(id, delta.head[id]);
+				if (!(delta.flags[id] & tail_removed)) ++p.score;
+			}
+		}
+
+		void apply_food(const tick_delta& delta) {
+			if (delta.food_changed) food = delta.food;
+			tick = delta.tick;
+			over = delta.over;
+		}
+
+	public:
+		versus_game() : occupancy(size_t(width * height), 0) {}
+
+		/// A fresh game: each player a 3-cell snake on its own row, alternating sides, facing the middle.
+		versus_game(int players_, std::uint64_t seed) : player_count(std::clamp(players_, 1, max_players)), occupancy(size_t(width * height), 0), rng(seed) {
+			for (int id = 0; id < player_count; ++id) {
+				int row = (id + 1) * height / (player_count + 1);
+				bool left_side = id % 2 == 0;
+				players[id].alive = true;
+				players[id].heading = left_side ? direction::right : direction::left;
+				for (int k = 0; k < 3; ++k) {
+					int col = left_side ? 5 + k : width - 6 - k;
+					add_head(id, std::uint16_t(row * width + col));
+				}
+			}
+			food = random_free_cell();
+		}
+
+		int get_player_count() const { return player_count; }
+		const player& get_player(int id) const { return players[id]; }
+		std::uint16_t get_food() const { return food; }
+		std::uint64_t get_tick() const { return tick; }
+		bool is_over() const { return over; }
+		/// Owner + 1 of `cell`, 0 when it is empty.
+		std::uint8_t owner(std::uint16_t cell) const { return occupancy[cell]; }
+
+		static bool opposite(direction a, direction b) { return (std::uint8_t(a) ^ std::uint8_t(b)) == 2; }
+		static std::uint16_t next_cell(std::uint16_t cell, direction dir) { return step_cell(cell, dir); }
+
+		/*************************************************************************************
+		 * STEP FUNCTION: `step(const direction* wanted, bool last)`
+		 *
+		 * Authoritative tick: `wanted[id]` is the direction player `id` asked for (a
+		 * reversal keeps the current heading). Decides every move from the state at the
+		 * start of the tick, applies it, places new food if it was eaten and returns
+		 * what changed. `last` ends the game after this tick (a time limit).
+		 *************************************************************************************/
+
+		tick_delta step(const direction* wanted, bool last = false) {
+			tick_delta delta;
+			delta.tick = tick + 1;
+			std::uint16_t next[max_players];
+			bool grows[max_players] = {}, dies[max_players] = {};
+
+			for (int id = 0; id < player_count; ++id) {
+				player& p = players[id];
+				if (!p.alive) continue;
+				if (!opposite(wanted[id], p.heading)) p.heading = wanted[id];
+				next[id] = step_cell(p.body.front(), p.heading);
+				grows[id] = next[id] != no_cell && next[id] == food;
+			}
+			for (int id = 0; id < player_count; ++id) {
+				if (!players[id].alive) continue;
+				if (next[id] == no_cell) { dies[id] = true; continue; }
+				for (int other = 0; other < player_count; ++other)
+					if (other != id && players[other].alive && next[other] == next[id]) dies[id] = true;
+				int owner = occupancy[next[id]];
+				if (owner) {
+					const player& o = players[owner - 1];
+					bool tail_leaves = !grows[owner - 1] && o.body.back() == next[id];
+					if (!tail_leaves) dies[id] = true;
+				}
+			}
+
+			bool eaten = false;
+			for (int id = 0; id < player_count; ++id) {
+				if (!players[id].alive) continue;
+				if (dies[id]) { delta.flags[id] = died; continue; }
+				delta.flags[id] = std::uint8_t(moved | (grows[id] ? 0 : tail_removed));
+				delta.head[id] = next[id];
+				eaten = eaten || grows[id];
+			}
+			apply_players(delta);
+
+			if (eaten) {
+				delta.food_changed = true;
+				delta.food = random_free_cell();
+			}
+			int alive = 0;
+			for (int id = 0; id < player_count; ++id) alive += players[id].alive;
+			delta.over = last || alive <= (player_count > 1 ? 1 : 0);
+			apply_food(delta);
+			return delta;
+		}
+
+		/// Replays a delta made by `step()` on an identical game. One from the network must pass `can_apply()` first.
+		void apply(const tick_delta& delta) {
+			apply_players(delta);
+			apply_food(delta);
+		}
+
+		/// Whether `delta` is one `step()` could have made from this state: the next tick, cells on
+		/// the board, and per player either nothing (the dead) or a death or a move (the living).
+		bool can_apply(const tick_delta& delta) const {
+			if (delta.tick != tick + 1 || (delta.food_changed && delta.food != no_cell && delta.food >= cells)) return false;
+			for (int id = 0; id < max_players; ++id) {
+				const std::uint8_t flags = delta.flags[id];
+				if (id >= player_count || !players[id].alive) {
+					if (flags) return false;
+					continue;
+				}
+				// a living player always has a body, so a freed tail always exists
+				if (flags != died && flags != moved && flags != (moved | tail_removed)) return false;
+				if ((flags & moved) && delta.head[id] >= cells) return false;
+			}
+			return true;
+		}
+
+		/// Order-independent digest of the replicated state: tick, food, and every player's body, score and liveness. O(players).
+		std::uint32_t checksum() const {
+			player_summary summaries[max_players];
+			for (int id = 0; id < player_count; ++id) summaries[id] = summary(id);
+			return digest(tick, food, over, summaries, player_count);
+		}
+
+		/// `checksum()` as it would be after `apply(delta)`, without applying it; `delta` must pass `can_apply()`. O(players).
+		std::uint32_t checksum_after(const tick_delta& delta) const {
+			player_summary summaries[max_players];
+			for (int id = 0; id < player_count; ++id) {
+				player_summary& p = summaries[id] = summary(id);
+				const std::uint8_t flags = delta.flags[id];
+				if (flags & died) {
+					// every cell's key leaves the hash
+					p = { 0, p.score, false, no_cell, 0 };
+					continue;
+				}
+				if (flags & tail_removed) {
+					p.body_hash -= cell_key(id, players[id].body.back());
+					--p.length;
+				}
+				if (flags & moved) {
+					p.body_hash += cell_key(id, delta.head[id]);
+					++p.length;
+					p.head = delta.head[id];
+					if (!(flags & tail_removed)) ++p.score;
+				}
+			}
+			return digest(delta.tick, delta.food_changed ? delta.food : food, delta.over, summaries, player_count);
+		}
+
+		/// Whether `snap` can be restored: at most `max_players`, cells on the board, and a body exactly for the living.
+		static bool is_valid(const snapshot& snap) {
+			if (snap.players < 0 || snap.players > max_players || (snap.food != no_cell && snap.food >= cells)) return false;
+			for (int id = 0; id < snap.players; ++id) {
+				const std::vector<std::uint16_t>& body = snap.bodies[id];
+				if (snap.alive[id] == body.empty() || body.size() > cells) return false;
+				for (std::uint16_t cell : body)
+					if (cell >= cells) return false;
+			}
+			return true;
+		}
+
+		snapshot make_snapshot() const {
+			snapshot snap;
+			snap.tick = tick;
+			snap.food = food;
+			snap.over = over;
+			snap.players = player_count;
+			for (int id = 0; id < player_count; ++id) {
+				snap.bodies[id].assign(players[id].body.begin(), players[id].body.end());
+				snap.headings[id] = players[id].heading;
+				snap.alive[id] = players[id].alive;
+				snap.scores[id] = players[id].score;
+			}
+			return snap;
+		}
+
+		void restore(const snapshot& snap) {
+			player_count = std::clamp(snap.players, 0, max_players);
+			std::fill(occupancy.begin(), occupancy.end(), std::uint8_t(0));
+			for (int id = 0; id < max_players; ++id) {
+				players[id] = player{};
+				if (id >= player_count) continue;
+				for (auto it = snap.bodies[id].rbegin(); it != snap.bodies[id].rend(); ++it) add_head(id, *it);
+				players[id].heading = snap.headings[id];
+				players[id].alive = snap.alive[id];
+				players[id].score = snap.scores[id];
+			}
+			food = snap.food;
+			tick = snap.tick;
+			over = snap.over;
+		}
+
+		/// Board in `SnakeGame` pixels: a colour per player, brighter heads, white food.
+		void render(render_backend& backend) const {
+			static const sf::Color colors[max_players] = { sf::Color::Green, sf::Color(255, 160, 0), sf::Color::Cyan, sf::Color::Magenta };
+			const float cell = float(SnakeGame::cellSize);
+			for (int id = 0; id < player_count; ++id) {
+				bool head = true;
+				for (std::uint16_t c : players[id].body) {
+					backend.fill_rect({ { c % width * cell, c / width * cell }, { cell, cell } }, head ? sf::Color::Red : colors[id]);
+					head = false;
+				}
+			}
+			if (food != no_cell)
+				backend.fill_circle({ food % width * cell, food / width * cell }, cell / 2.f, sf::Color::White);
+		}
+	};
+
+	/*************************************************************************************
+	 * POLICY: `versus_greedy(const versus_game& game, int id)`
+	 *
+	 * `greedy_policy` for one player of a `versus_game`: the free, non-reversing
+	 * neighbour closest to the food, the current heading when all are blocked.
+	 *************************************************************************************/
+
+	inline versus_game::direction versus_greedy(const versus_game& game, int id) {
+		using dir = versus_game::direction;
+		const versus_game::player& p = game.get_player(id);
+		if (!p.alive || p.body.empty()) return p.heading;
+		std::uint16_t food = game.get_food();
+		dir best = p.heading;
+		int best_distance = 1 << 30;
+		for (dir d : { dir::up, dir::right, dir::down, dir::left }) {
+			if (versus_game::opposite(d, p.heading)) continue;
+			std::uint16_t next = versus_game::next_cell(p.body.front(), d);
+			if (next == versus_game::no_cell || game.owner(next)) continue;
+			int distance = food == versus_game::no_cell ? 0
+				: std::abs(next % versus_game::width - food % versus_game::width) + std::abs(next / versus_game::width - food / versus_game::width);
+			if (distance < best_distance) { best_distance = distance; best = d; }
+		}
+		return best;
+	}
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "SnakeNamespace/profiling/Trace.hpp"
+
+namespace snake {
+	/// CPU time of the whole process, every thread, user and kernel, in seconds. (`std::clock()` is wall time on MSVC.)
+	inline double process_cpu_seconds() {
+#ifdef _WIN32
+		FILETIME created, exited, kernel, user;
+		if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+		auto ticks = [](const FILETIME& time) { return (std::uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+		return double(ticks(kernel) + ticks(user)) * 1e-7;
+#else
+		rusage usage{};
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+		return double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+	}
+
+	/*
+	 * @brief The last `window` samples of one quantity, with percentiles over just those.
+	 *
+	 * Adding is a store into a ring; percentiles copy the ring and `nth_element` it, which is
+	 * only done when the overlay refreshes or the CSV is written.
+	 */
+	class rolling_histogram {
+	private:
+		static constexpr size_t window = 1024;
+		std::array<float, window> ring{};
+		std::uint64_t samples = 0;
+		mutable std::vector<float> scratch;
+
+	public:
+		void add(float value) { ring[samples++ % window] = value; }
+
+		/// Samples ever added; percentiles cover the last `min(count(), 1024)` of them.
+		std::uint64_t count() const { return samples; }
+
+		float percentile(double p) const {
+			size_t n = size_t(std::min<std::uint64_t>(samples, window));
+			if (n == 0) return 0;
+			scratch.assign(ring.begin(), ring.begin() + n);
+			size_t rank = std::min(n - 1, size_t(p / 100.0 * n));
+			std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+			return scratch[rank];
+		}
+
+		float max() const {
+			size_t n = size_t(std::min<std::uint64_t>(samples, window));
+			return n ? *std::max_element(ring.begin(), ring.begin() + n) : 0;
+		}
+	};
+
+	/*************************************************************************************
+	 * CLASS: `frame_profiler`
+	 *
+	 * One rolling histogram (microseconds) per phase of a frame. Wrap a phase in
+	 * `auto t = profiler.time(frame_profiler::draw);`; when the profiler is disabled
+	 * that costs one branch and no clock reads. While `tracer` is enabled the same
+	 * timers also emit begin/end trace events named after the phase.
+	 *************************************************************************************/
+
+	class frame_profiler {
+	public:
+		enum phase : size_t { events, tick, draw, display, phase_count };
+
+		class scoped_timer {
+		private:
+			frame_profiler* owner;
+			size_t which;
+			bool traced;
+			std::chrono::steady_clock::time_point start;
+
+		public:
+			scoped_timer(frame_profiler& profiler, size_t phase_)
+				: owner(profiler.enabled ? &profiler : nullptr), which(phase_), traced(tracer::instance().is_enabled()) {
+				if (traced) tracer::instance().begin(names[which]);
+				if (owner) start = std::chrono::steady_clock::now();
+			}
+			~scoped_timer() { stop(); }
+			scoped_timer(const scoped_timer&) = delete;
+			scoped_timer& operator=(const scoped_timer&) = delete;
+
+			/// Records the sample now instead of at the end of the scope.
+			void stop() {
+				if (owner) owner->record(which, std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count());
+				if (traced) tracer::instance().end(names[which]);
+				owner = nullptr;
+				traced = false;
+			}
+
+			/// Drops this sample, e.g. when the phase ran into something that is not part of a frame.
+			/// The trace slice is still closed, the timeline should show where the time went.
+			void cancel() { owner = nullptr; }
+		};
+
+	private:
+		static constexpr const char* names[phase_count] = { "events", "tick", "draw", "display" };
+		rolling_histogram phases[phase_count];
+		bool enabled = false;
+
+	public:
+		bool is_enabled() const { return enabled; }
+		void set_enabled(bool on) { enabled = on; }
+
+		void record(size_t which, float microseconds) {
+			if (enabled) phases[which].add(microseconds);
+		}
+
+		scoped_timer time(size_t which) { return scoped_timer(*this, which); }
+
+		const rolling_histogram& get_phase(size_t which) const { return phases[which]; }
+
+		/// One line per phase that has samples: `name  p50  p95  p99  max` in microseconds.
+		std::string summary() const {
+			std::string text = "phase        p50     p95     p99     max us\n";
+			char line[96];
+			for (size_t i = 0; i < phase_count; ++i) {
+				const rolling_histogram& h = phases[i];
+				if (!h.count()) continue;
+				std::snprintf(line, sizeof(line), "%-8s %7.0f %7.0f %7.0f %7.0f\n", names[i],
+					h.percentile(50), h.percentile(95), h.percentile(99), h.max());
+				text += line;
+			}
+			return text;
+		}
+
+		/// CSV rows `loop,phase,samples,p50_us,p95_us,p99_us,max_us`, percentiles over the last 1024 samples.
+		void write_csv(std::ostream& out, const std::string& loop) const {
+			for (size_t i = 0; i < phase_count; ++i) {
+				const rolling_histogram& h = phases[i];
+				if (!h.count()) continue;
+				out << loop << "," << names[i] << "," << h.count() << "," << h.percentile(50) << "," << h.percentile(95)
+					<< "," << h.percentile(99) << "," << h.max() << "\n";
+			}
+		}
+
+		static void write_csv_header(std::ostream& out) {
+			out << "loop,phase,samples,p50_us,p95_us,p99_us,max_us\n";
+		}
+	};
+}
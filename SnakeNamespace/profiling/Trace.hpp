@@ -0,0 +1,212 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <vector_alias.hpp>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <functional>
+#include <thread>
+#endif
+
+namespace snake {
+	/*
+	 * @brief Opt-in timeline recorder that writes Chrome trace-event JSON.
+	 *
+	 * Every thread records into its own fixed-size buffer: an event is one store into the
+	 * thread's array followed by a release store of its count, so recording never locks or
+	 * allocates. The only lock is taken twice per thread: when it takes a buffer and when
+	 * it exits, which returns the buffer to a free list. The next new thread appends to it,
+	 * so short-lived threads (one simulation thread per game) share a few buffers instead of
+	 * holding one each. Events carry the OS thread id. A full buffer drops further events
+	 * (counted in `get_dropped()`).
+	 *
+	 * `write_json()` reads every buffer up to its published count; call it once the traced
+	 * threads are done. The output loads in Perfetto (ui.perfetto.dev) or chrome://tracing.
+	 *
+	 * While enabled the tracer also installs `raw::growth_hook`, so every `raw::vector`
+	 * reallocation shows up as a "raw::vector grow" slice with its capacities.
+	 */
+	class tracer {
+	public:
+		struct event {
+			const char* name;      ///< must outlive the tracer, i.e. a string literal
+			char phase;            ///< 'B' begin, 'E' end, 'i' instant, 'C' counter
+			std::uint32_t tid;     ///< OS id of the recording thread
+			std::int64_t ts_ns;
+			std::uint64_t arg0;
+			std::uint64_t arg1;
+		};
+
+	private:
+		struct thread_buffer {
+			static constexpr size_t capacity = size_t(1) << 16;
+			std::unique_ptr<event[]> events{ new event[capacity] };
+			std::atomic<size_t> count{ 0 };
+			std::uint32_t tid = 0;             ///< of the thread recording into it now
+		};
+
+		/// The calling thread's hold on a buffer; returns it to the free list when the thread exits.
+		struct thread_slot {
+			tracer* owner = nullptr;
+			thread_buffer* buffer = nullptr;
+			~thread_slot() {
+				if (!buffer) return;
+				std::lock_guard<std::mutex> lock(owner->registry_mutex);
+				owner->free_buffers.push_back(buffer);
+			}
+		};
+
+		std::mutex registry_mutex;
+		std::vector<std::unique_ptr<thread_buffer>> buffers;
+		std::vector<thread_buffer*> free_buffers;
+		std::vector<std::pair<std::uint32_t, const char*>> thread_names;
+		std::atomic<bool> enabled{ false };
+		std::atomic<std::uint64_t> dropped{ 0 };
+		std::int64_t origin_ns = now_ns();
+
+		static std::int64_t now_ns() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		static std::uint32_t current_thread_id() {
+#ifdef _WIN32
+			return std::uint32_t(GetCurrentThreadId());
+#elif defined(__linux__)
+			return std::uint32_t(::syscall(SYS_gettid));
+#else
+			return std::uint32_t(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+#endif
+		}
+
+		thread_buffer& local() {
+			thread_local thread_slot slot;
+			if (!slot.buffer) {
+				std::lock_guard<std::mutex> lock(registry_mutex);
+				if (free_buffers.empty()) {
+					buffers.push_back(std::make_unique<thread_buffer>());
+					slot.buffer = buffers.back().get();
+				}
+				else {
+					slot.buffer = free_buffers.back();
+					free_buffers.pop_back();
+				}
+				slot.owner = this;
+				slot.buffer->tid = current_thread_id();
+			}
+			return *slot.buffer;
+		}
+
+		void record(const char* name, char phase, std::uint64_t arg0 = 0, std::uint64_t arg1 = 0) {
+			thread_buffer& buffer = local();
+			size_t n = buffer.count.load(std::memory_order_relaxed);
+			if (n == thread_buffer::capacity) { dropped.fetch_add(1, std::memory_order_relaxed); return; }
+			buffer.events[n] = { name, phase, buffer.tid, now_ns(), arg0, arg1 };
+			buffer.count.store(n + 1, std::memory_order_release);
+		}
+
+		static void on_growth(bool begin, size_t old_capacity, size_t new_capacity, size_t element_size) {
+			tracer& t = instance();
+			if (!t.is_enabled()) return;
+			if (begin) t.record("raw::vector grow", 'B', old_capacity * element_size, new_capacity * element_size);
+			else t.record("raw::vector grow", 'E');
+		}
+
+	public:
+		static tracer& instance() {
+			static tracer shared;
+			return shared;
+		}
+
+		bool is_enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+		void set_enabled(bool on) {
+			enabled.store(on, std::memory_order_relaxed);
+			raw::growth_hook.store(on ? &tracer::on_growth : nullptr, std::memory_order_relaxed);
+		}
+
+		void begin(const char* name) { if (is_enabled()) record(name, 'B'); }
+		void end(const char* name) { if (is_enabled()) record(name, 'E'); }
+		/// A point in time, with an optional value shown as its `value` argument.
+		void instant(const char* name, std::uint64_t value = 0) { if (is_enabled()) record(name, 'i', value); }
+		void counter(const char* name, std::uint64_t value) { if (is_enabled()) record(name, 'C', value); }
+
+		/// Labels the calling thread's track in the viewer.
+		void set_thread_name(const char* name) {
+			if (!is_enabled()) return;
+			std::uint32_t tid = local().tid;
+			std::lock_guard<std::mutex> lock(registry_mutex);
+			thread_names.emplace_back(tid, name);
+		}
+
+		std::uint64_t get_dropped() const { return dropped.load(std::memory_order_relaxed); }
+		/// Buffers ever allocated, i.e. the most threads that recorded at once.
+		size_t get_buffer_count() {
+			std::lock_guard<std::mutex> lock(registry_mutex);
+			return buffers.size();
+		}
+
+		void write_json(std::ostream& out) {
+			std::lock_guard<std::mutex> lock(registry_mutex);
+			out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+			bool first = true;
+			auto separator = [&] { out << (first ? "" : ",\n"); first = false; };
+			for (const auto& [tid, name] : thread_names) {
+				separator();
+				out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+					<< ",\"args\":{\"name\":\"" << name << "\"}}";
+			}
+			for (const auto& buffer : buffers) {
+				size_t n = buffer->count.load(std::memory_order_acquire);
+				for (size_t i = 0; i < n; ++i) {
+					const event& e = buffer->events[i];
+					separator();
+					out << "{\"name\":\"" << e.name << "\",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << e.tid
+						<< ",\"ts\":" << double(e.ts_ns - origin_ns) / 1000.0;
+					if (e.phase == 'i') out << ",\"s\":\"t\",\"args\":{\"value\":" << e.arg0 << "}";
+					else if (e.phase == 'C') out << ",\"args\":{\"value\":" << e.arg0 << "}";
+					else if (e.phase == 'B' && (e.arg0 || e.arg1)) out << ",\"args\":{\"from_bytes\":" << e.arg0 << ",\"to_bytes\":" << e.arg1 << "}";
+					out << "}";
+				}
+			}
+			out << "\n]}\n";
+		}
+
+		bool save(const std::string& path) {
+			std::ofstream file(path);
+			write_json(file);
+			return bool(file);
+		}
+	};
+
+	/// Begin/end pair around a scope; costs one relaxed load while tracing is off.
+	class trace_scope {
+	private:
+		const char* name;
+
+	public:
+		explicit trace_scope(const char* name_) : name(tracer::instance().is_enabled() ? name_ : nullptr) {
+			if (name) tracer::instance().begin(name);
+		}
+		~trace_scope() { if (name) tracer::instance().end(name); }
+		trace_scope(const trace_scope&) = delete;
+		trace_scope& operator=(const trace_scope&) = delete;
+	};
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace snake {
+	/// SplitMix64 step: advances `state` and returns a well-mixed 64-bit value. Used to expand seeds.
+	inline std::uint64_t splitmix64(std::uint64_t& state) {
+		std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	/*
+	 * @brief xoshiro256** (Blackman & Vigna): 32 bytes of state, 64-bit output, a few cycles per draw.
+	 *
+	 * Satisfies UniformRandomBitGenerator, so it also works with the `<random>` distributions.
+	 * The state is expanded from the seed with SplitMix64, as the authors recommend.
+	 */
+	class xoshiro256ss {
+	private:
+		std::uint64_t s[4];
+
+		static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	public:
+		using result_type = std::uint64_t;
+
+		explicit xoshiro256ss(std::uint64_t seed_ = 0) { seed(seed_); }
+
+		void seed(std::uint64_t seed_) {
+			for (std::uint64_t& word : s) word = splitmix64(seed_);
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+		result_type operator()() {
+			const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+			const std::uint64_t t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = rotl(s[3], 45);
+			return result;
+		}
+
+		bool operator==(const xoshiro256ss& other) const {
+			return s[0] == other.s[0] && s[1] == other.s[1] && s[2] == other.s[2] && s[3] == other.s[3];
+		}
+	};
+
+	/*
+	 * @brief PCG32 (O'Neill, XSH-RR): 16 bytes of state, 32-bit output.
+	 *
+	 * `stream` selects one of 2^63 independent sequences for the same seed.
+	 */
+	class pcg32 {
+	private:
+		std::uint64_t state = 0;
+		std::uint64_t increment = 1;
+
+	public:
+		using result_type = std::uint32_t;
+
+		explicit pcg32(std::uint64_t seed_ = 0, std::uint64_t stream = 0xDA3E39CB94B95BDBull) { seed(seed_, stream); }
+
+		void seed(std::uint64_t seed_, std::uint64_t stream = 0xDA3E39CB94B95BDBull) {
+			state = 0;
+			increment = (stream << 1) | 1;
+			(*this)();
+			state += seed_;
+			(*this)();
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+		result_type operator()() {
+			std::uint64_t old = state;
+			state = old * 6364136223846793005ull + increment;
+			std::uint32_t xorshifted = std::uint32_t(((old >> 18) ^ old) >> 27);
+			std::uint32_t rot = std::uint32_t(old >> 59);
+			return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+		}
+
+		bool operator==(const pcg32& other) const { return state == other.state && increment == other.increment; }
+	};
+
+	/// 32 uniformly random bits from any engine with a full 32- or 64-bit range (the high bits of a 64-bit draw).
+	template <typename Rng>
+	std::uint32_t next_u32(Rng& rng) {
+		static_assert(Rng::min() == 0 && (Rng::max() == 0xFFFFFFFFu || Rng::max() == ~std::uint64_t(0)),
+			"next_u32 needs an engine with a full 32- or 64-bit output range");
+		if constexpr (Rng::max() > 0xFFFFFFFFu) return std::uint32_t(std::uint64_t(rng()) >> 32);
+		else return std::uint32_t(rng());
+	}
+
+	/*************************************************************************************
+	 * SAMPLE FUNCTION: `bounded(Rng& rng, std::uint32_t range)`
+	 *
+	 * Uniform integer in [0, range), without bias, by Lemire's multiply-and-shift
+	 * ("Fast Random Integer Generation in an Interval", 2019): one 32x32->64 multiply
+	 * per draw, and the division only runs in the rare case a draw may be rejected.
+	 * `range` must not be 0.
+	 *************************************************************************************/
+
+	template <typename Rng>
+	std::uint32_t bounded(Rng& rng, std::uint32_t range) {
+		std::uint64_t product = std::uint64_t(next_u32(rng)) * range;
+		std::uint32_t low = std::uint32_t(product);
+		if (low < range) {
+			const std::uint32_t threshold = std::uint32_t(-range) % range;
+			while (low < threshold) {
+				product = std::uint64_t(next_u32(rng)) * range;
+				low = std::uint32_t(product);
+			}
+		}
+		return std::uint32_t(product >> 32);
+	}
+
+	/// A different seed on every call: one `std::random_device` read per process, then SplitMix64.
+	inline std::uint32_t fresh_seed() {
+		static std::atomic<std::uint64_t> state{ (std::uint64_t(std::random_device{}()) << 32) | std::random_device{}() };
+		std::uint64_t current = state.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed);
+		return std::uint32_t(splitmix64(current) >> 32);
+	}
+}
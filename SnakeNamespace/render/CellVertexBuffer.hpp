@@ -0,0 +1,147 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "SnakeGame.hpp"
+
+namespace snake {
+	/*
+	 * @brief Persistent two-triangle quad per board cell, patched as the snake moves.
+	 *
+	 * A tick changes at most three cells (new head, old head turning into body, freed tail)
+	 * plus the food, so `sync()` mirrors the body and recolours only those cells instead of
+	 * rebuilding the scene. Empty cells are transparent, so the window's clear colour shows.
+	 * When the ticks do not follow on (first frame, loaded state) it rebuilds once.
+	 *
+	 * `draw()` uploads just the patched cells into an `sf::VertexBuffer` when the GPU supports
+	 * one, and otherwise draws the CPU copy; a frame without a tick uploads nothing.
+	 */
+	class cell_vertex_buffer : public sf::Drawable {
+	private:
+		static constexpr int width = SnakeGame::boardWidth;
+		static constexpr int height = SnakeGame::boardHeight;
+		static constexpr int no_cell = -1;
+		/// Past this many undrawn patches the next `draw()` re-uploads everything instead.
+		static constexpr size_t max_pending = 256;
+
+		std::vector<sf::Vertex> vertices = std::vector<sf::Vertex>(size_t(width) * height * 6);
+		std::vector<std::uint16_t> occupied = std::vector<std::uint16_t>(size_t(width) * height, 0);
+		std::deque<int> body;
+		int head = no_cell;
+		sf::Vector2f food;
+		std::uint64_t synced_tick = ~std::uint64_t(0);
+
+		std::uint64_t rebuilds = 0;
+		std::uint64_t patches = 0;
+
+		mutable sf::VertexBuffer gpu{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Dynamic };
+		mutable bool gpu_ready = false;
+		mutable std::vector<int> pending;
+
+		void paint(int cell) {
+			if (cell == no_cell) return;
+			sf::Color color = !occupied[cell] ? sf::Color::Transparent : cell == head ? sf::Color::Red : sf::Color::Green;
+			sf::Vertex* quad = &vertices[size_t(cell) * 6];
+			if (quad[0].color == color) return;
+			for (int i = 0; i < 6; ++i) quad[i].color = color;
+			++patches;
+			if (!gpu_ready) return;
+			if (pending.size() == max_pending) { gpu_ready = false; pending.clear(); }
+			else pending.push_back(cell);
+		}
+
+		void occupy(int cell) { if (cell != no_cell) ++occupied[cell]; }
+		void vacate(int cell) { if (cell != no_cell) --occupied[cell]; }
+
+		template <typename CoordsAt>
+		void rebuild(size_t length, CoordsAt&& at) {
+			++rebuilds;
+			std::fill(occupied.begin(), occupied.end(), 0);
+			body.clear();
+			for (size_t i = 0; i < length; ++i) {
+				body.push_back(SnakeGame::cellIndex(at(i)));
+				occupy(body.back());
+			}
+			head = body.empty() ? no_cell : body.front();
+			for (int cell = 0; cell < width * height; ++cell) {
+				sf::Color color = !occupied[cell] ? sf::Color::Transparent : cell == head ? sf::Color::Red : sf::Color::Green;
+				for (int i = 0; i < 6; ++i) vertices[size_t(cell) * 6 + i].color = color;
+			}
+			gpu_ready = false;
+			pending.clear();
+		}
+
+	public:
+		cell_vertex_buffer() {
+			const float size = float(SnakeGame::cellSize);
+			for (int cell = 0; cell < width * height; ++cell) {
+				sf::Vector2f a{ float(cell % width) * size, float(cell / width) * size };
+				const sf::Vector2f corners[6] = { a, { a.x + size, a.y }, { a.x, a.y + size }, { a.x + size, a.y }, { a.x + size, a.y + size }, { a.x, a.y + size } };
+				for (int i = 0; i < 6; ++i) vertices[size_t(cell) * 6 + i] = { corners[i], sf::Color::Transparent, {} };
+			}
+		}
+
+		/*************************************************************************************
+		 * SYNC FUNCTION: `sync(tick, length, at, food)`
+		 *
+		 * `at(i)` returns the coordinates of body segment `i`, head first. Only the head
+		 * and tail are read on a regular tick; the whole body only on a rebuild.
+		 *************************************************************************************/
+
+		template <typename CoordsAt>
+		void sync(std::uint64_t tick, size_t length, CoordsAt&& at, sf::Vector2f food_) {
+			food = food_;
+			if (tick == synced_tick) return;
+			if (tick != synced_tick + 1 || body.empty() || length == 0 || (length != body.size() && length != body.size() + 1)) {
+				rebuild(length, at);
+			}
+			else {
+				bool grew = length == body.size() + 1;
+				int old_head = head, old_tail = body.back();
+				vacate(old_tail);
+				body.pop_back();
+				head = SnakeGame::cellIndex(at(0));
+				body.push_front(head);
+				occupy(head);
+				if (grew) { body.push_back(SnakeGame::cellIndex(at(length - 1))); occupy(body.back()); }
+				paint(old_tail);
+				paint(old_head);
+				paint(head);
+				if (grew) paint(body.back());
+			}
+			synced_tick = tick;
+		}
+
+		void sync(const SnakeGame& game) {
+			const auto& segments = game.getBody();
+			sync(game.getTicks(), game.getLength(), [&](size_t i) { return segments[i].coords; }, game.getFood());
+		}
+
+		/// Full recolours: the first sync and every sync that did not follow the previous tick.
+		std::uint64_t get_rebuilds() const { return rebuilds; }
+		/// Cells recoloured by regular ticks since construction.
+		std::uint64_t get_patches() const { return patches; }
+		const std::vector<sf::Vertex>& get_vertices() const { return vertices; }
+
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+			if (sf::VertexBuffer::isAvailable()) {
+				if (!gpu_ready) {
+					gpu_ready = gpu.create(vertices.size()) && gpu.update(vertices.data(), vertices.size(), 0);
+					pending.clear();
+				}
+				for (int cell : pending)
+					gpu.update(&vertices[size_t(cell) * 6], 6, unsigned(cell) * 6);
+				pending.clear();
+			}
+			if (gpu_ready) target.draw(gpu, states);
+			else target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles, states);
+
+			sf::CircleShape apple(SnakeGame::cellSize / 2.f);
+			apple.setFillColor(sf::Color::White);
+			apple.setPosition(food);
+			target.draw(apple, states);
+		}
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+namespace snake {
+	/*
+	 * @brief What the game and menu need from a renderer: a clear, filled axis-aligned
+	 * rectangles, filled circles and text.
+	 *
+	 * `SnakeGame`, `SnakeScreen` and `frame` describe themselves through this interface in
+	 * `render()`; their `sf::Drawable::draw()` just wraps the target in an `sfml_backend`.
+	 * Coordinates are target pixels. Backends that cannot rasterize glyphs may skip text.
+	 */
+	class render_backend {
+	public:
+		virtual ~render_backend() = default;
+
+		virtual void clear(sf::Color color) = 0;
+		virtual void fill_rect(sf::FloatRect rect, sf::Color color) = 0;
+		/// Filled circle of `radius` whose bounding square starts at `top_left`, like `sf::CircleShape`.
+		virtual void fill_circle(sf::Vector2f top_left, float radius, sf::Color color) = 0;
+		virtual void draw_text(const sf::Text& text) = 0;
+	};
+
+	/// Forwards to an SFML render target (window or texture) as shapes.
+	class sfml_backend : public render_backend {
+	private:
+		sf::RenderTarget& target;
+		sf::RenderStates states;
+
+	public:
+		explicit sfml_backend(sf::RenderTarget& target_, sf::RenderStates states_ = sf::RenderStates::Default)
+			: target(target_), states(states_) {}
+
+		void clear(sf::Color color) override { target.clear(color); }
+
+		void fill_rect(sf::FloatRect rect, sf::Color color) override {
+			sf::RectangleShape shape(rect.size);
+			shape.setFillColor(color);
+			shape.setPosition(rect.position);
+			target.draw(shape, states);
+		}
+
+		void fill_circle(sf::Vector2f top_left, float radius, sf::Color color) override {
+			sf::CircleShape shape(radius);
+			shape.setFillColor(color);
+			shape.setPosition(top_left);
+			target.draw(shape, states);
+		}
+
+		void draw_text(const sf::Text& text) override { target.draw(text, states); }
+	};
+}
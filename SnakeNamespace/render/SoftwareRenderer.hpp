@@ -0,0 +1,256 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "SnakeNamespace/render/RenderBackend.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SNAKE_SPAN_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SNAKE_SPAN_SSE2 1
+#endif
+
+namespace snake {
+	/// Which `fill_span` path this build uses.
+	inline const char* span_fill_isa() {
+#if defined(SNAKE_SPAN_AVX2)
+		return "AVX2";
+#elif defined(SNAKE_SPAN_SSE2)
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+
+	inline void fill_span_scalar(std::uint32_t* dst, size_t count, std::uint32_t value) {
+		for (; count; --count) *dst++ = value;
+	}
+
+	/// Writes `count` copies of one pixel: 8 per store with AVX2, 4 with SSE2, then the rest one by one.
+	inline void fill_span(std::uint32_t* dst, size_t count, std::uint32_t value) {
+#if defined(SNAKE_SPAN_AVX2)
+		const __m256i wide = _mm256_set1_epi32(int(value));
+		for (; count >= 8; count -= 8, dst += 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), wide);
+#endif
+#if defined(SNAKE_SPAN_SSE2)
+		const __m128i quad = _mm_set1_epi32(int(value));
+		for (; count >= 4; count -= 4, dst += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), quad);
+#endif
+		fill_span_scalar(dst, count, value);
+	}
+
+	/*
+	 * @brief RGBA8 image in memory order R, G, B, A, rows top to bottom.
+	 *
+	 * Exports binary PPM (RGB) and PNG (RGBA, stored deflate blocks, so no zlib needed).
+	 * `hash()` and `diff()` are meant for golden-image comparisons.
+	 */
+	class framebuffer {
+	private:
+		unsigned int width;
+		unsigned int height;
+		std::vector<std::uint32_t> pixels;
+
+		static void put_be32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+			for (int shift = 24; shift >= 0; shift -= 8) out.push_back(std::uint8_t(value >> shift));
+		}
+
+		static std::uint32_t crc32(const std::uint8_t* bytes, size_t count, std::uint32_t crc = 0) {
+			static const auto table = [] {
+				std::vector<std::uint32_t> t(256);
+				for (std::uint32_t n = 0; n < 256; ++n) {
+					std::uint32_t c = n;
+					for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+					t[n] = c;
+				}
+				return t;
+			}();
+			crc = ~crc;
+			for (size_t i = 0; i < count; ++i) crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+			return ~crc;
+		}
+
+		static void put_chunk(std::vector<std::uint8_t>& out, const char type[4], const std::vector<std::uint8_t>& body) {
+			put_be32(out, std::uint32_t(body.size()));
+			size_t start = out.size();
+			out.insert(out.end(), type, type + 4);
+			out.insert(out.end(), body.begin(), body.end());
+			put_be32(out, crc32(out.data() + start, out.size() - start));
+		}
+
+	public:
+		framebuffer(unsigned int width_, unsigned int height_)
+			: width(width_), height(height_), pixels(size_t(width_) * height_, 0) {}
+
+		static std::uint32_t pack(sf::Color color) {
+			return std::uint32_t(color.r) | std::uint32_t(color.g) << 8 | std::uint32_t(color.b) << 16 | std::uint32_t(color.a) << 24;
+		}
+
+		unsigned int get_width() const { return width; }
+		unsigned int get_height() const { return height; }
+		std::uint32_t* row(unsigned int y) { return pixels.data() + size_t(y) * width; }
+		std::uint32_t pixel(unsigned int x, unsigned int y) const { return pixels[size_t(y) * width + x]; }
+		const std::vector<std::uint32_t>& get_pixels() const { return pixels; }
+
+		/// FNV-1a over the pixels and the size.
+		std::uint64_t hash() const {
+			std::uint64_t h = 14695981039346656037ull;
+			auto mix = [&](std::uint32_t value) {
+				for (int i = 0; i < 4; ++i) { h ^= (value >> (8 * i)) & 0xFF; h *= 1099511628211ull; }
+			};
+			mix(width);
+			mix(height);
+			for (std::uint32_t p : pixels) mix(p);
+			return h;
+		}
+
+		/// Number of pixels that differ; every pixel when the sizes differ.
+		size_t diff(const framebuffer& other) const {
+			if (width != other.width || height != other.height) return std::max(pixels.size(), other.pixels.size());
+			size_t count = 0;
+			for (size_t i = 0; i < pixels.size(); ++i) count += pixels[i] != other.pixels[i];
+			return count;
+		}
+
+		bool save_ppm(const std::string& path) const {
+			std::ofstream file(path, std::ios::binary);
+			file << "P6\n" << width << " " << height << "\n255\n";
+			std::vector<std::uint8_t> rgb;
+			rgb.reserve(pixels.size() * 3);
+			for (std::uint32_t p : pixels) {
+				rgb.push_back(std::uint8_t(p));
+				rgb.push_back(std::uint8_t(p >> 8));
+				rgb.push_back(std::uint8_t(p >> 16));
+			}
+			file.write(reinterpret_cast<const char*>(rgb.data()), std::streamsize(rgb.size()));
+			return bool(file);
+		}
+
+		/// Reads a binary PPM written by `save_ppm()` (alpha becomes 255). False on anything else.
+		bool load_ppm(const std::string& path) {
+			std::ifstream file(path, std::ios::binary);
+			std::string magic;
+			unsigned int w = 0, h = 0, maxval = 0;
+			if (!(file >> magic >> w >> h >> maxval) || magic != "P6" || maxval != 255) return false;
+			file.get();
+			std::vector<std::uint8_t> rgb(size_t(w) * h * 3);
+			if (!file.read(reinterpret_cast<char*>(rgb.data()), std::streamsize(rgb.size()))) return false;
+			width = w;
+			height = h;
+			pixels.resize(size_t(w) * h);
+			for (size_t i = 0; i < pixels.size(); ++i)
+				pixels[i] = std::uint32_t(rgb[3 * i]) | std::uint32_t(rgb[3 * i + 1]) << 8 | std::uint32_t(rgb[3 * i + 2]) << 16 | 0xFF000000u;
+			return true;
+		}
+
+		bool save_png(const std::string& path) const {
+			std::vector<std::uint8_t> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			std::vector<std::uint8_t> header;
+			put_be32(header, width);
+			put_be32(header, height);
+			header.insert(header.end(), { 8, 6, 0, 0, 0 }); // 8-bit RGBA, no interlace
+			put_chunk(out, "IHDR", header);
+
+			// zlib stream of stored (uncompressed) deflate blocks over filter-0 scanlines
+			std::vector<std::uint8_t> raw;
+			raw.reserve(size_t(height) * (1 + 4 * size_t(width)));
+			for (unsigned int y = 0; y < height; ++y) {
+				raw.push_back(0);
+				for (size_t x = 0; x < size_t(width); ++x) {
+					std::uint32_t p = pixels[size_t(y) * width + x];
+					raw.insert(raw.end(), { std::uint8_t(p), std::uint8_t(p >> 8), std::uint8_t(p >> 16), std::uint8_t(p >> 24) });
+				}
+			}
+			std::vector<std::uint8_t> zlib = { 0x78, 0x01 };
+			size_t at = 0;
+			do {
+				size_t len = std::min<size_t>(65535, raw.size() - at);
+				zlib.push_back(at + len == raw.size() ? 1 : 0); // BFINAL on the last block, BTYPE 00 (stored)
+				zlib.insert(zlib.end(), { std::uint8_t(len), std::uint8_t(len >> 8), std::uint8_t(~len), std::uint8_t(~len >> 8) });
+				zlib.insert(zlib.end(), raw.begin() + at, raw.begin() + at + len);
+				at += len;
+			} while (at < raw.size());
+			std::uint32_t a = 1, b = 0;
+			for (std::uint8_t byte : raw) { a = (a + byte) % 65521; b = (b + a) % 65521; }
+			put_be32(zlib, (b << 16) | a);
+			put_chunk(out, "IDAT", zlib);
+			put_chunk(out, "IEND", {});
+
+			std::ofstream file(path, std::ios::binary);
+			file.write(reinterpret_cast<const char*>(out.data()), std::streamsize(out.size()));
+			return bool(file);
+		}
+
+		/// PNG for a `.png` path, PPM otherwise.
+		bool save(const std::string& path) const {
+			return path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0 ? save_png(path) : save_ppm(path);
+		}
+	};
+
+	/*************************************************************************************
+	 * CLASS: `software_backend`
+	 *
+	 * Rasterizes into a `framebuffer` on the CPU, no window or GL context needed.
+	 * A pixel is covered when its centre is inside the shape; every shape becomes one
+	 * horizontal span per row, written with `fill_span`. Colours overwrite (the game
+	 * only uses opaque colours) and text is skipped, as there is no glyph rasterizer.
+	 * Output depends only on the inputs, so frames can be compared pixel for pixel.
+	 *************************************************************************************/
+
+	class software_backend : public render_backend {
+	private:
+		framebuffer& target;
+		bool simd = true;
+		size_t skipped_text = 0;
+
+		void span(unsigned int y, long x0, long x1, std::uint32_t value) {
+			x0 = std::max(x0, 0L);
+			x1 = std::min(x1, long(target.get_width()));
+			if (x0 >= x1) return;
+			std::uint32_t* dst = target.row(y) + x0;
+			if (simd) fill_span(dst, size_t(x1 - x0), value);
+			else fill_span_scalar(dst, size_t(x1 - x0), value);
+		}
+
+	public:
+		explicit software_backend(framebuffer& target_) : target(target_) {}
+
+		/// Forces the scalar span fill, to compare against the SIMD one.
+		void set_simd(bool on) { simd = on; }
+		size_t get_skipped_text() const { return skipped_text; }
+
+		void clear(sf::Color color) override {
+			std::uint32_t value = framebuffer::pack(color);
+			for (unsigned int y = 0; y < target.get_height(); ++y) span(y, 0, long(target.get_width()), value);
+		}
+
+		void fill_rect(sf::FloatRect rect, sf::Color color) override {
+			long x0 = long(std::ceil(rect.position.x - 0.5f)), x1 = long(std::ceil(rect.position.x + rect.size.x - 0.5f));
+			long y0 = std::max(0L, long(std::ceil(rect.position.y - 0.5f)));
+			long y1 = std::min(long(target.get_height()), long(std::ceil(rect.position.y + rect.size.y - 0.5f)));
+			std::uint32_t value = framebuffer::pack(color);
+			for (long y = y0; y < y1; ++y) span(unsigned(y), x0, x1, value);
+		}
+
+		void fill_circle(sf::Vector2f top_left, float radius, sf::Color color) override {
+			float cx = top_left.x + radius, cy = top_left.y + radius;
+			long y0 = std::max(0L, long(std::floor(cy - radius))), y1 = std::min(long(target.get_height()), long(std::ceil(cy + radius)));
+			std::uint32_t value = framebuffer::pack(color);
+			for (long y = y0; y < y1; ++y) {
+				float dy = float(y) + 0.5f - cy;
+				if (dy * dy > radius * radius) continue;
+				float half = std::sqrt(radius * radius - dy * dy);
+				span(unsigned(y), long(std::ceil(cx - half - 0.5f)), long(std::ceil(cx + half - 0.5f)), value);
+			}
+		}
+
+		void draw_text(const sf::Text&) override { ++skipped_text; }
+	};
+}
@@ -0,0 +1,538 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+
+namespace snake {
+	/*
+	 * @brief Tick-diff stream of one `SnakeGame`, for analytics.
+	 *
+	 * Unlike a `replay`, which needs the simulation to play it back, a diff stream spells out
+	 * what changed on every tick, so a reader rebuilds the board without `SnakeGame` or its
+	 * engine. Ticks are grouped in blocks; each block starts with a keyframe of the whole
+	 * board, so any tick is at most one block of diffs away.
+	 *
+	 * ## File layout (little-endian):
+	 * - `char[4]  magic`       - "SNKD"
+	 * - `uint16   version`     - `diff_stream_version`
+	 * - `uint16   reserved`
+	 * - `uint32   seed`
+	 * - `uint32   block_ticks`
+	 * - blocks, each `uint8 kind`:
+	 *   - 1 ticks - `uint8 encoding (0 raw, 1 run-length), uint64 first tick, uint32 tick count,
+	 *               uint32 raw size, uint32 stored size, uint8[stored size]`
+	 *   - 2 end   - `uint64 ticks, uint32 final score, uint8 outcome` (`diff_outcome`); the last block of a finished stream
+	 *
+	 * A block's raw payload is the keyframe of the board after `first tick` ticks,
+	 * `int16 head x, int16 head y, uint16 food cell (0xFFFF none), uint8 direction, uint32 score,
+	 * uint32 length, uint32 repeated tail segments, 2 bits per following segment`,
+	 * then one record per tick: `uint8 flags`, `[uint16 food cell]`. Flags are the direction the
+	 * head moved (bits 0-1, W D S A), 4 grew, 8 food moved, 16 the head did not move.
+	 * Cells are `y * boardWidth + x`; directions run clockwise from up as in `direction_index()`.
+	 */
+	constexpr std::uint16_t diff_stream_version = 1;
+
+	/// How the game of a finished stream ended: cut short by its writer, or over for good.
+	enum class diff_outcome : std::uint8_t { stopped, lost, won };
+
+	struct diff_stream_options {
+		std::uint32_t block_ticks = 4096;   ///< ticks per block, i.e. between keyframes
+		bool compress = true;               ///< run-length code each block; kept raw when that does not help
+		size_t buffer_bytes = 1 << 16;      ///< blocks are collected until this much is pending, then written at once
+	};
+
+	/// The board at one tick, as `diff_stream_reader` rebuilds it. Cells are board coordinates, not pixels.
+	struct diff_state {
+		std::uint64_t tick = 0;
+		unsigned int score = 0;
+		std::uint8_t direction = 0;         ///< `SnakeGame::getDirection()` as a `direction_index()`
+		sf::Vector2i food{ -1, -1 };        ///< {-1, -1} once the board is full
+		std::deque<sf::Vector2i> body;      ///< head first
+
+		bool operator==(const diff_state&) const = default;
+	};
+
+	namespace diff_detail {
+		constexpr std::uint8_t block_ticks = 1, block_end = 2;
+		constexpr std::uint8_t raw = 0, run_length = 1;
+		constexpr std::uint8_t grew = 4, food_moved = 8, stayed = 16;
+		constexpr std::uint16_t no_cell = 0xFFFF;
+		constexpr size_t block_header = 22;
+		constexpr int dx[4] = { 0, 1, 0, -1 }, dy[4] = { -1, 0, 1, 0 };
+
+		/// The food's cell index; the food sits off the board once the snake fills it.
+		inline std::uint16_t food_cell(sf::Vector2f food) {
+			const int cell = SnakeGame::cellIndex(food);
+			return cell < 0 ? no_cell : std::uint16_t(cell);
+		}
+
+		inline void put(std::vector<std::uint8_t>& out, std::uint64_t value, int bytes) {
+			for (int i = 0; i < bytes; ++i) out.push_back(std::uint8_t(value >> (8 * i)));
+		}
+
+		inline std::uint64_t get(const std::uint8_t* data, size_t& pos, int bytes) {
+			std::uint64_t value = 0;
+			for (int i = 0; i < bytes; ++i) value |= std::uint64_t(data[pos++]) << (8 * i);
+			return value;
+		}
+
+		/*
+		 * PackBits-style: a control byte `c < 128` is followed by `c + 1` literal bytes,
+		 * `c >= 128` by one byte repeated `c - 125` times (3 to 130). Straight stretches,
+		 * the bulk of a game, turn into runs of the same record byte.
+		 */
+		inline void run_length_encode(const std::uint8_t* in, size_t size, std::vector<std::uint8_t>& out) {
+			size_t i = 0, literal = 0;
+			auto flush_literal = [&](size_t end) {
+				while (literal < end) {
+					size_t n = std::min<size_t>(end - literal, 128);
+					out.push_back(std::uint8_t(n - 1));
+					out.insert(out.end(), in + literal, in + literal + n);
+					literal += n;
+				}
+			};
+			while (i < size) {
+				size_t run = 1;
+				while (i + run < size && run < 130 && in[i + run] == in[i]) ++run;
+				if (run >= 3) {
+					flush_literal(i);
+					out.push_back(std::uint8_t(run + 125));
+					out.push_back(in[i]);
+					i += run;
+					literal = i;
+				}
+				else
+					i += run;
+			}
+			flush_literal(size);
+		}
+
+		/// False when `in` does not decode to exactly `raw_size` bytes.
+		inline bool run_length_decode(const std::uint8_t* in, size_t size, size_t raw_size, std::vector<std::uint8_t>& out) {
+			out.resize(raw_size);
+			size_t pos = 0, o = 0;
+			while (pos < size) {
+				std::uint8_t c = in[pos++];
+				size_t n = c < 128 ? c + 1 : c - 125;
+				if (raw_size - o < n || (c < 128 ? size - pos < n : pos == size)) return false;
+				if (c < 128) { std::copy(in + pos, in + pos + n, out.data() + o); pos += n; }
+				else std::fill(out.data() + o, out.data() + o + n, in[pos++]);
+				o += n;
+			}
+			return o == raw_size;
+		}
+
+		inline bool write_all(int fd, const std::uint8_t* data, size_t size) {
+			while (size) {
+#ifdef _WIN32
+				int written = _write(fd, data, unsigned(std::min<size_t>(size, 1u << 30)));
+#else
+				ssize_t written = ::write(fd, data, size);
+#endif
+				if (written <= 0) return false;
+				data += written;
+				size -= size_t(written);
+			}
+			return true;
+		}
+	}
+
+	/// `game` in the reader's terms, to check a stream against the simulation.
+	template <typename Game>
+	diff_state make_diff_state(const Game& game) {
+		diff_state state;
+		state.tick = game.getTicks();
+		state.score = game.getScore();
+		state.direction = direction_index(game.getDirection());
+		if (game.getFood().x >= 0)
+			state.food = SnakeGame::cellOf(game.getFood());
+		for (const auto& segment : game.getBody())
+			state.body.push_back(SnakeGame::cellOf(segment.coords));
+		return state;
+	}
+
+	/// Opens (creating or truncating) `path` for a `diff_stream_writer`; "-" is standard output. -1 on failure.
+	inline int open_diff_stream(const std::string& path) {
+		if (path == "-") {
+#ifdef _WIN32
+			// text mode would turn every 0x0A of the stream into 0x0D 0x0A
+			if (_setmode(_fileno(stdout), _O_BINARY) == -1) return -1;
+#endif
+			return 1;
+		}
+#ifdef _WIN32
+		return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+		return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+	}
+
+	inline void close_diff_stream(int fd) {
+		if (fd <= 2) return;
+#ifdef _WIN32
+		_close(fd);
+#else
+		::close(fd);
+#endif
+	}
+
+	/*************************************************************************************
+	 * CLASS: `diff_stream_writer`
+	 *
+	 * Writes the stream of one game to a file descriptor (a file, a pipe, a socket) it
+	 * does not own. Call `capture(game)` after every tick, like `replay_recorder`, then
+	 * `finish()`. A tick costs a few comparisons and one or three bytes appended to
+	 * the open block; full blocks are compressed into the output buffer, which goes out
+	 * in one `write()` once `buffer_bytes` are pending.
+	 *************************************************************************************/
+
+	template <typename Game = SnakeGame>
+	class basic_diff_stream_writer {
+	private:
+		int fd;
+		diff_stream_options options;
+		std::vector<std::uint8_t> block;
+		std::vector<std::uint8_t> pending;
+		std::uint64_t block_first = 0;
+		std::uint32_t block_count = 0;
+		bool block_open = false;
+		bool good = true;
+		std::uint64_t ticks = 0;
+		unsigned int score = 0;
+		size_t length = 0;
+		sf::Vector2f head, food;
+		std::uint64_t blocks = 0, raw_bytes = 0, stored_bytes = 0, writes = 0;
+		diff_outcome outcome = diff_outcome::stopped;
+
+		void flush_pending() {
+			if (pending.empty()) return;
+			good = good && diff_detail::write_all(fd, pending.data(), pending.size());
+			pending.clear();
+			++writes;
+		}
+
+		void open_block(const Game& game) {
+			using namespace diff_detail;
+			block.clear();
+			block_first = game.getTicks();
+			block_count = 0;
+			block_open = true;
+
+			const auto& body = game.getBody();
+			const auto cell = [&](size_t i) { return SnakeGame::cellOf(body[i].coords); };
+			put(block, std::uint16_t(std::int16_t(cell(0).x)), 2);
+			put(block, std::uint16_t(std::int16_t(cell(0).y)), 2);
+			put(block, food_cell(game.getFood()), 2);
+			put(block, direction_index(game.getDirection()), 1);
+			put(block, game.getScore(), 4);
+			put(block, body.get_size(), 4);
+			// growing repeats the tail segment for a tick; those copies have no direction to store
+			size_t repeated = 0;
+			while (repeated + 1 < body.get_size() && body[body.get_size() - 1 - repeated].coords == body[body.get_size() - 2 - repeated].coords) ++repeated;
+			put(block, repeated, 4);
+			std::uint8_t packed = 0;
+			size_t linked = body.get_size() - repeated;
+			for (size_t i = 1; i < linked; ++i) {
+				sf::Vector2i step = cell(i) - cell(i - 1);
+				std::uint8_t dir = step.y < 0 ? 0 : step.x > 0 ? 1 : step.y > 0 ? 2 : 3;
+				packed |= std::uint8_t(dir << (2 * ((i - 1) % 4)));
+				if ((i - 1) % 4 == 3 || i + 1 == linked) { block.push_back(packed); packed = 0; }
+			}
+		}
+
+		void close_block() {
+			using namespace diff_detail;
+			block_open = false;
+			size_t header_at = pending.size();
+			pending.resize(header_at + block_header);
+			std::uint8_t encoding = raw;
+			if (options.compress) {
+				run_length_encode(block.data(), block.size(), pending);
+				encoding = run_length;
+				if (pending.size() - header_at - block_header >= block.size()) {
+					pending.resize(header_at + block_header);
+					encoding = raw;
+				}
+			}
+			if (encoding == raw) pending.insert(pending.end(), block.begin(), block.end());
+
+			std::vector<std::uint8_t> header;
+			header.reserve(block_header);
+			put(header, block_ticks, 1);
+			put(header, encoding, 1);
+			put(header, block_first, 8);
+			put(header, block_count, 4);
+			put(header, block.size(), 4);
+			put(header, pending.size() - header_at - block_header, 4);
+			std::copy(header.begin(), header.end(), pending.begin() + header_at);
+			raw_bytes += block.size();
+			stored_bytes += pending.size() - header_at;
+			++blocks;
+			if (pending.size() >= options.buffer_bytes) flush_pending();
+		}
+
+	public:
+		basic_diff_stream_writer(int fd_, const Game& game, const diff_stream_options& options_ = {})
+			: fd(fd_), options(options_), ticks(game.getTicks()), score(game.getScore()), length(game.getLength()), head(game.getHead()), food(game.getFood()) {
+			if (options.block_ticks == 0) options.block_ticks = 1;
+			block.reserve(size_t(options.block_ticks) * 3 + 21 + Game::boardWidth * Game::boardHeight / 4);
+			pending.reserve(options.buffer_bytes + block.capacity() + diff_detail::block_header);
+			pending.insert(pending.end(), { 'S', 'N', 'K', 'D' });
+			diff_detail::put(pending, diff_stream_version, 2);
+			diff_detail::put(pending, 0, 2);
+			diff_detail::put(pending, game.getSeed(), 4);
+			diff_detail::put(pending, options.block_ticks, 4);
+			raw_bytes = stored_bytes = pending.size();
+			open_block(game);
+		}
+
+		/// Returns false if ticks were skipped since the last capture or a write failed; the stream is then unusable.
+		/// Capturing the last tick again once `tick()` has refused to go on records how the game ended.
+		bool capture(const Game& game) {
+			using namespace diff_detail;
+			if (game.getTicks() == ticks) {
+				if (game.isWon()) outcome = diff_outcome::won;
+				else if (game.checkCollision()) outcome = diff_outcome::lost;
+				return good;
+			}
+			if (game.getTicks() != ticks + 1) return good = false;
+			if (!block_open) open_block(game);
+
+			sf::Vector2f now = game.getHead();
+			std::uint8_t flags = now == head ? stayed : std::uint8_t(now.y < head.y ? 0 : now.x > head.x ? 1 : now.y > head.y ? 2 : 3);
+			if (game.getLength() != length) {
+				flags |= grew;
+				length = game.getLength();
+				score = game.getScore();
+			}
+			sf::Vector2f food_now = game.getFood();
+			if (food_now != food) flags |= food_moved;
+			block.push_back(flags);
+			if (flags & food_moved)
+				put(block, food_cell(food_now), 2);
+			head = now;
+			food = food_now;
+			++ticks;
+			if (++block_count == options.block_ticks) {
+				close_block();
+				// the next block's keyframe is this tick's board
+				open_block(game);
+			}
+			return good;
+		}
+
+		/// Writes what is left and the end block. Returns false if any write failed.
+		bool finish() {
+			if (block_open && (block_count || !blocks)) close_block();
+			diff_detail::put(pending, diff_detail::block_end, 1);
+			diff_detail::put(pending, ticks, 8);
+			diff_detail::put(pending, score, 4);
+			diff_detail::put(pending, std::uint8_t(outcome), 1);
+			flush_pending();
+			return good;
+		}
+
+		bool is_good() const { return good; }
+		/// Bytes before and after compression, and the number of `write()` batches so far.
+		std::uint64_t get_raw_bytes() const { return raw_bytes; }
+		std::uint64_t get_stored_bytes() const { return stored_bytes; }
+		std::uint64_t get_writes() const { return writes; }
+	};
+
+	using diff_stream_writer = basic_diff_stream_writer<>;
+
+	/*************************************************************************************
+	 * CLASS: `diff_stream_reader`
+	 *
+	 * Loads a stream, indexes its blocks, and rebuilds the board at any tick: `seek()`
+	 * starts from the keyframe of the block holding the tick (or from where it already
+	 * is, when that is closer) and applies at most one block of diffs. `step()` plays
+	 * forward one tick. A stream cut off mid-write reads up to its last whole block.
+	 *************************************************************************************/
+
+	class diff_stream_reader {
+	private:
+		struct block_entry {
+			std::uint64_t first;
+			std::uint32_t count;
+			std::uint8_t encoding;
+			size_t offset, raw_size, stored_size;
+		};
+
+		static constexpr int width = SnakeGame::boardWidth;
+
+		std::vector<std::uint8_t> data;
+		std::vector<block_entry> blocks;
+		std::uint32_t seed = 0;
+		std::uint64_t ticks = 0;
+		unsigned int final_score = 0;
+		diff_outcome outcome = diff_outcome::stopped;
+		bool finished = false;
+		bool valid = false;
+
+		diff_state state;
+		size_t loaded = ~size_t(0);
+		std::vector<std::uint8_t> raw;
+		size_t pos = 0;
+
+		bool load_block(size_t index) {
+			const block_entry& b = blocks[index];
+			if (loaded != index) {
+				if (b.encoding == diff_detail::run_length) {
+					if (!diff_detail::run_length_decode(data.data() + b.offset, b.stored_size, b.raw_size, raw)) return false;
+				}
+				else raw.assign(data.begin() + b.offset, data.begin() + b.offset + b.raw_size);
+				loaded = index;
+			}
+			const std::uint8_t* p = raw.data();
+			pos = 0;
+			if (raw.size() < 21) return false;
+			state.tick = b.first;
+			sf::Vector2i cell{ std::int16_t(diff_detail::get(p, pos, 2)), std::int16_t(diff_detail::get(p, pos, 2)) };
+			std::uint16_t food = std::uint16_t(diff_detail::get(p, pos, 2));
+			state.food = food == diff_detail::no_cell ? sf::Vector2i{ -1, -1 } : sf::Vector2i{ food % width, food / width };
+			state.direction = std::uint8_t(diff_detail::get(p, pos, 1) & 3);
+			state.score = unsigned(diff_detail::get(p, pos, 4));
+			size_t length = size_t(diff_detail::get(p, pos, 4));
+			size_t repeated = size_t(diff_detail::get(p, pos, 4));
+			if (length == 0 || repeated >= length || raw.size() - pos < (length - repeated - 1 + 3) / 4) return false;
+			state.body.clear();
+			state.body.push_back(cell);
+			std::uint8_t packed = 0;
+			for (size_t i = 1; i < length - repeated; ++i) {
+				if ((i - 1) % 4 == 0) packed = p[pos++];
+				int dir = (packed >> (2 * ((i - 1) % 4))) & 3;
+				cell += { diff_detail::dx[dir], diff_detail::dy[dir] };
+				state.body.push_back(cell);
+			}
+			state.body.insert(state.body.end(), repeated, cell);
+			return true;
+		}
+
+		/// Applies the next record of the loaded block, the way `SnakeGame::tick()` changed the board.
+		bool apply_record() {
+			using namespace diff_detail;
+			if (pos >= raw.size()) return false;
+			std::uint8_t flags = raw[pos++];
+			sf::Vector2i old_head = state.body.front(), new_head = old_head;
+			if (!(flags & stayed)) {
+				state.direction = flags & 3;
+				new_head += { dx[flags & 3], dy[flags & 3] };
+			}
+			size_t length = state.body.size();
+			state.body.push_front(new_head);
+			state.body.pop_back();
+			if (flags & grew) {
+				// SnakeGame::add_snake(): the new segment copies the tail, or the old head for a lone head
+				state.body.push_back(length == 1 ? old_head : state.body.back());
+				++state.score;
+			}
+			if (flags & food_moved) {
+				if (raw.size() - pos < 2) return false;
+				std::uint16_t food = std::uint16_t(get(raw.data(), pos, 2));
+				state.food = food == no_cell ? sf::Vector2i{ -1, -1 } : sf::Vector2i{ food % width, food / width };
+			}
+			++state.tick;
+			return true;
+		}
+
+		size_t block_of(std::uint64_t tick) const {
+			auto it = std::upper_bound(blocks.begin(), blocks.end(), tick, [](std::uint64_t t, const block_entry& b) { return t < b.first; });
+			return size_t(it - blocks.begin()) - 1;
+		}
+
+	public:
+		bool load(const std::string& path) {
+			std::ifstream file(path, std::ios::binary);
+			return load(std::vector<std::uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+		}
+
+		/// Indexes a whole stream held in memory. False when it has no readable block.
+		bool load(std::vector<std::uint8_t> bytes) {
+			data = std::move(bytes);
+			blocks.clear();
+			loaded = ~size_t(0);
+			finished = valid = false;
+			outcome = diff_outcome::stopped;
+			if (data.size() < 16 || data[0] != 'S' || data[1] != 'N' || data[2] != 'K' || data[3] != 'D') return false;
+			size_t at = 4;
+			if (diff_detail::get(data.data(), at, 2) != diff_stream_version) return false;
+			at += 2;
+			seed = std::uint32_t(diff_detail::get(data.data(), at, 4));
+			at += 4;
+
+			while (at < data.size()) {
+				std::uint8_t kind = data[at];
+				if (kind == diff_detail::block_end && data.size() - at >= 14) {
+					++at;
+					ticks = diff_detail::get(data.data(), at, 8);
+					final_score = unsigned(diff_detail::get(data.data(), at, 4));
+					outcome = diff_outcome(std::min<std::uint64_t>(diff_detail::get(data.data(), at, 1), std::uint8_t(diff_outcome::won)));
+					finished = true;
+					break;
+				}
+				if (kind != diff_detail::block_ticks || data.size() - at < diff_detail::block_header) break;
+				size_t p = at + 1;
+				block_entry b;
+				b.encoding = std::uint8_t(diff_detail::get(data.data(), p, 1));
+				b.first = diff_detail::get(data.data(), p, 8);
+				b.count = std::uint32_t(diff_detail::get(data.data(), p, 4));
+				b.raw_size = size_t(diff_detail::get(data.data(), p, 4));
+				b.stored_size = size_t(diff_detail::get(data.data(), p, 4));
+				b.offset = p;
+				if (data.size() - p < b.stored_size || (b.encoding == diff_detail::raw && b.stored_size != b.raw_size)
+					|| (!blocks.empty() && b.first != blocks.back().first + blocks.back().count)) break;
+				blocks.push_back(b);
+				at = p + b.stored_size;
+			}
+			if (blocks.empty() || !load_block(0)) return false;
+			if (!finished) ticks = blocks.back().first + blocks.back().count;
+			valid = ticks == blocks.back().first + blocks.back().count;
+			return valid;
+		}
+
+		/// False when the stream was cut off before its end block.
+		bool is_complete() const { return finished; }
+		bool is_valid() const { return valid; }
+		std::uint32_t get_seed() const { return seed; }
+		std::uint64_t get_length() const { return ticks; }
+		unsigned int get_final_score() const { return final_score; }
+		/// `stopped` for a stream cut off or ended by its writer before the game was over.
+		diff_outcome get_outcome() const { return outcome; }
+		std::uint64_t get_tick() const { return state.tick; }
+		const diff_state& get_state() const { return state; }
+
+		/// Plays one tick. Returns false at the end of the stream.
+		bool step() {
+			if (!valid || state.tick >= ticks) return false;
+			const block_entry& b = blocks[loaded];
+			if (state.tick == b.first + b.count && !load_block(loaded + 1)) return valid = false;
+			return apply_record() || (valid = false);
+		}
+
+		/// Rebuilds the board after `tick` ticks (clamped to the end). False on a corrupt block.
+		bool seek(std::uint64_t tick) {
+			if (!valid) return false;
+			tick = std::min(tick, ticks);
+			size_t index = block_of(tick);
+			if ((index != loaded || tick < state.tick) && !load_block(index)) return valid = false;
+			while (state.tick < tick)
+				if (!apply_record()) return valid = false;
+			return true;
+		}
+	};
+}
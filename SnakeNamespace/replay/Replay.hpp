@@ -0,0 +1,239 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SnakeGame.hpp"
+
+namespace snake {
+	/*
+	 * @brief Compact, deterministic record of one `SnakeGame`.
+	 *
+	 * A game is fully determined by its seed and by the direction it actually moved in on every
+	 * tick, so that is all a replay stores. Directions are kept as runs: each run is one varint
+	 * `(run_length << 2) | turn`, where `turn` is relative to the previous run
+	 * (0 straight, 1 right, 3 left). A change of direction therefore costs about one byte and
+	 * a straight stretch costs nothing per tick.
+	 *
+	 * ## File layout (little-endian):
+	 * - `char[4]  magic`       - "SNKR"
+	 * - `uint16   version`     - `replay::version`
+	 * - `uint16   reserved`
+	 * - `uint32   seed`
+	 * - `uint32   final_score`
+	 * - `uint64   ticks`
+	 * - `uint64   stream_size`
+	 * - `uint8[]  stream`
+	 */
+	struct replay {
+		/// 2: seeds reproduce games of the xoshiro256** `SnakeGame`; version 1 replays were std::mt19937 games.
+		static constexpr std::uint16_t version = 2;
+
+		std::uint32_t seed = 0;
+		std::uint32_t final_score = 0;
+		std::uint64_t ticks = 0;
+		std::vector<std::uint8_t> stream;
+
+		bool save(const std::string& path) const {
+			std::vector<std::uint8_t> out;
+			out.reserve(32 + stream.size());
+			auto put = [&](std::uint64_t value, int bytes) {
+				for (int i = 0; i < bytes; ++i) out.push_back(std::uint8_t(value >> (8 * i)));
+			};
+			out.insert(out.end(), { 'S', 'N', 'K', 'R' });
+			put(version, 2);
+			put(0, 2);
+			put(seed, 4);
+			put(final_score, 4);
+			put(ticks, 8);
+			put(stream.size(), 8);
+			out.insert(out.end(), stream.begin(), stream.end());
+
+			std::ofstream file(path, std::ios::binary);
+			file.write(reinterpret_cast<const char*>(out.data()), std::streamsize(out.size()));
+			return bool(file);
+		}
+
+		bool load(const std::string& path) {
+			std::ifstream file(path, std::ios::binary);
+			std::vector<std::uint8_t> in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			const size_t header = 32;
+			if (in.size() < header || in[0] != 'S' || in[1] != 'N' || in[2] != 'K' || in[3] != 'R') return false;
+
+			size_t pos = 4;
+			auto get = [&](int bytes) {
+				std::uint64_t value = 0;
+				for (int i = 0; i < bytes; ++i) value |= std::uint64_t(in[pos++]) << (8 * i);
+				return value;
+			};
+			if (get(2) != version) return false;
+			get(2);
+			seed = std::uint32_t(get(4));
+			final_score = std::uint32_t(get(4));
+			ticks = get(8);
+			std::uint64_t size = get(8);
+			if (in.size() - header != size) return false;
+			stream.assign(in.begin() + header, in.end());
+			return true;
+		}
+	};
+
+	/// W, D, S, A <-> 0..3, i.e. clockwise from up
+	inline std::uint8_t direction_index(sf::Keyboard::Scancode key) {
+		switch (key) {
+		case sf::Keyboard::Scancode::D: return 1;
+		case sf::Keyboard::Scancode::S: return 2;
+		case sf::Keyboard::Scancode::A: return 3;
+		default: return 0;
+		}
+	}
+
+	inline sf::Keyboard::Scancode direction_key(std::uint8_t index) {
+		const sf::Keyboard::Scancode keys[4] = { sf::Keyboard::Scancode::W, sf::Keyboard::Scancode::D, sf::Keyboard::Scancode::S, sf::Keyboard::Scancode::A };
+		return keys[index & 3];
+	}
+
+	/*************************************************************************************
+	 * CLASS: `replay_recorder`
+	 *
+	 * Call `capture(game)` after every tick of the game being recorded (calling it
+	 * when no tick happened is harmless), then `finish(game)` once the game ends.
+	 *************************************************************************************/
+
+	class replay_recorder {
+	private:
+		replay data;
+		std::uint8_t base = 0;
+		std::uint8_t run_direction = 0;
+		std::uint64_t run_length = 0;
+
+		void flush() {
+			if (run_length == 0) return;
+			std::uint64_t value = (run_length << 2) | std::uint8_t((run_direction - base) & 3);
+			while (value >= 0x80) { data.stream.push_back(std::uint8_t(value | 0x80)); value >>= 7; }
+			data.stream.push_back(std::uint8_t(value));
+			base = run_direction;
+			run_length = 0;
+		}
+
+	public:
+		explicit replay_recorder(const SnakeGame& game) {
+			data.seed = game.getSeed();
+			base = direction_index(game.getDirection());
+			data.ticks = game.getTicks();
+		}
+
+		/// Returns false if ticks were skipped since the last capture, which makes the replay unusable.
+		bool capture(const SnakeGame& game) {
+			if (game.getTicks() == data.ticks) return true;
+			if (game.getTicks() != data.ticks + 1) return false;
+
+			std::uint8_t direction = direction_index(game.getDirection());
+			if (run_length == 0 || direction != run_direction) {
+				flush();
+				run_direction = direction;
+			}
+			++run_length;
+			++data.ticks;
+			return true;
+		}
+
+		const replay& finish(const SnakeGame& game) {
+			flush();
+			data.final_score = game.getScore();
+			return data;
+		}
+	};
+
+	/*************************************************************************************
+	 * CLASS: `replay_player`
+	 *
+	 * Re-simulates a replay through `SnakeGame::move()`/`tick()`. On construction it
+	 * plays the replay once and keeps a snapshot every `keyframe_interval` ticks, so
+	 * `seek()` later restores the nearest keyframe and steps at most one interval.
+	 *************************************************************************************/
+
+	class replay_player {
+	private:
+		struct cursor {
+			size_t offset = 0;
+			std::uint8_t direction = 0;
+			std::uint64_t remaining = 0;
+		};
+
+		struct keyframe {
+			SnakeGame::Snapshot state;
+			cursor at;
+		};
+
+		replay data;
+		SnakeGame game;
+		cursor at;
+		std::uint64_t interval;
+		std::vector<keyframe> keyframes;
+		bool valid = true;
+
+		bool next_direction(std::uint8_t& direction) {
+			if (at.remaining == 0) {
+				std::uint64_t value = 0;
+				int shift = 0;
+				while (true) {
+					if (at.offset >= data.stream.size() || shift > 63) return false;
+					std::uint8_t byte = data.stream[at.offset++];
+					value |= std::uint64_t(byte & 0x7F) << shift;
+					shift += 7;
+					if (!(byte & 0x80)) break;
+				}
+				at.direction = std::uint8_t((at.direction + (value & 3)) & 3);
+				at.remaining = value >> 2;
+				if (at.remaining == 0) return false;
+			}
+			--at.remaining;
+			direction = at.direction;
+			return true;
+		}
+
+	public:
+		explicit replay_player(replay replay_, std::uint64_t keyframe_interval = 256)
+			: data(std::move(replay_)), game(data.seed), interval(keyframe_interval ? keyframe_interval : 1) {
+			at.direction = direction_index(game.getDirection());
+			keyframes.push_back({ game.snapshot(), at });
+			while (get_tick() < data.ticks) {
+				if (!step()) { valid = false; break; }
+				if (get_tick() % interval == 0) keyframes.push_back({ game.snapshot(), at });
+			}
+			valid = valid && game.getScore() == data.final_score;
+			game.restore(keyframes[0].state);
+			at = keyframes[0].at;
+		}
+
+		/// False if the stream was malformed or did not reproduce the recorded score.
+		bool is_valid() const { return valid; }
+		bool is_finished() const { return get_tick() >= data.ticks; }
+		std::uint64_t get_tick() const { return game.getTicks(); }
+		std::uint64_t get_length() const { return data.ticks; }
+		const SnakeGame& get_game() const { return game; }
+
+		/// Plays one recorded tick. Returns false at the end of the replay.
+		bool step() {
+			std::uint8_t direction;
+			if (is_finished() || !next_direction(direction)) return false;
+			game.move(direction_key(direction));
+			return game.tick();
+		}
+
+		void seek(std::uint64_t tick) {
+			if (tick > data.ticks) tick = data.ticks;
+			size_t index = std::min<size_t>(size_t(tick / interval), keyframes.size() - 1);
+			if (tick < get_tick() || tick - get_tick() > tick - index * interval) {
+				game.restore(keyframes[index].state);
+				at = keyframes[index].at;
+			}
+			while (get_tick() < tick && step()) {}
+		}
+	};
+}
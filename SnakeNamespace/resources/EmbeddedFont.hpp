@@ -0,0 +1,287 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace snake {
+	namespace detail {
+		/// Printable ASCII 0x20..0x7E as 8x14 bitmaps, one byte per row (bit 7 = left), baseline under row 10.
+		/// Rasterized from DejaVu Sans Mono at 12 px (Bitstream Vera / DejaVu licence, renamed as it requires).
+		inline constexpr std::uint8_t fallback_glyphs[95][14] = {
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+			{ 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00 }, // '!'
+			{ 0x00, 0x00, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '"'
+			{ 0x00, 0x00, 0x00, 0x14, 0x24, 0x7E, 0x28, 0x28, 0xFC, 0x48, 0x50, 0x00, 0x00, 0x00 }, // '#'
+			{ 0x00, 0x00, 0x10, 0x38, 0x54, 0x50, 0x70, 0x1C, 0x14, 0x54, 0x38, 0x10, 0x10, 0x00 }, // '$'
+			{ 0x00, 0x00, 0x60, 0x90, 0x90, 0x64, 0x18, 0x6C, 0x12, 0x12, 0x0C, 0x00, 0x00, 0x00 }, // '%'
+			{ 0x00, 0x00, 0x1C, 0x20, 0x20, 0x30, 0x30, 0x4A, 0x4E, 0x64, 0x3A, 0x00, 0x00, 0x00 }, // '&'
+			{ 0x00, 0x00, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '\''
+			{ 0x00, 0x0C, 0x08, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x0C, 0x00, 0x00 }, // '('
+			{ 0x00, 0x30, 0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x08, 0x10, 0x10, 0x30, 0x00, 0x00 }, // ')'
+			{ 0x00, 0x00, 0x10, 0x54, 0x38, 0x38, 0x54, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '*'
+			{ 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0xFE, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 }, // '+'
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x20, 0x00, 0x00 }, // ','
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '-'
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00 }, // '.'
+			{ 0x00, 0x00, 0x02, 0x04, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x40, 0x00, 0x00 }, // '/'
+			{ 0x00, 0x00, 0x3C, 0x24, 0x42, 0x42, 0x4A, 0x42, 0x42, 0x24, 0x3C, 0x00, 0x00, 0x00 }, // '0'
+			{ 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00 }, // '1'
+			{ 0x00, 0x00, 0x3C, 0x42, 0x02, 0x02, 0x04, 0x08, 0x10, 0x20, 0x7E, 0x00, 0x00, 0x00 }, // '2'
+			{ 0x00, 0x00, 0x3C, 0x42, 0x02, 0x02, 0x1C, 0x02, 0x02, 0x42, 0x3C, 0x00, 0x00, 0x00 }, // '3'
+			{ 0x00, 0x00, 0x0C, 0x0C, 0x14, 0x34, 0x24, 0x44, 0x7E, 0x04, 0x04, 0x00, 0x00, 0x00 }, // '4'
+			{ 0x00, 0x00, 0x7C, 0x40, 0x40, 0x7C, 0x06, 0x02, 0x02, 0x46, 0x3C, 0x00, 0x00, 0x00 }, // '5'
+			{ 0x00, 0x00, 0x1C, 0x22, 0x40, 0x5C, 0x66, 0x42, 0x42, 0x26, 0x3C, 0x00, 0x00, 0x00 }, // '6'
+			{ 0x00, 0x00, 0x7E, 0x06, 0x04, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00, 0x00 }, // '7'
+			{ 0x00, 0x00, 0x3C, 0x42, 0x42, 0x42, 0x3C, 0x42, 0x42, 0x42, 0x3C, 0x00, 0x00, 0x00 }, // '8'
+			{ 0x00, 0x00, 0x3C, 0x64, 0x42, 0x42, 0x46, 0x3A, 0x02, 0x44, 0x38, 0x00, 0x00, 0x00 }, // '9'
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00 }, // ':'
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x20, 0x00, 0x00 }, // ';'
+			{ 0x00, 0x00, 0x00, 0x00, 0x02, 0x1C, 0x60, 0x60, 0x1C, 0x02, 0x00, 0x00, 0x00, 0x00 }, // '<'
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '='
+			{ 0x00, 0x00, 0x00, 0x00, 0x40, 0x38, 0x06, 0x06, 0x38, 0x40, 0x00, 0x00, 0x00, 0x00 }, // '>'
+			{ 0x00, 0x00, 0x1C, 0x22, 0x02, 0x0C, 0x18, 0x10, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00 }, // '?'
+			{ 0x00, 0x00, 0x00, 0x1C, 0x26, 0x42, 0x4E, 0x52, 0x52, 0x4E, 0x60, 0x20, 0x1C, 0x00 }, // '@'
+			{ 0x00, 0x00, 0x18, 0x18, 0x18, 0x24, 0x24, 0x24, 0x3C, 0x42, 0x42, 0x00, 0x00, 0x00 }, // 'A'
+			{ 0x00, 0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x00, 0x00, 0x00 }, // 'B'
+			{ 0x00, 0x00, 0x1C, 0x22, 0x40, 0x40, 0x40, 0x40, 0x40, 0x22, 0x1C, 0x00, 0x00, 0x00 }, // 'C'
+			{ 0x00, 0x00, 0x78, 0x44, 0x42, 0x42, 0x42, 0x42, 0x42, 0x44, 0x78, 0x00, 0x00, 0x00 }, // 'D'
+			{ 0x00, 0x00, 0x7E, 0x40, 0x40, 0x40, 0x7E, 0x40, 0x40, 0x40, 0x7E, 0x00, 0x00, 0x00 }, // 'E'
+			{ 0x00, 0x00, 0x7E, 0x40, 0x40, 0x40, 0x7E, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 }, // 'F'
+			{ 0x00, 0x00, 0x1C, 0x22, 0x40, 0x40, 0x46, 0x42, 0x42, 0x22, 0x1C, 0x00, 0x00, 0x00 }, // 'G'
+			{ 0x00, 0x00, 0x42, 0x42, 0x42, 0x42, 0x7E, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 }, // 'H'
+			{ 0x00, 0x00, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00 }, // 'I'
+			{ 0x00, 0x00, 0x1C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00 }, // 'J'
+			{ 0x00, 0x00, 0x42, 0x44, 0x48, 0x50, 0x70, 0x48, 0x4C, 0x44, 0x42, 0x00, 0x00, 0x00 }, // 'K'
+			{ 0x00, 0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7E, 0x00, 0x00, 0x00 }, // 'L'
+			{ 0x00, 0x00, 0x42, 0x66, 0x66, 0x5A, 0x5A, 0x5A, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 }, // 'M'
+			{ 0x00, 0x00, 0x62, 0x62, 0x52, 0x52, 0x5A, 0x4A, 0x4A, 0x46, 0x46, 0x00, 0x00, 0x00 }, // 'N'
+			{ 0x00, 0x00, 0x3C, 0x24, 0x42, 0x42, 0x42, 0x42, 0x42, 0x24, 0x3C, 0x00, 0x00, 0x00 }, // 'O'
+			{ 0x00, 0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 }, // 'P'
+			{ 0x00, 0x00, 0x3C, 0x24, 0x42, 0x42, 0x42, 0x42, 0x42, 0x26, 0x3C, 0x04, 0x04, 0x00 }, // 'Q'
+			{ 0x00, 0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x44, 0x42, 0x42, 0x41, 0x00, 0x00, 0x00 }, // 'R'
+			{ 0x00, 0x00, 0x3C, 0x42, 0x40, 0x60, 0x3C, 0x02, 0x02, 0x42, 0x3C, 0x00, 0x00, 0x00 }, // 'S'
+			{ 0x00, 0x00, 0xFE, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 }, // 'T'
+			{ 0x00, 0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3C, 0x00, 0x00, 0x00 }, // 'U'
+			{ 0x00, 0x00, 0x42, 0x42, 0x24, 0x24, 0x24, 0x24, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00 }, // 'V'
+			{ 0x00, 0x00, 0x82, 0x92, 0x92, 0xAA, 0xAA, 0xAA, 0x6C, 0x44, 0x44, 0x00, 0x00, 0x00 }, // 'W'
+			{ 0x00, 0x00, 0x42, 0x24, 0x24, 0x18, 0x18, 0x18, 0x24, 0x24, 0x42, 0x00, 0x00, 0x00 }, // 'X'
+			{ 0x00, 0x00, 0x82, 0x44, 0x28, 0x28, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 }, // 'Y'
+			{ 0x00, 0x00, 0x7E, 0x06, 0x04, 0x08, 0x18, 0x10, 0x20, 0x60, 0x7E, 0x00, 0x00, 0x00 }, // 'Z'
+			{ 0x00, 0x18, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x18, 0x00, 0x00 }, // '['
+			{ 0x00, 0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x08, 0x08, 0x04, 0x04, 0x02, 0x00, 0x00 }, // '\\'
+			{ 0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x30, 0x00, 0x00 }, // ']'
+			{ 0x00, 0x00, 0x30, 0x48, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '^'
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE }, // '_'
+			{ 0x00, 0x10, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '`'
+			{ 0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x04, 0x3C, 0x44, 0x44, 0x3C, 0x00, 0x00, 0x00 }, // 'a'
+			{ 0x00, 0x40, 0x40, 0x40, 0x78, 0x44, 0x44, 0x44, 0x44, 0x44, 0x78, 0x00, 0x00, 0x00 }, // 'b'
+			{ 0x00, 0x00, 0x00, 0x00, 0x38, 0x64, 0x40, 0x40, 0x40, 0x60, 0x3C, 0x00, 0x00, 0x00 }, // 'c'
+			{ 0x00, 0x04, 0x04, 0x04, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x00, 0x00, 0x00 }, // 'd'
+			{ 0x00, 0x00, 0x00, 0x00, 0x38, 0x64, 0x44, 0x7C, 0x40, 0x44, 0x38, 0x00, 0x00, 0x00 }, // 'e'
+			{ 0x00, 0x0C, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 }, // 'f'
+			{ 0x00, 0x00, 0x00, 0x00, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x04, 0x24, 0x18 }, // 'g'
+			{ 0x00, 0x40, 0x40, 0x40, 0x58, 0x64, 0x44, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, 0x00 }, // 'h'
+			{ 0x00, 0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00 }, // 'i'
+			{ 0x00, 0x08, 0x00, 0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x30 }, // 'j'
+			{ 0x00, 0x40, 0x40, 0x40, 0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x00, 0x00, 0x00 }, // 'k'
+			{ 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0C, 0x00, 0x00, 0x00 }, // 'l'
+			{ 0x00, 0x00, 0x00, 0x00, 0x7C, 0x54, 0x54, 0x54, 0x54, 0x54, 0x54, 0x00, 0x00, 0x00 }, // 'm'
+			{ 0x00, 0x00, 0x00, 0x00, 0x58, 0x64, 0x44, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, 0x00 }, // 'n'
+			{ 0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00, 0x00 }, // 'o'
+			{ 0x00, 0x00, 0x00, 0x00, 0x78, 0x44, 0x44, 0x44, 0x44, 0x44, 0x78, 0x40, 0x40, 0x40 }, // 'p'
+			{ 0x00, 0x00, 0x00, 0x00, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x04, 0x04, 0x04 }, // 'q'
+			{ 0x00, 0x00, 0x00, 0x00, 0x3C, 0x32, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00 }, // 'r'
+			{ 0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x40, 0x38, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00 }, // 's'
+			{ 0x00, 0x00, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1C, 0x00, 0x00, 0x00 }, // 't'
+			{ 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x00, 0x00, 0x00 }, // 'u'
+			{ 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x28, 0x10, 0x10, 0x00, 0x00, 0x00 }, // 'v'
+			{ 0x00, 0x00, 0x00, 0x00, 0x82, 0x82, 0x54, 0x54, 0x6C, 0x28, 0x28, 0x00, 0x00, 0x00 }, // 'w'
+			{ 0x00, 0x00, 0x00, 0x00, 0x44, 0x28, 0x28, 0x10, 0x28, 0x28, 0x44, 0x00, 0x00, 0x00 }, // 'x'
+			{ 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x28, 0x30, 0x10, 0x10, 0x20, 0x60 }, // 'y'
+			{ 0x00, 0x00, 0x00, 0x00, 0x7C, 0x04, 0x08, 0x10, 0x20, 0x40, 0x7C, 0x00, 0x00, 0x00 }, // 'z'
+			{ 0x00, 0x1C, 0x10, 0x10, 0x10, 0x10, 0x60, 0x10, 0x10, 0x10, 0x10, 0x1C, 0x00, 0x00 }, // '{'
+			{ 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00 }, // '|'
+			{ 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x0C, 0x10, 0x10, 0x10, 0x10, 0x70, 0x00, 0x00 }, // '}'
+			{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '~'
+		};
+
+		inline void put16(std::vector<std::uint8_t>& out, int value) {
+			out.push_back(std::uint8_t(value >> 8));
+			out.push_back(std::uint8_t(value));
+		}
+
+		inline void put32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+			put16(out, int(value >> 16));
+			put16(out, int(value & 0xFFFF));
+		}
+
+		inline std::uint32_t table_checksum(const std::uint8_t* data, size_t size) {
+			std::uint32_t sum = 0;
+			for (size_t i = 0; i < size; i += 4) {
+				std::uint32_t word = 0;
+				for (size_t j = 0; j < 4; ++j) word = word << 8 | (i + j < size ? data[i + j] : 0);
+				sum += word;
+			}
+			return sum;
+		}
+	}
+
+	/*************************************************************************************
+	 * FUNCTION: `embedded_font_data()`
+	 *
+	 * A TrueType font compiled into the binary, for when no font file can be found.
+	 * It is assembled once, on first use, from `detail::fallback_glyphs`: every run of set
+	 * pixels in a row becomes one square-cornered contour, so the result is a blocky
+	 * monospace font that FreeType (and so `sf::Font::openFromMemory`) scales like any
+	 * other. The bytes live until exit, as `sf::Font` reads them lazily.
+	 *************************************************************************************/
+
+	inline const std::vector<std::uint8_t>& embedded_font_data() {
+		static const std::vector<std::uint8_t> font = [] {
+			using detail::put16;
+			using detail::put32;
+			constexpr int pixel = 128, rows = 14, ascent_rows = 11, advance = 7 * pixel;
+			constexpr int glyph_count = 96; // .notdef + 95 printable characters
+			constexpr int units_per_em = 12 * pixel;
+
+			// glyf and loca, collecting the metrics the other tables need
+			std::vector<std::uint8_t> glyf, loca, hmtx;
+			int max_points = 0, max_contours = 0;
+			int x_min = 0, y_min = 0, x_max = 0, y_max = 0;
+			for (int g = 0; g < glyph_count; ++g) {
+				put32(loca, std::uint32_t(glyf.size()));
+				struct run { int x0, x1, y0, y1; };
+				std::vector<run> runs;
+				if (g == 0) {
+					runs = { { pixel, 6 * pixel, 0, 9 * pixel } }; // .notdef: a solid box
+				}
+				else {
+					for (int r = 0; r < rows; ++r) {
+						std::uint8_t bits = detail::fallback_glyphs[g - 1][r];
+						int top = (ascent_rows - r) * pixel;
+						for (int x = 0; x < 8;) {
+							if (!(bits & (0x80 >> x))) { ++x; continue; }
+							int start = x;
+							while (x < 8 && bits & (0x80 >> x)) ++x;
+							runs.push_back({ start * pixel, x * pixel, top - pixel, top });
+						}
+					}
+				}
+				int lsb = 0;
+				if (!runs.empty()) {
+					int gx0 = runs[0].x0, gy0 = runs[0].y0, gx1 = runs[0].x1, gy1 = runs[0].y1;
+					for (const run& r : runs) {
+						gx0 = std::min(gx0, r.x0); gy0 = std::min(gy0, r.y0);
+						gx1 = std::max(gx1, r.x1); gy1 = std::max(gy1, r.y1);
+					}
+					x_min = std::min(x_min, gx0); y_min = std::min(y_min, gy0);
+					x_max = std::max(x_max, gx1); y_max = std::max(y_max, gy1);
+					lsb = gx0;
+					max_contours = std::max(max_contours, int(runs.size()));
+					max_points = std::max(max_points, int(runs.size()) * 4);
+
+					put16(glyf, int(runs.size()));
+					put16(glyf, gx0); put16(glyf, gy0); put16(glyf, gx1); put16(glyf, gy1);
+					for (size_t i = 0; i < runs.size(); ++i) put16(glyf, int(i * 4 + 3));
+					put16(glyf, 0); // no instructions
+					for (size_t i = 0; i < runs.size() * 4; ++i) glyf.push_back(0x01); // on-curve, 16-bit deltas
+					// clockwise outer contours: bottom-left, top-left, top-right, bottom-right
+					int px = 0, py = 0;
+					std::vector<std::uint8_t> ys;
+					for (const run& r : runs) {
+						const int xs[4] = { r.x0, r.x0, r.x1, r.x1 }, ys_[4] = { r.y0, r.y1, r.y1, r.y0 };
+						for (int k = 0; k < 4; ++k) {
+							put16(glyf, xs[k] - px);
+							put16(ys, ys_[k] - py);
+							px = xs[k];
+							py = ys_[k];
+						}
+					}
+					glyf.insert(glyf.end(), ys.begin(), ys.end());
+					while (glyf.size() % 4) glyf.push_back(0);
+				}
+				put16(hmtx, advance);
+				put16(hmtx, lsb);
+			}
+			put32(loca, std::uint32_t(glyf.size()));
+
+			std::vector<std::uint8_t> head;
+			put32(head, 0x00010000); put32(head, 0x00010000);
+			put32(head, 0);          // checkSumAdjustment, patched below
+			put32(head, 0x5F0F3CF5);
+			put16(head, 0x000B); put16(head, units_per_em);
+			for (int i = 0; i < 4; ++i) put32(head, 0); // created, modified
+			put16(head, x_min); put16(head, y_min); put16(head, x_max); put16(head, y_max);
+			put16(head, 0); put16(head, 8); put16(head, 2);
+			put16(head, 1);          // long loca offsets
+			put16(head, 0);
+
+			std::vector<std::uint8_t> hhea;
+			put32(hhea, 0x00010000);
+			put16(hhea, ascent_rows * pixel); put16(hhea, -(rows - ascent_rows) * pixel); put16(hhea, 0);
+			put16(hhea, advance); put16(hhea, 0); put16(hhea, advance - x_max); put16(hhea, x_max);
+			put16(hhea, 1); put16(hhea, 0); put16(hhea, 0);
+			for (int i = 0; i < 5; ++i) put16(hhea, 0);
+			put16(hhea, glyph_count);
+
+			std::vector<std::uint8_t> maxp;
+			put32(maxp, 0x00010000);
+			put16(maxp, glyph_count); put16(maxp, max_points); put16(maxp, max_contours);
+			put16(maxp, 0); put16(maxp, 0); put16(maxp, 2);
+			for (int i = 0; i < 8; ++i) put16(maxp, 0);
+
+			// format 4: 0x20..0x7E map to glyphs 1..95
+			std::vector<std::uint8_t> cmap;
+			put16(cmap, 0); put16(cmap, 1);
+			put16(cmap, 3); put16(cmap, 1); put32(cmap, 12);
+			put16(cmap, 4); put16(cmap, 32); put16(cmap, 0);
+			put16(cmap, 4); put16(cmap, 4); put16(cmap, 1); put16(cmap, 0); // 2 segments
+			put16(cmap, 0x7E); put16(cmap, 0xFFFF); put16(cmap, 0);
+			put16(cmap, 0x20); put16(cmap, 0xFFFF);
+			put16(cmap, 1 - 0x20); put16(cmap, 1);
+			put16(cmap, 0); put16(cmap, 0);
+
+			std::vector<std::uint8_t> name;
+			const char* family = "Snake Fallback";
+			size_t family_length = std::char_traits<char>::length(family);
+			put16(name, 0); put16(name, 2); put16(name, 6 + 2 * 12);
+			for (int id : { 1, 4 }) { // family and full name, Windows Unicode BMP, en-US
+				put16(name, 3); put16(name, 1); put16(name, 0x409); put16(name, id);
+				put16(name, int(family_length * 2)); put16(name, 0);
+			}
+			for (size_t i = 0; i < family_length; ++i) put16(name, family[i]);
+
+			std::vector<std::uint8_t> post;
+			put32(post, 0x00030000);
+			for (int i = 0; i < 7; ++i) put32(post, 0);
+			post[12 + 3] = 1; // isFixedPitch
+
+			struct table { const char* tag; const std::vector<std::uint8_t>* data; };
+			const table tables[] = { { "cmap", &cmap }, { "glyf", &glyf }, { "head", &head }, { "hhea", &hhea },
+				{ "hmtx", &hmtx }, { "loca", &loca }, { "maxp", &maxp }, { "name", &name }, { "post", &post } };
+			constexpr int table_count = int(sizeof(tables) / sizeof(tables[0]));
+
+			std::vector<std::uint8_t> out;
+			put32(out, 0x00010000);
+			put16(out, table_count); put16(out, 128); put16(out, 3); put16(out, table_count * 16 - 128);
+			size_t offset = 12 + 16 * table_count, head_offset = 0;
+			for (const table& t : tables) {
+				out.insert(out.end(), t.tag, t.tag + 4);
+				put32(out, detail::table_checksum(t.data->data(), t.data->size()));
+				put32(out, std::uint32_t(offset));
+				put32(out, std::uint32_t(t.data->size()));
+				if (t.data == &head) head_offset = offset;
+				offset += (t.data->size() + 3) & ~size_t(3);
+			}
+			for (const table& t : tables) {
+				out.insert(out.end(), t.data->begin(), t.data->end());
+				while (out.size() % 4) out.push_back(0);
+			}
+			std::uint32_t adjustment = 0xB1B0AFBAu - detail::table_checksum(out.data(), out.size());
+			for (int i = 0; i < 4; ++i) out[head_offset + 8 + i] = std::uint8_t(adjustment >> (24 - 8 * i));
+			return out;
+		}();
+		return font;
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "SnakeNamespace/resources/EmbeddedFont.hpp"
+
+namespace snake {
+	/// Refers to a font owned by a `resource_manager`; cheap to copy, valid as long as the manager.
+	struct font_handle {
+		std::uint32_t index = ~std::uint32_t(0);
+		bool valid() const { return index != ~std::uint32_t(0); }
+	};
+
+	/*************************************************************************************
+	 * CLASS: `resource_manager`
+	 *
+	 * Loads every asset once and hands out handles to it. `load_font()` with a key that
+	 * was loaded before returns the same handle without touching the disk. A font is
+	 * looked for in a list of paths and falls back to `embedded_font_data()`, so the game
+	 * starts on systems that have none of the candidates.
+	 *
+	 * `prewarm()` renders the glyphs of known strings on a background thread. Start it
+	 * once the first frame is on screen, so it does not compete with creating the window
+	 * and its context; the font must not be drawn with until `wait_prewarm()` has
+	 * returned (`sf::Font` is not thread-safe).
+	 *************************************************************************************/
+
+	class resource_manager {
+	private:
+		struct font_entry {
+			std::string key;
+			std::string source;
+			std::unique_ptr<sf::Font> font;
+		};
+
+		std::vector<font_entry> fonts;
+		size_t file_opens = 0;
+		double load_ms = 0;
+		std::thread prewarm_worker;
+		double prewarm_ms = 0;
+
+	public:
+		resource_manager() = default;
+		resource_manager(const resource_manager&) = delete;
+		resource_manager& operator=(const resource_manager&) = delete;
+		~resource_manager() { wait_prewarm(); }
+
+		/// A file next to the executable first, then the usual system fonts.
+		static const std::vector<std::string>& default_font_paths() {
+			static const std::vector<std::string> paths = {
+				"font.ttf",
+				"C:/Windows/Fonts/arial.ttf",
+				"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+				"/usr/share/fonts/TTF/DejaVuSans.ttf",
+				"/System/Library/Fonts/Supplemental/Arial.ttf",
+				"/Library/Fonts/Arial.ttf",
+			};
+			return paths;
+		}
+
+		font_handle load_font(const std::string& key, const std::vector<std::string>& candidates = default_font_paths()) {
+			for (size_t i = 0; i < fonts.size(); ++i)
+				if (fonts[i].key == key) return { std::uint32_t(i) };
+
+			auto start = std::chrono::steady_clock::now();
+			font_entry entry{ key, {}, std::make_unique<sf::Font>() };
+			for (const std::string& path : candidates) {
+				++file_opens;
+				if (entry.font->openFromFile(path)) { entry.source = path; break; }
+			}
+			if (entry.source.empty()) {
+				const std::vector<std::uint8_t>& data = embedded_font_data();
+				entry.font->openFromMemory(data.data(), data.size());
+				entry.source = "<embedded>";
+			}
+			fonts.push_back(std::move(entry));
+			load_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			return { std::uint32_t(fonts.size() - 1) };
+		}
+
+		const sf::Font& get_font(font_handle handle) const { return *fonts[handle.index].font; }
+		/// The path the font came from, or "<embedded>".
+		const std::string& get_font_source(font_handle handle) const { return fonts[handle.index].source; }
+		size_t get_font_count() const { return fonts.size(); }
+		/// Paths tried so far, including the ones that failed.
+		size_t get_file_opens() const { return file_opens; }
+		double get_load_ms() const { return load_ms; }
+		double get_prewarm_ms() const { return prewarm_ms; }
+
+		/// Builds the glyphs of every (string, character size) pair in the background.
+		void prewarm(font_handle handle, std::vector<std::pair<std::string, unsigned int>> texts) {
+			wait_prewarm();
+			const sf::Font* font = fonts[handle.index].font.get();
+			prewarm_worker = std::thread([this, font, texts = std::move(texts)] {
+				auto start = std::chrono::steady_clock::now();
+				for (const auto& [text, size] : texts)
+					for (char c : text)
+						font->getGlyph(char32_t(static_cast<unsigned char>(c)), size, false);
+				prewarm_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			});
+		}
+
+		void wait_prewarm() {
+			if (prewarm_worker.joinable()) prewarm_worker.join();
+		}
+	};
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/bots/Autopilot.hpp"
+#include "SnakeNamespace/input/InputQueue.hpp"
+#include "SnakeNamespace/render/CellVertexBuffer.hpp"
+#include "SnakeNamespace/replay/Replay.hpp"
+#include "SnakeNamespace/threading/SimulationThread.hpp"
+
+namespace snake {
+	/*************************************************************************************
+	 * CLASS: `game_session`
+	 *
+	 * Everything one game needs while the GAME scene is active: the game and its
+	 * simulation thread, the input queue, the autopilot, the replay recorder and the
+	 * board's vertex buffer. It renders into whatever window the menu uses, so starting
+	 * a game costs one thread start and no window or GL context.
+	 *
+	 * Construct it (e.g. `std::optional::emplace`) to start a game and call `finish()` or
+	 * destroy it to end one. The game, recorder, pilot and flags belong to the simulation
+	 * thread until `finish()`; the render thread uses `key_pressed()`, `latest()` and `draw()`.
+	 *************************************************************************************/
+
+	class game_session {
+	private:
+		SnakeGame game;
+		replay_recorder recorder{ game };
+		bool recording = true;
+		autopilot pilot;
+		bool autopilot_on = false;
+		input_queue input;
+		cell_vertex_buffer cells;
+		std::uint64_t shown_tick = 0;
+		bool finished = false;
+		sf::Time period;
+		bool turbo = false;
+		// last member: its destructor stops the thread before the state above goes away
+		simulation_thread simulation;
+
+	public:
+		explicit game_session(sf::Time period_ = sf::milliseconds(100))
+			: period(period_), simulation(game, input, period_,
+				[this](SnakeGame& g) {
+					if (autopilot_on)
+						g.move(pilot.decide(g));
+				},
+				[this](SnakeGame& g) { recorder.capture(g); }) {}
+
+		game_session(const game_session&) = delete;
+		game_session& operator=(const game_session&) = delete;
+
+		/// WASD steer, P toggles the autopilot, T toggles turbo (ticks as fast as they run), F5 quicksaves, F9 quickloads. False for keys it does not use.
+		bool key_pressed(sf::Keyboard::Scancode key) {
+			using sf::Keyboard::Scancode;
+			if (key == Scancode::W || key == Scancode::S || key == Scancode::A || key == Scancode::D)
+				input.push(key);
+			else if (key == Scancode::P)
+				simulation.post([this](SnakeGame&) { autopilot_on = !autopilot_on; });
+			else if (key == Scancode::T) {
+				turbo = !turbo;
+				simulation.set_period(get_period());
+			}
+			else if (key == Scancode::F5) {
+				simulation.post([](SnakeGame& g) {
+					std::vector<unsigned char> state = g.saveState();
+					std::ofstream("quicksave.snks", std::ios::binary).write(reinterpret_cast<const char*>(state.data()), std::streamsize(state.size()));
+				});
+			}
+			else if (key == Scancode::F9) {
+				simulation.post([this](SnakeGame& g) {
+					std::ifstream file("quicksave.snks", std::ios::binary);
+					std::vector<unsigned char> state((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+					// a replay cannot describe a game that jumped to another state
+					if (g.loadState(state.data(), state.size())) {
+						recording = false;
+						input.clear();
+					}
+				});
+			}
+			else
+				return false;
+			return true;
+		}
+
+		/// The current tick period; zero in turbo.
+		sf::Time get_period() const { return turbo ? sf::Time::Zero : period; }
+
+		/// The most recent frame from the simulation thread. Valid until the next call.
+		const frame& latest() { return simulation.latest(); }
+
+		/// Draws `shown`, normally the frame just returned by `latest()`.
+		void draw(sf::RenderTarget& target, const frame& shown) {
+			cells.sync(shown.tick, shown.body.size(), [&](size_t i) { return shown.body[i]; }, shown.food);
+			target.draw(cells);
+		}
+
+		/// Stops the simulation and saves the replay to `replay_path` (nowhere if empty) unless it was invalidated. Idempotent.
+		void finish(const std::string& replay_path = "last_game.snkr") {
+			if (finished)
+				return;
+			finished = true;
+			simulation.stop();
+			if (recording && !replay_path.empty())
+				recorder.finish(game).save(replay_path);
+		}
+
+		~game_session() { finish(); }
+	};
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/input/InputQueue.hpp"
+#include "SnakeNamespace/threading/TripleBuffer.hpp"
+#include "SnakeNamespace/profiling/Trace.hpp"
+#include "SnakeNamespace/render/RenderBackend.hpp"
+
+namespace snake {
+	/// Immutable picture of one tick, drawn by the render thread exactly like `SnakeGame::draw()`.
+	struct frame : public sf::Drawable {
+		std::vector<sf::Vector2f> body; ///< head first
+		sf::Vector2f food;
+		std::uint64_t tick = 0;
+		unsigned int score = 0;
+		bool alive = true;
+		std::int64_t input_ns = 0;     ///< press time of the latest direction change this frame shows
+		std::int64_t published_ns = 0;
+		std::int64_t tick_ns = 0;      ///< time the simulation spent producing this frame's tick
+
+		void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+			sfml_backend backend(target, states);
+			render(backend);
+		}
+
+		void render(render_backend& backend) const {
+			const float cell = float(SnakeGame::cellSize);
+			for (size_t i = 0; i < body.size(); ++i)
+				backend.fill_rect({ body[i], { cell, cell } }, i == 0 ? sf::Color::Red : sf::Color::Green);
+
+			backend.fill_circle(food, cell / 2, sf::Color::White);
+		}
+	};
+
+	/*************************************************************************************
+	 * CLASS: `simulation_thread`
+	 *
+	 * Ticks a `SnakeGame` on its own thread at a fixed period, independent of how long
+	 * the render thread spends in `display()`. After every tick it publishes a `frame`
+	 * through a `triple_buffer`; `latest()` on the render thread never blocks.
+	 *
+	 * The game, and anything the hooks capture, belong to the simulation thread until
+	 * `stop()` returns. The render thread talks to it only through the `input_queue`
+	 * (direction keys) and `post()` (everything else, run before the next tick).
+	 *************************************************************************************/
+
+	class simulation_thread {
+	public:
+		using hook = std::function<void(SnakeGame&)>;
+
+	private:
+		SnakeGame& game;
+		input_queue& input;
+		std::atomic<std::int64_t> period_us;
+		hook before_tick, after_tick;
+
+		spsc_queue<hook, 16> commands;
+		triple_buffer<frame> frames;
+		std::int64_t last_press_ns = 0;
+		std::atomic<bool> stopping{ false };
+		std::thread worker;
+
+		void publish(bool alive, std::int64_t tick_ns = 0) {
+			frame& next = frames.write_buffer();
+			next.body.clear();
+			for (const auto& segment : game.getBody())
+				next.body.push_back(segment.coords);
+			next.food = game.getFood();
+			next.tick = game.getTicks();
+			next.score = game.getScore();
+			next.alive = alive;
+			next.input_ns = last_press_ns;
+			next.published_ns = input_queue::now_ns();
+			next.tick_ns = tick_ns;
+			frames.publish();
+		}
+
+		void run() {
+			using clock = std::chrono::steady_clock;
+			auto deadline = clock::now();
+			tracer::instance().set_thread_name("simulation");
+			while (!stopping.load(std::memory_order_relaxed)) {
+				const std::chrono::microseconds period(period_us.load(std::memory_order_relaxed));
+				deadline += period;
+				if (period.count())
+					std::this_thread::sleep_until(deadline);
+				std::int64_t start_ns = input_queue::now_ns();
+				trace_scope traced("tick");
+
+				hook command;
+				while (commands.try_pop(command)) command(game);
+				if (input.apply(game)) last_press_ns = input.get_last_pressed_ns();
+				if (before_tick) before_tick(game);
+				bool alive = game.tick();
+				if (after_tick) after_tick(game);
+				publish(alive, input_queue::now_ns() - start_ns);
+				if (!alive) {
+					std::cout << (game.isWon() ? "You win!" : "Game over!") << std::endl;
+					break;
+				}
+				// more than a whole tick behind (suspended, debugger): carry on from now instead of bursting
+				if (clock::now() - deadline > period) deadline = clock::now();
+			}
+		}
+
+	public:
+		simulation_thread(SnakeGame& game_, input_queue& input_, sf::Time period_, hook before = {}, hook after = {})
+			: game(game_), input(input_), period_us(period_.asMicroseconds()), before_tick(std::move(before)), after_tick(std::move(after)) {
+			publish(true);
+			worker = std::thread([this] { run(); });
+		}
+
+		~simulation_thread() { stop(); }
+
+		simulation_thread(const simulation_thread&) = delete;
+		simulation_thread& operator=(const simulation_thread&) = delete;
+
+		/// Runs `command` on the simulation thread before its next tick. False if too many are pending.
+		bool post(hook command) { return commands.try_push(std::move(command)); }
+
+		/// Takes effect from the next tick. `sf::Time::Zero` ticks back to back (turbo).
+		void set_period(sf::Time period_) { period_us.store(period_.asMicroseconds(), std::memory_order_relaxed); }
+
+		/// Render side: the most recent complete frame. Valid until the next call.
+		const frame& latest() {
+			frames.update();
+			return frames.read_buffer();
+		}
+
+		/// Ends the loop after the current tick and joins. Afterwards the game may be used again.
+		void stop() {
+			stopping = true;
+			if (worker.joinable()) worker.join();
+		}
+	};
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace snake {
+	/*
+	 * @brief Small work-stealing thread pool used by the data-parallel game modes.
+	 *
+	 * The pool owns `thread_count - 1` worker threads; the thread calling `parallel_for`
+	 * always takes part as the last participant, so a pool of 1 runs everything inline.
+	 *
+	 * ## Scheduling:
+	 * - A `parallel_for` range is cut into chunks of `grain` indices.
+	 * - Chunks are dealt out in contiguous blocks, one block per participant queue.
+	 * - Every participant pops from the back of its own queue and, once it is empty,
+	 *   steals from the front of the other queues.
+	 *
+	 * Only one `parallel_for` may be in flight at a time and the body must not throw.
+	 */
+	class thread_pool {
+	private:
+		struct job {
+			const std::function<void(size_t, size_t)>* body = nullptr;
+			std::atomic<size_t> remaining{ 0 };
+		};
+
+		struct chunk {
+			size_t begin, end;
+			job* owner;
+		};
+
+		struct chunk_queue {
+			std::mutex lock;
+			std::deque<chunk> chunks;
+		};
+
+		std::vector<std::thread> workers;
+		std::vector<std::unique_ptr<chunk_queue>> queues;
+
+		std::mutex sleep_lock;
+		std::condition_variable wake;
+		std::atomic<size_t> epoch{ 0 };
+		bool stopping = false;
+
+		static constexpr int spin_rounds = 4096;
+
+		/*************************************************************************************
+		 * PRIVATE FUNCTION: `try_pop(size_t index, chunk& out)`
+		 *
+		 * Pops the newest chunk of participant `index`, falling back to stealing the
+		 * oldest chunk of any other participant. Returns false when every queue is empty.
+		 *************************************************************************************/
+
+		bool try_pop(size_t index, chunk& out) {
+			{
+				chunk_queue& own = *queues[index];
+				std::lock_guard<std::mutex> guard(own.lock);
+				if (!own.chunks.empty()) {
+					out = own.chunks.back();
+					own.chunks.pop_back();
+					return true;
+				}
+			}
+			for (size_t i = 1; i < queues.size(); ++i) {
+				chunk_queue& victim = *queues[(index + i) % queues.size()];
+				std::lock_guard<std::mutex> guard(victim.lock);
+				if (!victim.chunks.empty()) {
+					out = victim.chunks.front();
+					victim.chunks.pop_front();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void run_chunks(size_t index) {
+			chunk c;
+			while (try_pop(index, c)) {
+				(*c.owner->body)(c.begin, c.end);
+				c.owner->remaining.fetch_sub(1, std::memory_order_acq_rel);
+			}
+		}
+
+		void worker_loop(size_t index) {
+			size_t seen = 0;
+			while (true) {
+				// back-to-back jobs (one per tick phase) are picked up without a futex round-trip
+				for (int spin = 0; spin < spin_rounds && epoch.load(std::memory_order_acquire) == seen; ++spin)
+					std::this_thread::yield();
+				{
+					std::unique_lock<std::mutex> guard(sleep_lock);
+					wake.wait(guard, [&] { return stopping || epoch.load(std::memory_order_relaxed) != seen; });
+					if (stopping) return;
+					seen = epoch.load(std::memory_order_relaxed);
+				}
+				run_chunks(index);
+			}
+		}
+
+	public:
+		/*********************************************************************
+		 * CONSTRUCTOR: `thread_pool(size_t thread_count)`
+		 *
+		 * Starts `thread_count - 1` workers. A count of 0 means one
+		 * participant per hardware thread.
+		 *********************************************************************/
+
+		explicit thread_pool(size_t thread_count = 0) {
+			if (thread_count == 0) thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+			for (size_t i = 0; i < thread_count; ++i) queues.push_back(std::make_unique<chunk_queue>());
+			for (size_t i = 0; i + 1 < thread_count; ++i) workers.emplace_back(&thread_pool::worker_loop, this, i);
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		~thread_pool() {
+			{
+				std::lock_guard<std::mutex> guard(sleep_lock);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (auto& worker : workers) worker.join();
+		}
+
+		/// Number of participants, including the calling thread.
+		size_t get_thread_count() const { return queues.size(); }
+
+		/*************************************************************************************
+		 * PARALLEL_FOR FUNCTION: `parallel_for(size_t begin, size_t end, size_t grain, body)`
+		 *
+		 * Calls `body(lo, hi)` for disjoint sub-ranges covering [begin, end) and
+		 * returns once all of them have finished. `grain` is the sub-range length.
+		 *************************************************************************************/
+
+		void parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body) {
+			if (begin >= end) return;
+			if (grain == 0) grain = 1;
+			size_t chunk_count = (end - begin + grain - 1) / grain;
+			if (queues.size() == 1 || chunk_count == 1) {
+				body(begin, end);
+				return;
+			}
+
+			job current;
+			current.body = &body;
+			current.remaining.store(chunk_count, std::memory_order_relaxed);
+
+			size_t participants = queues.size();
+			size_t per_queue = (chunk_count + participants - 1) / participants;
+			for (size_t q = 0; q < participants; ++q) {
+				std::lock_guard<std::mutex> guard(queues[q]->lock);
+				for (size_t c = q * per_queue; c < std::min(chunk_count, (q + 1) * per_queue); ++c) {
+					size_t lo = begin + c * grain;
+					// pushed in reverse so that popping from the back walks the block in order
+					queues[q]->chunks.push_front({ lo, std::min(end, lo + grain), &current });
+				}
+			}
+			{
+				std::lock_guard<std::mutex> guard(sleep_lock);
+				epoch.fetch_add(1, std::memory_order_release);
+			}
+			wake.notify_all();
+
+			run_chunks(participants - 1);
+			while (current.remaining.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+		}
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace snake {
+	/*
+	 * @brief Lock-free triple buffer: one writer publishes whole values, one reader takes the latest.
+	 *
+	 * The writer fills `write_buffer()` and calls `publish()`, which swaps it with the shared middle
+	 * slot. The reader calls `update()`, which swaps its slot with the middle one if something new
+	 * was published, then reads `read_buffer()` for as long as it likes. Neither side ever waits;
+	 * values the reader was too slow to see are simply skipped. Slots are reused, so a `T` that
+	 * owns memory (a `std::vector`) stops allocating once all three have grown.
+	 */
+	template <typename T>
+	class triple_buffer {
+	private:
+		static constexpr std::uint8_t fresh = 4;
+
+		T slots[3];
+		alignas(64) std::atomic<std::uint8_t> middle{ 1 };
+		alignas(64) std::uint8_t back = 0;
+		alignas(64) std::uint8_t front = 2;
+
+	public:
+		/// Writer side: the slot to fill before `publish()`.
+		T& write_buffer() { return slots[back]; }
+
+		void publish() {
+			back = std::uint8_t(middle.exchange(std::uint8_t(back | fresh), std::memory_order_acq_rel) & 3);
+		}
+
+		/// Reader side. Returns true if a newer value than the current `read_buffer()` was taken.
+		bool update() {
+			if (!(middle.load(std::memory_order_relaxed) & fresh)) return false;
+			front = std::uint8_t(middle.exchange(front, std::memory_order_acq_rel) & 3);
+			return true;
+		}
+
+		const T& read_buffer() const { return slots[front]; }
+	};
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "SnakeGame.hpp"
+#include "SnakeNamespace/render/SoftwareRenderer.hpp"
+
+namespace snake {
+	struct turbo_options {
+		std::uint32_t seed = 1;
+		std::uint64_t max_ticks = 10'000'000;
+		std::uint64_t render_every = 0; ///< render the board every Nth tick; 0 never renders
+		double report_seconds = 1.0;    ///< progress line interval when a progress stream is given
+	};
+
+	struct turbo_report {
+		std::uint64_t ticks = 0;
+		std::uint64_t renders = 0;
+		double seconds = 0;
+		double render_seconds = 0;
+		double slowest_interval = 0;    ///< lowest ticks/s over one report interval
+		unsigned int score = 0;
+		size_t length = 0;
+		bool won = false;
+		bool over = false;              ///< false when stopped by `max_ticks`
+		std::uint64_t last_image_hash = 0;
+
+		double ticks_per_second() const { return seconds > 0 ? ticks / seconds : 0; }
+		/// Ticks/s with the time spent rendering taken out: the simulation and the policy alone.
+		double simulation_ticks_per_second() const { return seconds > render_seconds ? ticks / (seconds - render_seconds) : 0; }
+	};
+
+	/*************************************************************************************
+	 * RUN FUNCTION: `run_turbo(const turbo_options& options, Pick&& pick, std::ostream* progress)`
+	 *
+	 * Plays one seeded game as fast as the CPU allows: no window, no clock, no sleep,
+	 * just `pick(game)` and `SnakeGame::tick()` back to back. With `render_every` set,
+	 * every Nth tick is also rasterized with `software_backend`, to see what drawing
+	 * costs on top. Progress lines (ticks so far, ticks/s over the last interval) go to
+	 * `progress` if it is not null. `observe(game)` runs after every tick, e.g. to feed
+	 * a `diff_stream_writer`; it is timed as part of the simulation. When `tick()` ends
+	 * the game, `observe()` sees the final board once more, its tick count unchanged.
+	 *************************************************************************************/
+
+	template <typename Pick, typename Observe>
+	turbo_report run_turbo(const turbo_options& options, Pick&& pick, std::ostream* progress, Observe&& observe) {
+		using clock = std::chrono::steady_clock;
+		SnakeGame game(options.seed);
+		framebuffer image(options.render_every ? SnakeGame::boardWidth * SnakeGame::cellSize : 1,
+			options.render_every ? SnakeGame::boardHeight * SnakeGame::cellSize : 1);
+		software_backend backend(image);
+		turbo_report report;
+
+		const auto start = clock::now();
+		auto interval_start = start;
+		std::uint64_t interval_ticks = 0;
+		while (report.ticks < options.max_ticks) {
+			game.move(pick(game));
+			const bool alive = game.tick();
+			observe(std::as_const(game));
+			if (!alive) { report.over = true; break; }
+			++report.ticks;
+			++interval_ticks;
+
+			if (options.render_every && report.ticks % options.render_every == 0) {
+				auto render_start = clock::now();
+				backend.clear(sf::Color::Blue);
+				game.render(backend);
+				report.render_seconds += std::chrono::duration<double>(clock::now() - render_start).count();
+				++report.renders;
+			}
+
+			// checking the clock every tick would show up in the profile of the hot path
+			if ((report.ticks & 1023) == 0) {
+				auto now = clock::now();
+				double elapsed = std::chrono::duration<double>(now - interval_start).count();
+				if (elapsed >= options.report_seconds) {
+					double rate = interval_ticks / elapsed;
+					report.slowest_interval = report.slowest_interval == 0 ? rate : std::min(report.slowest_interval, rate);
+					if (progress)
+						*progress << "tick " << report.ticks << ", length " << game.getLength() << ", "
+							<< std::fixed << std::setprecision(0) << rate << " ticks/s" << std::endl;
+					interval_start = now;
+					interval_ticks = 0;
+				}
+			}
+		}
+		report.seconds = std::chrono::duration<double>(clock::now() - start).count();
+		report.score = game.getScore();
+		report.length = game.getLength();
+		report.won = game.isWon();
+		if (report.renders) report.last_image_hash = image.hash();
+		return report;
+	}
+
+	template <typename Pick>
+	turbo_report run_turbo(const turbo_options& options, Pick&& pick, std::ostream* progress = nullptr) {
+		return run_turbo(options, std::forward<Pick>(pick), progress, [](const SnakeGame&) {});
+	}
+
+	inline void print_turbo_report(std::ostream& out, const turbo_report& report) {
+		out << std::fixed << std::setprecision(0)
+			<< report.ticks << " ticks in " << std::setprecision(3) << report.seconds << " s: "
+			<< std::setprecision(0) << report.ticks_per_second() << " ticks/s";
+		if (report.slowest_interval > 0) out << " (slowest interval " << report.slowest_interval << " ticks/s)";
+		out << "\n";
+		if (report.renders)
+			out << report.renders << " renders took " << std::setprecision(3) << report.render_seconds << " s; simulation alone "
+				<< std::setprecision(0) << report.simulation_ticks_per_second() << " ticks/s, last image hash "
+				<< std::hex << report.last_image_hash << std::dec << "\n";
+		out << (report.won ? "won" : report.over ? "game over" : "stopped at tick limit")
+			<< ", score " << report.score << ", length " << report.length << std::endl;
+	}
+}